@@ -1,23 +1,19 @@
 #include "AgeCondition.h"
 #include "core/ValueParser.h"
+#include "conditions/BatchKernels.h"
 
 AgeCondition::AgeCondition(AgeComparison comparison, std::chrono::system_clock::duration threshold)
-    : comparisonType(comparison), ageThreshold(threshold) {
+    : comparisonType(comparison), ageThreshold(threshold), fileTimeThreshold(toFileTimeDuration(threshold)),
+      ageId(EvaluationContext::registerAge(fileTimeThreshold)) {
 }
 
-bool AgeCondition::evaluate(const ItemRepresentation& item) const {
-    auto now = std::chrono::system_clock::now();
-    auto itemTime = std::chrono::clock_cast<std::chrono::system_clock>(item.getLastModifiedDate());
-    auto itemAge = now - itemTime;
-    auto threshold = ageThreshold.getValue();
-    
-    switch (comparisonType) {
-        case AgeComparison::OlderThan:
-            return itemAge > threshold;
-        case AgeComparison::NewerThan:
-            return itemAge < threshold;
-        default:
-            return false;
+void AgeCondition::evaluateBatch(const ItemBatch& batch, const EvaluationContext& context,
+                                 const std::span<std::uint64_t> mask) const {
+    const std::int64_t cutoff = context.cutoffFor(ageId, fileTimeThreshold).time_since_epoch().count();
+    if (comparisonType == AgeComparison::OlderThan) {
+        keepLessThan(batch.getModifiedTimes(), cutoff, mask);
+    } else {
+        keepGreaterThan(batch.getModifiedTimes(), cutoff, mask);
     }
 }
 
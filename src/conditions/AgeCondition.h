@@ -10,19 +10,29 @@ enum class AgeComparison {
     NewerThan
 };
 
-class AgeCondition : public ICondition {
+class AgeCondition final : public ICondition {
 public:
     AgeCondition(AgeComparison comparison, std::chrono::system_clock::duration threshold);
     
     // ICondition interface implementation
-    bool evaluate(const ItemRepresentation& item) const override;
+    // defined here so that rules holding the condition by value can inline it
+    bool evaluate(const ItemRepresentation& item, const EvaluationContext& context) const override {
+        // an item older than the threshold was modified before the scan start minus the threshold
+        const auto cutoff = context.cutoffFor(ageId, fileTimeThreshold);
+        return comparisonType == AgeComparison::OlderThan ? item.getLastModifiedDate() < cutoff
+                                                          : item.getLastModifiedDate() > cutoff;
+    }
+    void evaluateBatch(const ItemBatch& batch, const EvaluationContext& context, std::span<std::uint64_t> mask) const override;
     std::string describe() const override;
+    ItemAttribute requiredAttributes() const override { return ItemAttribute::ModifiedTime; }
     
     // Template member function for setting age threshold with different duration types
     template<typename DurationType>
     void setAgeThreshold(const DurationType& duration) {
         auto systemDuration = std::chrono::duration_cast<std::chrono::system_clock::duration>(duration);
         ageThreshold.setValue(systemDuration);
+        fileTimeThreshold = toFileTimeDuration(systemDuration);
+        ageId = EvaluationContext::registerAge(fileTimeThreshold);
     }
     
     std::chrono::system_clock::duration getThreshold() const { return ageThreshold.getValue(); }
@@ -32,4 +42,11 @@ public:
 private:
     AgeComparison comparisonType;
     RuleParameter<std::chrono::system_clock::duration> ageThreshold; // Using template class
+    // the threshold in file clock ticks, registered so each run's context holds its cutoff
+    EvaluationContext::FileTime::duration fileTimeThreshold;
+    std::uint32_t ageId;
+    
+    static EvaluationContext::FileTime::duration toFileTimeDuration(std::chrono::system_clock::duration threshold) {
+        return std::chrono::duration_cast<EvaluationContext::FileTime::duration>(threshold);
+    }
 }; 
\ No newline at end of file
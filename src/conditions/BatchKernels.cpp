@@ -0,0 +1,134 @@
+#include "conditions/BatchKernels.h"
+#include <algorithm>
+#include <cstddef>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define FILE_ORGANIZER_HAS_AVX2_KERNELS 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// flipping the sign bit maps unsigned order onto signed order, the only one AVX2 compares
+constexpr std::uint64_t unsignedBias = std::uint64_t{1} << 63;
+
+// values[i] ^ bias compared with threshold (already biased) for the bits of mask
+template<bool Greater>
+void keepComparedScalar(const std::int64_t* values, const size_t count, const std::int64_t threshold,
+                        const std::uint64_t bias, std::uint64_t* mask) {
+    for (size_t word = 0; word * 64 < count; ++word) {
+        if (mask[word] == 0) {
+            continue;
+        }
+        const size_t begin = word * 64;
+        const size_t end = std::min(count, begin + 64);
+        std::uint64_t bits = 0;
+        for (size_t i = begin; i < end; ++i) {
+            const auto value = static_cast<std::int64_t>(static_cast<std::uint64_t>(values[i]) ^ bias);
+            bits |= std::uint64_t{Greater ? value > threshold : value < threshold} << (i - begin);
+        }
+        mask[word] &= bits;
+    }
+}
+
+#if defined(FILE_ORGANIZER_HAS_AVX2_KERNELS)
+template<bool Greater>
+__attribute__((target("avx2")))
+void keepComparedAvx2(const std::int64_t* values, const size_t count, const std::int64_t threshold,
+                      const std::uint64_t bias, std::uint64_t* mask) {
+    const __m256i biasLanes = _mm256_set1_epi64x(static_cast<long long>(bias));
+    const __m256i thresholdLanes = _mm256_set1_epi64x(threshold);
+    const size_t fullWords = count / 64;
+    for (size_t word = 0; word < fullWords; ++word) {
+        if (mask[word] == 0) {
+            continue;
+        }
+        const std::int64_t* block = values + word * 64;
+        std::uint64_t bits = 0;
+        for (size_t lane = 0; lane < 64; lane += 4) {
+            const __m256i loaded = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + lane));
+            const __m256i value = _mm256_xor_si256(loaded, biasLanes);
+            const __m256i hit = Greater ? _mm256_cmpgt_epi64(value, thresholdLanes)
+                                        : _mm256_cmpgt_epi64(thresholdLanes, value);
+            // one bit per 64-bit lane
+            bits |= static_cast<std::uint64_t>(_mm256_movemask_pd(_mm256_castsi256_pd(hit))) << lane;
+        }
+        mask[word] &= bits;
+    }
+    if (fullWords * 64 < count) {
+        keepComparedScalar<Greater>(values + fullWords * 64, count - fullWords * 64, threshold, bias, mask + fullWords);
+    }
+}
+#endif
+
+template<bool Greater>
+void keepCompared(const std::int64_t* values, const size_t count, const std::int64_t threshold,
+                  const std::uint64_t bias, const std::span<std::uint64_t> mask) {
+#if defined(FILE_ORGANIZER_HAS_AVX2_KERNELS)
+    if (batchKernelsUseAvx2()) {
+        keepComparedAvx2<Greater>(values, count, threshold, bias, mask.data());
+        return;
+    }
+#endif
+    keepComparedScalar<Greater>(values, count, threshold, bias, mask.data());
+}
+
+std::int64_t biased(const std::uint64_t value) {
+    return static_cast<std::int64_t>(value ^ unsignedBias);
+}
+
+} // namespace
+
+bool batchKernelsUseAvx2() {
+#if defined(FILE_ORGANIZER_HAS_AVX2_KERNELS)
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+#else
+    return false;
+#endif
+}
+
+void keepGreaterThan(const std::span<const std::uint64_t> values, const std::uint64_t threshold,
+                     const std::span<std::uint64_t> mask) {
+    // signed and unsigned variants of one type may alias
+    keepCompared<true>(reinterpret_cast<const std::int64_t*>(values.data()), values.size(),
+                       biased(threshold), unsignedBias, mask);
+}
+
+void keepLessThan(const std::span<const std::uint64_t> values, const std::uint64_t threshold,
+                  const std::span<std::uint64_t> mask) {
+    keepCompared<false>(reinterpret_cast<const std::int64_t*>(values.data()), values.size(),
+                        biased(threshold), unsignedBias, mask);
+}
+
+void keepGreaterThan(const std::span<const std::int64_t> values, const std::int64_t threshold,
+                     const std::span<std::uint64_t> mask) {
+    keepCompared<true>(values.data(), values.size(), threshold, 0, mask);
+}
+
+void keepLessThan(const std::span<const std::int64_t> values, const std::int64_t threshold,
+                  const std::span<std::uint64_t> mask) {
+    keepCompared<false>(values.data(), values.size(), threshold, 0, mask);
+}
+
+void keepEqualTo(const std::span<const std::uint32_t> values, const std::uint32_t value,
+                 const std::span<std::uint64_t> mask) {
+    for (size_t word = 0; word * 64 < values.size(); ++word) {
+        if (mask[word] == 0) {
+            continue;
+        }
+        const size_t begin = word * 64;
+        const size_t end = std::min(values.size(), begin + 64);
+        std::uint64_t bits = 0;
+        for (size_t i = begin; i < end; ++i) {
+            bits |= std::uint64_t{values[i] == value} << (i - begin);
+        }
+        mask[word] &= bits;
+    }
+}
+
+void keepMasked(const std::span<std::uint64_t> mask, const std::span<const std::uint64_t> other) {
+    for (size_t word = 0; word < mask.size(); ++word) {
+        mask[word] &= other[word];
+    }
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <span>
+#include <cstdint>
+
+// Column kernels for evaluating conditions over an ItemBatch. Each one clears the bits of
+// mask whose value fails the comparison and leaves the others as they are, so successive
+// calls AND their results; words that are already zero are skipped. mask must have a bit
+// for every value. The comparisons run four values at a time with AVX2 when the CPU has it.
+void keepGreaterThan(std::span<const std::uint64_t> values, std::uint64_t threshold, std::span<std::uint64_t> mask);
+void keepLessThan(std::span<const std::uint64_t> values, std::uint64_t threshold, std::span<std::uint64_t> mask);
+void keepGreaterThan(std::span<const std::int64_t> values, std::int64_t threshold, std::span<std::uint64_t> mask);
+void keepLessThan(std::span<const std::int64_t> values, std::int64_t threshold, std::span<std::uint64_t> mask);
+void keepEqualTo(std::span<const std::uint32_t> values, std::uint32_t value, std::span<std::uint64_t> mask);
+
+// Clear the bits of mask that are clear in other
+void keepMasked(std::span<std::uint64_t> mask, std::span<const std::uint64_t> other);
+
+// Whether the comparison kernels use AVX2 on this machine
+bool batchKernelsUseAvx2();
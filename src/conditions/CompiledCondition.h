@@ -0,0 +1,67 @@
+#pragma once
+
+#include "conditions/ICondition.h"
+#include "conditions/ExtensionCondition.h"
+#include "conditions/SizeCondition.h"
+#include "conditions/AgeCondition.h"
+#include "conditions/NameCondition.h"
+#include <variant>
+#include <memory>
+#include <concepts>
+#include <type_traits>
+#include <span>
+#include <cstdint>
+
+// A condition as a rule stores it: the built-in conditions by value, so that a rule's
+// conditions sit next to each other and evaluating one is a switch on the variant index
+// followed by an inlined call. Any other ICondition is kept behind its pointer and
+// evaluated through the vtable, which keeps ICondition open for custom conditions.
+using CompiledCondition = std::variant<ExtensionCondition, SizeCondition, AgeCondition, NameCondition,
+                                       std::unique_ptr<ICondition>>;
+
+namespace detail {
+template<typename Condition, typename Variant>
+struct IsVariantAlternative : std::false_type {};
+
+template<typename Condition, typename... Alternatives>
+struct IsVariantAlternative<Condition, std::variant<Alternatives...>>
+    : std::disjunction<std::is_same<Condition, Alternatives>...> {};
+}
+
+// Conditions CompiledCondition holds by value
+template<typename Condition>
+concept BuiltinCondition = std::derived_from<Condition, ICondition> &&
+                           detail::IsVariantAlternative<Condition, CompiledCondition>::value;
+
+inline bool evaluateCondition(const CompiledCondition& condition, const ItemRepresentation& item,
+                              const EvaluationContext& context) {
+    return std::visit([&]<typename Alternative>(const Alternative& alternative) {
+        if constexpr (BuiltinCondition<Alternative>) {
+            return alternative.evaluate(item, context);  // final class: a direct call
+        } else {
+            return alternative->evaluate(item, context);
+        }
+    }, condition);
+}
+
+inline void evaluateConditionBatch(const CompiledCondition& condition, const ItemBatch& batch,
+                                   const EvaluationContext& context, const std::span<std::uint64_t> mask) {
+    std::visit([&]<typename Alternative>(const Alternative& alternative) {
+        if constexpr (BuiltinCondition<Alternative>) {
+            alternative.evaluateBatch(batch, context, mask);
+        } else {
+            alternative->evaluateBatch(batch, context, mask);
+        }
+    }, condition);
+}
+
+// The condition as an ICondition, for calls made once per rule rather than once per item
+inline const ICondition& asCondition(const CompiledCondition& condition) {
+    return std::visit([]<typename Alternative>(const Alternative& alternative) -> const ICondition& {
+        if constexpr (BuiltinCondition<Alternative>) {
+            return alternative;
+        } else {
+            return *alternative;
+        }
+    }, condition);
+}
@@ -0,0 +1,39 @@
+#include "conditions/EvaluationContext.h"
+#include <algorithm>
+#include <mutex>
+
+namespace {
+
+// Every age threshold registered, by id; as many as the configuration has distinct ones
+struct AgeTable {
+    std::mutex mutex;
+    std::vector<EvaluationContext::FileTime::duration> ages;
+};
+
+AgeTable& ageTable() {
+    static AgeTable table;
+    return table;
+}
+
+} // namespace
+
+EvaluationContext::EvaluationContext(const std::chrono::system_clock::time_point scanStart)
+    : scanStart(scanStart),
+      scanStartFileTime(std::chrono::clock_cast<FileTime::clock>(scanStart)) {
+    AgeTable& table = ageTable();
+    std::lock_guard lock(table.mutex);
+    cutoffs.reserve(table.ages.size());
+    for (const FileTime::duration age : table.ages) {
+        cutoffs.push_back(scanStartFileTime - age);
+    }
+}
+
+std::uint32_t EvaluationContext::registerAge(const FileTime::duration age) {
+    AgeTable& table = ageTable();
+    std::lock_guard lock(table.mutex);
+    if (const auto it = std::ranges::find(table.ages, age); it != table.ages.end()) {
+        return static_cast<std::uint32_t>(it - table.ages.begin());
+    }
+    table.ages.push_back(age);
+    return static_cast<std::uint32_t>(table.ages.size() - 1);
+}
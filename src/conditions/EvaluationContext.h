@@ -0,0 +1,38 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+// State shared by every condition evaluated during one organizer run, taken once when the
+// run starts. Every item and rule measures age against the same instant however long the
+// run takes, and that instant is kept in the filesystem clock. The cutoff of every age
+// threshold registered so far is worked out here, once per run, so checking an item's age
+// is a single comparison with a stored time.
+class EvaluationContext {
+public:
+    using FileTime = std::filesystem::file_time_type;
+    
+    explicit EvaluationContext(std::chrono::system_clock::time_point scanStart = std::chrono::system_clock::now());
+    
+    std::chrono::system_clock::time_point getScanStart() const { return scanStart; }
+    FileTime getScanStartFileTime() const { return scanStartFileTime; }
+    
+    // Number an age threshold, the same for equal ones; conditions do this when they are
+    // built, so that contexts made afterwards hold its cutoff. Safe from any thread.
+    static std::uint32_t registerAge(FileTime::duration age);
+    
+    // Modification time of an item that is exactly age old at the start of the scan; age
+    // must be the one registered as ageId
+    FileTime cutoffFor(const std::uint32_t ageId, const FileTime::duration age) const {
+        // thresholds registered after this context was made are worked out on the spot
+        return ageId < cutoffs.size() ? cutoffs[ageId] : scanStartFileTime - age;
+    }
+    FileTime cutoffFor(const FileTime::duration age) const { return scanStartFileTime - age; }
+    
+private:
+    std::chrono::system_clock::time_point scanStart;
+    FileTime scanStartFileTime;
+    std::vector<FileTime> cutoffs;  // by registerAge() id
+};
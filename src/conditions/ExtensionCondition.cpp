@@ -1,9 +1,10 @@
 #include "conditions/ExtensionCondition.h"
+#include "conditions/BatchKernels.h"
 #include <algorithm>
 #include <utility>
 
 ExtensionCondition::ExtensionCondition(const std::string& extension)
-    : targetExtension(normalizeExtension(extension)) {
+    : targetExtension(normalizeExtension(extension)), extensionId(idOf(targetExtension.getValue())) {
 }
 
 std::string ExtensionCondition::normalizeExtension(const std::string& extension) {
@@ -20,27 +21,15 @@ std::string ExtensionCondition::normalizeExtension(const std::string& extension)
     return normalized;
 }
 
-bool ExtensionCondition::evaluate(const ItemRepresentation& item) const {
-    // only files can have extensions
-    if (item.getType() != ItemType::File) {
-        return false;
-    }
-    
-    std::string itemExtension = item.getExtension();
-    
-    // convert to lowercase for case-insensitive comparison
-    std::ranges::transform(itemExtension,
-                           itemExtension.begin(), tolower);
-    
-    // get the stored extension value
+void ExtensionCondition::evaluateBatch(const ItemBatch& batch, const EvaluationContext&,
+                                       const std::span<std::uint64_t> mask) const {
+    keepMasked(mask, batch.getFileMask());
+    keepEqualTo(batch.getExtensionIds(), extensionId, mask);
+}
+
+std::optional<std::string> ExtensionCondition::requiredExtension() const {
     const std::string& storedExtension = targetExtension.getValue();
-    
-    // handle empty extension case
-    if (storedExtension.empty() || storedExtension == ".") {
-        return itemExtension.empty();
-    }
-    
-    return itemExtension == storedExtension;
+    return storedExtension == "." ? std::string() : storedExtension;
 }
 
 std::string ExtensionCondition::describe() const {
@@ -2,21 +2,30 @@
 
 #include "ICondition.h"
 #include "core/RuleParameter.h"
+#include "models/ExtensionIds.h"
 #include <string>
 
-class ExtensionCondition : public ICondition {
+class ExtensionCondition final : public ICondition {
 public:
     explicit ExtensionCondition(const std::string& extension);
     
     // ICondition interface implementation
-    bool evaluate(const ItemRepresentation& item) const override;
+    // defined here so that rules holding the condition by value can inline it
+    bool evaluate(const ItemRepresentation& item, const EvaluationContext&) const override {
+        // only files can have extensions; both ids are interned case-insensitively
+        return item.getType() == ItemType::File && item.getExtensionId() == extensionId;
+    }
+    void evaluateBatch(const ItemBatch& batch, const EvaluationContext& context, std::span<std::uint64_t> mask) const override;
     std::string describe() const override;
+    ItemAttribute requiredAttributes() const override { return ItemAttribute::Type; }
+    std::optional<std::string> requiredExtension() const override;
     
     // Template member function for setting extension with different string types
     template<typename T>
     void setExtension(const T& extension) {
         if constexpr (std::is_convertible_v<T, std::string>) {
             targetExtension.setValue(normalizeExtension(static_cast<std::string>(extension)));
+            extensionId = idOf(targetExtension.getValue());
         }
     }
     
@@ -25,6 +34,12 @@ public:
     
 private:
     RuleParameter<std::string> targetExtension;
+    std::uint32_t extensionId;  // see ExtensionIds
+    
+    // "." stands for no extension
+    static std::uint32_t idOf(const std::string& extension) {
+        return ExtensionIds::intern(extension == "." ? std::string() : extension);
+    }
     
     // Helper method for extension normalization
     static std::string normalizeExtension(const std::string& extension);
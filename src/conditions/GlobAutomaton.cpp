@@ -0,0 +1,243 @@
+#include "conditions/GlobAutomaton.h"
+#include <algorithm>
+#include <bit>
+#include <map>
+#include <utility>
+
+namespace {
+
+// Let ASCII letters match in either case
+void foldCase(std::bitset<256>& set) {
+    for (unsigned char lower = 'a'; lower <= 'z'; ++lower) {
+        const unsigned char upper = lower - 'a' + 'A';
+        if (set[lower] || set[upper]) {
+            set.set(lower);
+            set.set(upper);
+        }
+    }
+}
+
+// Parse the bracket expression opening at glob[open] into set; returns the index of its
+// closing bracket, or npos when there is none and the [ is an ordinary character
+size_t parseBracket(const std::string_view glob, const size_t open, const bool ignoreCase, std::bitset<256>& set) {
+    size_t i = open + 1;
+    const bool negate = i < glob.size() && (glob[i] == '!' || glob[i] == '^');
+    if (negate) {
+        ++i;
+    }
+    // a ] right after the opening bracket is a member, not the end
+    const size_t first = i;
+    while (i < glob.size() && (glob[i] != ']' || i == first)) {
+        const auto low = static_cast<unsigned char>(glob[i]);
+        if (i + 2 < glob.size() && glob[i + 1] == '-' && glob[i + 2] != ']') {
+            const auto high = static_cast<unsigned char>(glob[i + 2]);
+            for (unsigned byte = low; byte <= high; ++byte) {
+                set.set(byte);
+            }
+            i += 3;
+        } else {
+            set.set(low);
+            ++i;
+        }
+    }
+    if (i >= glob.size()) {
+        return std::string_view::npos;
+    }
+    if (ignoreCase) {
+        foldCase(set);
+    }
+    if (negate) {
+        set.flip();
+    }
+    return i;
+}
+
+} // namespace
+
+size_t GlobAutomaton::addPattern(const std::string_view glob, const bool ignoreCase) {
+    const auto pattern = static_cast<std::uint32_t>(patternCount++);
+    startPositions.push_back(static_cast<std::uint32_t>(positions.size()));
+
+    for (size_t i = 0; i < glob.size(); ++i) {
+        Position position{pattern};
+        ByteSet set;
+        const char c = glob[i];
+        if (c == '*') {
+            // a run of stars is one star
+            if (positions.size() > startPositions.back() && positions.back().star) {
+                continue;
+            }
+            set.set();
+            position.star = true;
+        } else if (c == '?') {
+            set.set();
+        } else if (const size_t close = c == '[' ? parseBracket(glob, i, ignoreCase, set) : std::string_view::npos;
+                   close != std::string_view::npos) {
+            i = close;
+        } else {
+            if (c == '\\' && i + 1 < glob.size()) {
+                ++i;
+            }
+            set.reset();
+            set.set(static_cast<unsigned char>(glob[i]));
+            if (ignoreCase) {
+                foldCase(set);
+            }
+        }
+        position.byteSet = static_cast<std::uint32_t>(byteSets.size());
+        byteSets.push_back(set);
+        positions.push_back(position);
+    }
+
+    Position end{pattern};
+    end.end = true;
+    positions.push_back(end);
+    return pattern;
+}
+
+void GlobAutomaton::compile() {
+    patternWords = (patternCount + 63) / 64;
+    positionWords = (positions.size() + 63) / 64;
+    starPositions.assign(positionWords, 0);
+    endPositions.assign(positionWords, 0);
+    for (size_t position = 0; position < positions.size(); ++position) {
+        const std::uint64_t bit = std::uint64_t{1} << (position % 64);
+        if (positions[position].star) {
+            starPositions[position / 64] |= bit;
+        }
+        if (positions[position].end) {
+            endPositions[position / 64] |= bit;
+        }
+    }
+
+    // bytes every byte set either contains or lacks together behave the same: refine one
+    // partition of the bytes by each set in turn
+    std::fill(std::begin(byteClass), std::end(byteClass), std::uint8_t{0});
+    classCount = 1;
+    for (const ByteSet& set : byteSets) {
+        std::vector<int> refined(classCount * 2, -1);
+        size_t refinedCount = 0;
+        for (unsigned byte = 0; byte < 256; ++byte) {
+            int& id = refined[byteClass[byte] * 2 + (set[byte] ? 1 : 0)];
+            if (id < 0) {
+                id = static_cast<int>(refinedCount++);
+            }
+            byteClass[byte] = static_cast<std::uint8_t>(id);
+        }
+        classCount = refinedCount;
+    }
+    std::vector<unsigned char> representative(classCount);
+    for (int byte = 255; byte >= 0; --byte) {
+        representative[byteClass[byte]] = static_cast<unsigned char>(byte);
+    }
+    classPositions.assign(classCount * positionWords, 0);
+    for (size_t position = 0; position < positions.size(); ++position) {
+        if (positions[position].end) {
+            continue;
+        }
+        const ByteSet& set = byteSets[positions[position].byteSet];
+        for (size_t byteClassId = 0; byteClassId < classCount; ++byteClassId) {
+            if (set[representative[byteClassId]]) {
+                classPositions[byteClassId * positionWords + position / 64] |= std::uint64_t{1} << (position % 64);
+            }
+        }
+    }
+
+    stateSets.clear();
+    transitions.clear();
+    acceptWords.clear();
+    std::map<std::vector<std::uint64_t>, std::uint32_t> stateIds;
+    const auto addState = [&](const std::vector<std::uint64_t>& set) -> std::uint32_t {
+        if (const auto it = stateIds.find(set); it != stateIds.end()) {
+            return it->second;
+        }
+        // the dead and start states always exist
+        if (stateIds.size() >= std::max<size_t>(stateLimit, 2)) {
+            return unbuilt;
+        }
+        const auto id = static_cast<std::uint32_t>(stateIds.size());
+        stateSets.insert(stateSets.end(), set.begin(), set.end());
+        acceptWords.resize(acceptWords.size() + patternWords, 0);
+        collectAccepted(set.data(), acceptWords.data() + id * patternWords);
+        transitions.resize(transitions.size() + classCount, unbuilt);
+        stateIds.emplace(set, id);
+        return id;
+    };
+
+    std::vector<std::uint64_t> set(positionWords, 0);
+    addState(set);
+    for (const std::uint32_t position : startPositions) {
+        set[position / 64] |= std::uint64_t{1} << (position % 64);
+    }
+    addClosure(set.data());
+    startState = addState(set);
+
+    // states are numbered in the order they are found, so this is a breadth-first walk
+    for (size_t state = 0; state < stateIds.size(); ++state) {
+        for (size_t byteClassId = 0; byteClassId < classCount; ++byteClassId) {
+            step(stateSets.data() + state * positionWords, byteClassId, set.data());
+            transitions[state * classCount + byteClassId] = addState(set);
+        }
+    }
+}
+
+GlobMatches GlobAutomaton::match(const std::string_view name) const {
+    std::uint32_t state = startState;
+    for (size_t i = 0; i < name.size() && state != deadState; ++i) {
+        const std::uint32_t next = transitions[state * classCount + byteClass[static_cast<unsigned char>(name[i])]];
+        if (next == unbuilt) {
+            return matchPositions(state, name.substr(i));
+        }
+        state = next;
+    }
+    GlobMatches matches;
+    matches.words = acceptWords.data() + state * patternWords;
+    return matches;
+}
+
+void GlobAutomaton::step(const std::uint64_t* set, const size_t byteClassId, std::uint64_t* next) const {
+    const std::uint64_t* accepting = classPositions.data() + byteClassId * positionWords;
+    // a star stays where it is, any other position moves on to the next
+    std::uint64_t carry = 0;
+    for (size_t word = 0; word < positionWords; ++word) {
+        const std::uint64_t consumed = set[word] & accepting[word];
+        const std::uint64_t advanced = consumed & ~starPositions[word];
+        next[word] = (consumed & starPositions[word]) | (advanced << 1) | carry;
+        carry = advanced >> 63;
+    }
+    addClosure(next);
+}
+
+void GlobAutomaton::addClosure(std::uint64_t* set) const {
+    // runs of stars are merged, so the position after a star is never another star
+    std::uint64_t carry = 0;
+    for (size_t word = 0; word < positionWords; ++word) {
+        const std::uint64_t stars = set[word] & starPositions[word];
+        set[word] |= (stars << 1) | carry;
+        carry = stars >> 63;
+    }
+}
+
+void GlobAutomaton::collectAccepted(const std::uint64_t* set, std::uint64_t* words) const {
+    for (size_t word = 0; word < positionWords; ++word) {
+        for (std::uint64_t bits = set[word] & endPositions[word]; bits != 0; bits &= bits - 1) {
+            const std::uint32_t pattern = positions[word * 64 + static_cast<size_t>(std::countr_zero(bits))].pattern;
+            words[pattern / 64] |= std::uint64_t{1} << (pattern % 64);
+        }
+    }
+}
+
+GlobMatches GlobAutomaton::matchPositions(const std::uint32_t state, const std::string_view rest) const {
+    std::vector<std::uint64_t> set(stateSets.begin() + state * positionWords,
+                                   stateSets.begin() + (state + 1) * positionWords);
+    std::vector<std::uint64_t> next(positionWords);
+    for (size_t i = 0; i < rest.size() && std::ranges::any_of(set, [](const std::uint64_t word) { return word != 0; }); ++i) {
+        step(set.data(), byteClass[static_cast<unsigned char>(rest[i])], next.data());
+        set.swap(next);
+    }
+    GlobMatches matches;
+    matches.fallbackWords.assign(patternWords, 0);
+    collectAccepted(set.data(), matches.fallbackWords.data());
+    matches.words = matches.fallbackWords.data();
+    return matches;
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <bitset>
+#include <cstdint>
+#include <cstddef>
+
+// A glob as a condition or rule reports it, see ICondition::requiredNamePattern()
+struct GlobPattern {
+    std::string glob;
+    bool ignoreCase = false;
+};
+
+// The patterns one name matched, see GlobAutomaton::match()
+class GlobMatches {
+public:
+    GlobMatches() = default;
+    GlobMatches(const GlobMatches&) = delete;
+    GlobMatches& operator=(const GlobMatches&) = delete;
+    GlobMatches(GlobMatches&&) = default;
+    GlobMatches& operator=(GlobMatches&&) = default;
+
+    bool contains(const size_t pattern) const { return (words[pattern / 64] >> (pattern % 64)) & 1; }
+
+private:
+    friend class GlobAutomaton;
+    const std::uint64_t* words = nullptr;  // one bit per pattern
+    std::vector<std::uint64_t> fallbackWords;  // owns the bits when no precomputed state had them
+};
+
+// Glob patterns over file names, matched against the whole name: * matches any run of
+// characters, ? any single character, [abc] or [a-z] one character of a set and [!abc] or
+// [^abc] one character outside it; \ takes the next character literally. Any number of
+// patterns compile into one deterministic automaton whose states are the sets of positions
+// the patterns can be at, so a single pass over a name finds every pattern it matches and
+// the cost per character doesn't grow with the number of patterns. Bytes that no pattern
+// tells apart share a column of the transition table.
+//
+// Names combining many starred patterns could reach a number of states exponential in the
+// pattern count, so construction stops at a state limit. A name that leaves the states built
+// up to then is finished by following all pattern positions at once, a bit per position and
+// a word of positions per operation, which still takes a single pass. Compiled automata are
+// immutable and safe to share between threads.
+class GlobAutomaton {
+public:
+    explicit GlobAutomaton(size_t stateLimit = 4096) : stateLimit(stateLimit) {}
+
+    // Add a pattern and return its index; takes effect with the next compile()
+    size_t addPattern(std::string_view glob, bool ignoreCase = false);
+    void compile();
+
+    GlobMatches match(std::string_view name) const;
+    bool matches(std::string_view name, size_t pattern) const { return match(name).contains(pattern); }
+
+    size_t getPatternCount() const { return patternCount; }
+    size_t getStateCount() const { return transitions.size() / classCount; }
+
+private:
+    using ByteSet = std::bitset<256>;
+    
+    // One position in one pattern; the next position of the same pattern has the next index
+    struct Position {
+        std::uint32_t pattern = 0;
+        std::uint32_t byteSet = 0;  // index into byteSets; unused at the end of the pattern
+        bool star = false;  // repeats its byte set any number of times, including none
+        bool end = false;  // the whole pattern has been read
+    };
+    
+    static constexpr std::uint32_t deadState = 0;  // no pattern can match any more
+    static constexpr std::uint32_t unbuilt = UINT32_MAX;  // past the state limit
+    
+    size_t stateLimit;
+    size_t patternCount = 0;
+    std::vector<Position> positions;
+    std::vector<ByteSet> byteSets;
+    std::vector<std::uint32_t> startPositions;
+    
+    // compiled; sets of positions are bit vectors of positionWords words
+    std::uint8_t byteClass[256] = {};
+    size_t classCount = 1;
+    size_t patternWords = 0;
+    size_t positionWords = 0;
+    std::vector<std::uint64_t> starPositions;
+    std::vector<std::uint64_t> endPositions;
+    std::vector<std::uint64_t> classPositions;  // class * positionWords: positions accepting a byte of it
+    std::uint32_t startState = deadState;
+    std::vector<std::uint64_t> stateSets;  // state * positionWords
+    std::vector<std::uint32_t> transitions;  // state * classCount + class
+    std::vector<std::uint64_t> acceptWords;  // state * patternWords, one bit per pattern
+    
+    // Positions after reading a byte of byteClassId in set, with the positions a star lets
+    // the pattern skip to
+    void step(const std::uint64_t* set, size_t byteClassId, std::uint64_t* next) const;
+    void addClosure(std::uint64_t* set) const;
+    void collectAccepted(const std::uint64_t* set, std::uint64_t* words) const;
+    GlobMatches matchPositions(std::uint32_t state, std::string_view rest) const;
+};
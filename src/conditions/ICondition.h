@@ -1,15 +1,41 @@
 #pragma once
 
 #include "models/ItemRepresentation.h"
+#include "models/ItemBatch.h"
+#include "models/ItemAttribute.h"
+#include "conditions/EvaluationContext.h"
+#include "conditions/GlobAutomaton.h"
 #include <string>
+#include <optional>
+#include <span>
+#include <cstdint>
 
 class ICondition {
 public:
     virtual ~ICondition() = default;
     
-    // Evaluate if the condition is met for the given item
-    virtual bool evaluate(const ItemRepresentation& item) const = 0;
+    // Evaluate if the condition is met for the given item, during the run described by context
+    virtual bool evaluate(const ItemRepresentation& item, const EvaluationContext& context) const = 0;
+    
+    // Clear the bits of mask (see ItemBatch) of the items evaluate() rejects. By default
+    // each item with its bit set is evaluated on its own.
+    virtual void evaluateBatch(const ItemBatch& batch, const EvaluationContext& context,
+                               const std::span<std::uint64_t> mask) const {
+        keepMatching(mask, [&](const size_t index) { return evaluate(batch.getItem(index), context); });
+    }
     
     // Get a description of this condition for logging/debugging
     virtual std::string describe() const = 0;
+    
+    // Item attributes evaluate() reads; the organizer fetches nothing else. Custom
+    // conditions that don't override this get every attribute.
+    virtual ItemAttribute requiredAttributes() const { return ItemAttribute::All; }
+    
+    // The lower-case extension (".pdf", or "" for none) of every item evaluate() accepts, if
+    // it only accepts files with one extension. Lets rule sets be indexed by extension.
+    virtual std::optional<std::string> requiredExtension() const { return std::nullopt; }
+    
+    // The glob every name evaluate() accepts matches, if the condition tests nothing else
+    // about the name. Lets rule sets match all their name patterns in one pass.
+    virtual std::optional<GlobPattern> requiredNamePattern() const { return std::nullopt; }
 }; 
\ No newline at end of file
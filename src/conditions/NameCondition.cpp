@@ -0,0 +1,21 @@
+#include "conditions/NameCondition.h"
+
+NameCondition::NameCondition(const std::string& pattern, const bool ignoreCase)
+    : namePattern(pattern), ignoreCase(ignoreCase) {
+    automaton.addPattern(pattern, ignoreCase);
+    automaton.compile();
+}
+
+void NameCondition::evaluateBatch(const ItemBatch& batch, const EvaluationContext&,
+                                  const std::span<std::uint64_t> mask) const {
+    // names aren't a column of the batch; each is read off its item
+    keepMatching(mask, [&](const size_t index) { return automaton.matches(batch.getItem(index).getName(), 0); });
+}
+
+std::optional<GlobPattern> NameCondition::requiredNamePattern() const {
+    return GlobPattern{namePattern.getValue(), ignoreCase};
+}
+
+std::string NameCondition::describe() const {
+    return "Name matches '" + namePattern.getValue() + "'" + (ignoreCase ? " (ignoring case)" : "");
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "ICondition.h"
+#include "GlobAutomaton.h"
+#include "core/RuleParameter.h"
+#include <string>
+
+// Matches the whole item name (files and directories) against a glob, see GlobAutomaton.
+// Rule indexes compile the patterns of all rules into one automaton and don't call
+// evaluate() at all, see ISortingRule::matchesCheckedName().
+class NameCondition final : public ICondition {
+public:
+    explicit NameCondition(const std::string& pattern, bool ignoreCase = false);
+    
+    // ICondition interface implementation
+    // defined here so that rules holding the condition by value can inline it
+    bool evaluate(const ItemRepresentation& item, const EvaluationContext&) const override {
+        return automaton.matches(item.getName(), 0);
+    }
+    void evaluateBatch(const ItemBatch& batch, const EvaluationContext& context, std::span<std::uint64_t> mask) const override;
+    std::string describe() const override;
+    ItemAttribute requiredAttributes() const override { return ItemAttribute::None; }
+    std::optional<GlobPattern> requiredNamePattern() const override;
+    
+    const std::string& getPattern() const { return namePattern.getValue(); }
+    bool isIgnoringCase() const { return ignoreCase; }
+    
+private:
+    RuleParameter<std::string> namePattern;
+    bool ignoreCase;
+    GlobAutomaton automaton;  // just this pattern
+};
@@ -1,26 +1,17 @@
 #include "SizeCondition.h"
 #include "core/ValueParser.h"
+#include "conditions/BatchKernels.h"
 
 SizeCondition::SizeCondition(SizeComparison comparison, std::uintmax_t threshold)
     : comparisonType(comparison), sizeThreshold(threshold) {
 }
 
-bool SizeCondition::evaluate(const ItemRepresentation& item) const {
-    // only apply to files, not directories
-    if (item.getType() != ItemType::File) {
-        return false;
-    }
-    
-    std::uintmax_t itemSize = item.getSizeInBytes();
-    std::uintmax_t threshold = sizeThreshold.getValue();
-    
-    switch (comparisonType) {
-        case SizeComparison::GreaterThan:
-            return itemSize > threshold;
-        case SizeComparison::LessThan:
-            return itemSize < threshold;
-        default:
-            return false;
+void SizeCondition::evaluateBatch(const ItemBatch& batch, const EvaluationContext&, const std::span<std::uint64_t> mask) const {
+    keepMasked(mask, batch.getFileMask());
+    if (comparisonType == SizeComparison::GreaterThan) {
+        keepGreaterThan(batch.getSizes(), sizeThreshold.getValue(), mask);
+    } else {
+        keepLessThan(batch.getSizes(), sizeThreshold.getValue(), mask);
     }
 }
 
@@ -9,13 +9,25 @@ enum class SizeComparison {
     LessThan
 };
 
-class SizeCondition : public ICondition {
+class SizeCondition final : public ICondition {
 public:
     SizeCondition(SizeComparison comparison, std::uintmax_t threshold);
     
     // ICondition interface implementation
-    bool evaluate(const ItemRepresentation& item) const override;
+    // defined here so that rules holding the condition by value can inline it
+    bool evaluate(const ItemRepresentation& item, const EvaluationContext&) const override {
+        // only apply to files, not directories
+        if (item.getType() != ItemType::File) {
+            return false;
+        }
+        
+        const std::uintmax_t itemSize = item.getSizeInBytes();
+        const std::uintmax_t threshold = sizeThreshold.getValue();
+        return comparisonType == SizeComparison::GreaterThan ? itemSize > threshold : itemSize < threshold;
+    }
+    void evaluateBatch(const ItemBatch& batch, const EvaluationContext& context, std::span<std::uint64_t> mask) const override;
     std::string describe() const override;
+    ItemAttribute requiredAttributes() const override { return ItemAttribute::Type | ItemAttribute::Size; }
     
     // Template member function for setting threshold with different units
     template<typename T>
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <optional>
+#include <cstddef>
+
+// Fixed-capacity blocking queue connecting pipeline stages. Producers block while the
+// queue is full (backpressure), consumers block while it is empty. close() wakes
+// everyone: pushes fail from then on and pops drain what is left before returning nullopt.
+template<typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity) : capacity(capacity > 0 ? capacity : 1) {}
+
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    // Returns false if the queue was closed before the item could be added
+    bool push(T item) {
+        std::unique_lock lock(mutex);
+        notFull.wait(lock, [this] { return closed || items.size() < capacity; });
+        if (closed) {
+            return false;
+        }
+        items.push_back(std::move(item));
+        if (items.size() > peakSize) {
+            peakSize = items.size();
+        }
+        lock.unlock();
+        notEmpty.notify_one();
+        return true;
+    }
+
+    // Blocks until an item is available; nullopt once the queue is closed and drained
+    std::optional<T> pop() {
+        std::unique_lock lock(mutex);
+        notEmpty.wait(lock, [this] { return closed || !items.empty(); });
+        if (items.empty()) {
+            return std::nullopt;
+        }
+        T item = std::move(items.front());
+        items.pop_front();
+        lock.unlock();
+        notFull.notify_one();
+        return item;
+    }
+
+    // Takes an item only if one is ready, e.g. to top up a batch without waiting
+    std::optional<T> tryPop() {
+        std::unique_lock lock(mutex);
+        if (items.empty()) {
+            return std::nullopt;
+        }
+        T item = std::move(items.front());
+        items.pop_front();
+        lock.unlock();
+        notFull.notify_one();
+        return item;
+    }
+
+    void close() {
+        {
+            std::lock_guard lock(mutex);
+            closed = true;
+        }
+        notEmpty.notify_all();
+        notFull.notify_all();
+    }
+
+    size_t size() const {
+        std::lock_guard lock(mutex);
+        return items.size();
+    }
+
+    size_t getCapacity() const { return capacity; }
+
+    // Highest number of items held at once, useful to size the queue depth
+    size_t getPeakSize() const {
+        std::lock_guard lock(mutex);
+        return peakSize;
+    }
+
+private:
+    const size_t capacity;
+    mutable std::mutex mutex;
+    std::condition_variable notEmpty;
+    std::condition_variable notFull;
+    std::deque<T> items;
+    size_t peakSize = 0;
+    bool closed = false;
+};
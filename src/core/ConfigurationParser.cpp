@@ -72,6 +72,86 @@ void ConfigurationParser::parseGlobalSetting(const std::string& key, const std::
         globalConfig.logLevel = stringToLogLevel(value);
     } else if (key == "LOG_FILE") {
         globalConfig.logFile = value;
+    } else if (key == "LOG_ASYNC") {
+        std::string lowerValue = value;
+        std::ranges::transform(lowerValue, lowerValue.begin(), tolower);
+        globalConfig.logAsync = (lowerValue == "true" || lowerValue == "yes" || lowerValue == "1");
+    } else if (key == "LOG_QUEUE_SIZE") {
+        try {
+            globalConfig.logQueueSize = std::stoul(value);
+        } catch (const std::exception&) {
+            errors.push_back("Invalid LOG_QUEUE_SIZE value: " + value);
+        }
+    } else if (key == "LOG_FLUSH_MS") {
+        try {
+            globalConfig.logFlushMs = std::stoul(value);
+        } catch (const std::exception&) {
+            errors.push_back("Invalid LOG_FLUSH_MS value: " + value);
+        }
+    } else if (key == "LOG_OVERFLOW") {
+        std::string upperValue = value;
+        std::ranges::transform(upperValue, upperValue.begin(), toupper);
+        if (upperValue == "BLOCK") {
+            globalConfig.logOverflow = LogOverflow::Block;
+        } else if (upperValue == "DROP") {
+            globalConfig.logOverflow = LogOverflow::Drop;
+        } else {
+            errors.push_back("Invalid LOG_OVERFLOW value: " + value + " (expected BLOCK or DROP)");
+        }
+    } else if (key == "SCAN_THREADS") {
+        try {
+            globalConfig.scanThreads = std::stoul(value);
+        } catch (const std::exception&) {
+            errors.push_back("Invalid SCAN_THREADS value: " + value);
+        }
+    } else if (key == "WATCH") {
+        std::string lowerValue = value;
+        std::ranges::transform(lowerValue, lowerValue.begin(), tolower);
+        globalConfig.watch = (lowerValue == "true" || lowerValue == "yes" || lowerValue == "1");
+    } else if (key == "WATCH_DEBOUNCE_MS") {
+        try {
+            globalConfig.watchDebounceMs = std::stoul(value);
+        } catch (const std::exception&) {
+            errors.push_back("Invalid WATCH_DEBOUNCE_MS value: " + value);
+        }
+    } else if (key == "WATCH_RESCAN_SECONDS") {
+        try {
+            globalConfig.watchRescanSeconds = std::stoul(value);
+        } catch (const std::exception&) {
+            errors.push_back("Invalid WATCH_RESCAN_SECONDS value: " + value);
+        }
+    } else if (key == "JOURNAL_DIR") {
+        globalConfig.journalDirectory = std::filesystem::path(value);
+    } else if (key == "SCAN_INDEX") {
+        globalConfig.scanIndexFile = std::filesystem::path(value);
+    } else if (key == "MOVE_THREADS") {
+        try {
+            globalConfig.moveThreads = std::stoul(value);
+        } catch (const std::exception&) {
+            errors.push_back("Invalid MOVE_THREADS value: " + value);
+        }
+    } else if (key == "COPY_THREADS") {
+        try {
+            globalConfig.copyThreads = std::stoul(value);
+        } catch (const std::exception&) {
+            errors.push_back("Invalid COPY_THREADS value: " + value);
+        }
+    } else if (key == "CROSS_DEVICE_FSYNC") {
+        std::string lowerValue = value;
+        std::ranges::transform(lowerValue, lowerValue.begin(), tolower);
+        globalConfig.crossDeviceFsync = (lowerValue == "true" || lowerValue == "yes" || lowerValue == "1");
+    } else if (key == "PIPELINE_QUEUE_DEPTH") {
+        try {
+            globalConfig.pipelineQueueDepth = std::stoul(value);
+        } catch (const std::exception&) {
+            errors.push_back("Invalid PIPELINE_QUEUE_DEPTH value: " + value);
+        }
+    } else if (key == "IO_URING_DEPTH") {
+        try {
+            globalConfig.ioUringDepth = std::stoul(value);
+        } catch (const std::exception&) {
+            errors.push_back("Invalid IO_URING_DEPTH value: " + value);
+        }
     }
 }
 
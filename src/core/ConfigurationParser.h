@@ -19,6 +19,21 @@ struct GlobalConfig {
     bool dryRun = false;
     LogLevel logLevel = LogLevel::INFO;
     std::string logFile;
+    bool logAsync = false;  // write log messages on a background thread
+    size_t logQueueSize = 8192;
+    size_t logFlushMs = 200;
+    LogOverflow logOverflow = LogOverflow::Block;
+    size_t scanThreads = 0;  // 0 = use all hardware threads
+    size_t moveThreads = 0;  // 0 = use all hardware threads
+    size_t copyThreads = 0;  // 0 = use all hardware threads
+    bool crossDeviceFsync = false;
+    std::filesystem::path journalDirectory;  // empty = moves are not journaled
+    size_t pipelineQueueDepth = 1024;
+    size_t ioUringDepth = 0;  // 0 = synchronous system calls
+    std::filesystem::path scanIndexFile;  // empty = no incremental scan index
+    bool watch = false;  // keep running and organize changes as they happen
+    size_t watchDebounceMs = 250;
+    size_t watchRescanSeconds = 60;
 };
 
 class ConfigurationParser {
@@ -1,25 +1,54 @@
 #include "DirectoryOrganizer.h"
 #include "Logger.h"
+#include "ParallelDirectoryWalker.h"
+#include "BoundedQueue.h"
+#include "MoveExecutor.h"
+#include "FileOperations.h"
 #include <format>
 #include <system_error>
 #include <sstream>
-#include <iomanip>
 #include <algorithm>
+#include <thread>
+#include <chrono>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <linux/fs.h>
+#include <cerrno>
+#endif
 
 DirectoryOrganizer::DirectoryOrganizer(
     std::filesystem::path sourceDirectory,
     std::filesystem::path targetBaseDirectory,
     std::vector<std::unique_ptr<ISortingRule>> rules,
-    const bool dryRunEnabled
+    const bool dryRunEnabled,
+    const OrganizerOptions organizerOptions
 ) : sourceDir(std::move(sourceDirectory)),
     targetBaseDir(std::move(targetBaseDirectory)),
     sortingRules(std::move(rules)),
-    dryRun(dryRunEnabled) {
+    dryRun(dryRunEnabled),
+    options(organizerOptions),
+    moveExecutor(std::make_unique<MoveExecutor>(organizerOptions.moveThreads, organizerOptions.queueDepth)) {
     
     // sort rules by priority (lower number = higher priority)
     std::ranges::sort(sortingRules, [](const auto& a, const auto& b) {
         return a->getPriority() < b->getPriority();
     });
+    ruleIndex = std::make_unique<RuleIndex>(sortingRules);
+    
+    // fetch only what the rules read, plus the type needed to tell files from directories
+    for (const auto& rule : sortingRules) {
+        attributeDemand |= rule->requiredAttributes();
+    }
+    
+    if (options.ioUringDepth > 0) {
+        moveRing = std::make_unique<IoUring>(static_cast<unsigned>(options.ioUringDepth));
+        if (!moveRing->isAvailable()) {
+            Logger::instance().warning("io_uring is not available here, using blocking system calls");
+            moveRing.reset();
+        }
+    }
     
     resetStatistics();
     
@@ -27,12 +56,21 @@ DirectoryOrganizer::DirectoryOrganizer(
     Logger::instance().info("Source directory: " + sourceDir.string());
     Logger::instance().info("Target base directory: " + targetBaseDir.string());
     Logger::instance().info("Number of rules: " + std::to_string(sortingRules.size()));
+    Logger::instance().debug("Rules indexed by {} extensions", ruleIndex->getIndexedExtensionCount());
     Logger::instance().info("Dry run mode: " + std::string(dryRun ? "enabled" : "disabled"));
+    Logger::instance().info("Scan threads: " + (options.scanThreads > 0 ? std::to_string(options.scanThreads) : std::string("auto")));
+    Logger::instance().info("Move threads: " + std::to_string(moveExecutor->getWorkerCount()));
+    if (moveRing) {
+        Logger::instance().info(std::format("io_uring batches of up to {} operations", moveRing->getQueueDepth()));
+    }
+    if (!options.scanIndexFile.empty()) {
+        Logger::instance().info("Scan index: " + options.scanIndexFile.string());
+    }
 }
 
 void DirectoryOrganizer::scanAndOrganize() {
     Logger::instance().info("Starting file organization process");
-    resetStatistics();
+    startRun();
     
     // verify source directory exists
     if (!std::filesystem::exists(sourceDir) || !std::filesystem::is_directory(sourceDir)) {
@@ -41,38 +79,27 @@ void DirectoryOrganizer::scanAndOrganize() {
         return;
     }
     
-    // create target base directory if it doesn't exist
-    if (!dryRun && !ensureDirectoryExists(targetBaseDir)) {
+    // create target base directory and every rule's target directory up front
+    if (!dryRun && !prepareTargetDirectories()) {
         Logger::instance().error("Failed to create target base directory: " + targetBaseDir.string());
         stats.errors++;
         return;
     }
+    if (!dryRun && !openJournal()) {
+        stats.errors++;
+        return;
+    }
     
+    runErrors = 0;
     try {
-        // first collect all items to avoid iterator invalidation during moves
-        std::vector<std::filesystem::path> itemsToProcess;
-        
-        for (const auto& entry : std::filesystem::recursive_directory_iterator(sourceDir)) {
-            itemsToProcess.push_back(entry.path());
-        }
-        
-        // now process all collected items
-        for (const auto& itemPath : itemsToProcess) {
-            try {
-                // skip if item no longer exists (might have been moved as part of a directory)
-                if (!std::filesystem::exists(itemPath)) {
-                    continue;
-                }
-                processItem(itemPath);
-            } catch (const std::exception& e) {
-                Logger::instance().error("Error processing item " + itemPath.string() + ": " + e.what());
-                stats.errors++;
-            }
-        }
+        runPipeline(sourceDir);
     } catch (const std::exception& e) {
         Logger::instance().error(std::format("Error scanning source directory: {}", e.what()));
-        stats.errors++;
+        ++runErrors;
     }
+    finishMoves();
+    flushJournal();
+    stats.errors += runErrors;
     
     // log final statistics
     Logger::instance().info("Organization process completed");
@@ -93,176 +120,1003 @@ void DirectoryOrganizer::scanAndOrganize() {
     Logger::instance().info("Errors: " + std::to_string(stats.errors));
 }
 
+void DirectoryOrganizer::organizeItems(const std::vector<std::filesystem::path>& paths) {
+    startRun();
+    
+    if (!dryRun && !ensureTargetDirectory(targetBaseDir)) {
+        Logger::instance().error("Failed to create target base directory: " + targetBaseDir.string());
+        stats.errors++;
+        return;
+    }
+    if (!dryRun && !openJournal()) {
+        stats.errors++;
+        return;
+    }
+    
+    runErrors = 0;
+    const auto targetInSource = findTargetInsideSource();
+    for (const auto& path : paths) {
+        if (targetInSource && isWithin(path, *targetInSource)) {
+            continue;
+        }
+        try {
+            // the item may have been renamed or deleted since it was reported
+            auto scanned = buildItem(ScanEntry::fromPath(path));
+            if (!scanned) {
+                continue;
+            }
+            const ISortingRule* rule = findMatchingRule(scanned->item);
+            // an unclaimed new directory brings its whole contents with it
+            const bool scanContents = scanned->item.getType() == ItemType::Directory && !rule;
+            processMatchedItem(MatchedItem{std::move(*scanned), rule});
+            if (scanContents) {
+                runPipeline(path);
+            }
+        } catch (const std::exception& e) {
+            Logger::instance().error("Error organizing {}: {}", path.string(), e.what());
+            ++runErrors;
+        }
+    }
+    finishMoves();
+    flushJournal();
+    stats.errors += runErrors;
+    
+    Logger::instance().info(std::format("Organized {} changed items: {} files and {} directories {}, {} errors",
+                                        paths.size(), stats.filesMovedOrWouldMove, stats.directoriesMovedOrWouldMove,
+                                        dryRun ? "would be moved" : "moved", stats.errors));
+}
+
+void DirectoryOrganizer::rescanDirectory(const std::filesystem::path& directory) {
+    startRun();
+    
+    if (!dryRun && !ensureTargetDirectory(targetBaseDir)) {
+        Logger::instance().error("Failed to create target base directory: " + targetBaseDir.string());
+        stats.errors++;
+        return;
+    }
+    if (!dryRun && !openJournal()) {
+        stats.errors++;
+        return;
+    }
+    
+    runErrors = 0;
+    try {
+        runPipeline(directory);
+    } catch (const std::exception& e) {
+        Logger::instance().error(std::format("Error scanning directory {}: {}", directory.string(), e.what()));
+        ++runErrors;
+    }
+    finishMoves();
+    flushJournal();
+    stats.errors += runErrors;
+}
+
+void DirectoryOrganizer::writePlan(const std::filesystem::path& planFile) {
+    Logger::instance().info("Planning moves into " + planFile.string());
+    startRun();
+    
+    if (!std::filesystem::exists(sourceDir) || !std::filesystem::is_directory(sourceDir)) {
+        Logger::instance().error("Source directory does not exist or is not a directory: " + sourceDir.string());
+        stats.errors++;
+        return;
+    }
+    
+    MovePlan::Writer writer(planFile, ruleSetFingerprint(), sourceDir, targetBaseDir);
+    if (!writer.open()) {
+        stats.errors++;
+        return;
+    }
+    
+    // the pipeline runs as usual, but its moves end up in the plan instead of the executor
+    planWriter = &writer;
+    runErrors = 0;
+    try {
+        runPipeline(sourceDir);
+    } catch (const std::exception& e) {
+        Logger::instance().error(std::format("Error scanning source directory: {}", e.what()));
+        ++runErrors;
+    }
+    planWriter = nullptr;
+    if (!writer.finish()) {
+        ++runErrors;
+    }
+    stats.errors += runErrors;
+    
+    Logger::instance().info(std::format("Planned {} moves ({} files, {} directories) in {}, {} errors",
+                                        writer.getEntryCount(), stats.filesMovedOrWouldMove,
+                                        stats.directoriesMovedOrWouldMove, planFile.string(), stats.errors));
+}
+
+void DirectoryOrganizer::executePlan(const std::filesystem::path& planFile) {
+    Logger::instance().info("Executing move plan " + planFile.string());
+    startRun();
+    
+    MovePlan plan(planFile);
+    if (!plan.open()) {
+        stats.errors++;
+        return;
+    }
+    if (plan.getFingerprint() != ruleSetFingerprint()) {
+        Logger::instance().error(std::format("Move plan {} was made for other directories or rules (planned {} -> {})",
+                                             planFile.string(), plan.getSourceRoot().string(),
+                                             plan.getTargetRoot().string()));
+        stats.errors++;
+        return;
+    }
+    if (plan.getRuleCount() > sortingRules.size()) {
+        Logger::instance().error(std::format("Corrupt move plan {}: refers to rule {} of {}", planFile.string(),
+                                             plan.getRuleCount() - 1, sortingRules.size()));
+        stats.errors++;
+        return;
+    }
+    
+    if (!dryRun && !prepareTargetDirectories()) {
+        Logger::instance().error("Failed to create target base directory: " + targetBaseDir.string());
+        stats.errors++;
+        return;
+    }
+    if (!dryRun && !openJournal()) {
+        stats.errors++;
+        return;
+    }
+    
+    runErrors = 0;
+    plan.forEachEntry([&](const MovePlan::Entry& entry) {
+        const bool isFile = entry.type == ItemType::File;
+        const std::filesystem::path source = sourceDir / entry.source;
+        // the only check left: the item is still the one that was matched
+        const auto metadata = readFileMetadata(source);
+        const bool unchanged = metadata && entry.matches(*metadata);
+        {
+            std::lock_guard lock(statsMutex);
+            isFile ? stats.filesProcessed++ : stats.directoriesProcessed++;
+            if (!unchanged) {
+                isFile ? stats.filesSkipped++ : stats.directoriesSkipped++;
+                stats.itemsChangedSincePlan++;
+            }
+        }
+        if (!unchanged) {
+            Logger::instance().warning("Not moving {}: changed or gone since it was planned", source.string());
+            return;
+        }
+        submitMove(ScannedItem{ItemRepresentation(source, *metadata), nullptr}, targetBaseDir / entry.target, *sortingRules[entry.ruleId]);
+    });
+    finishMoves();
+    flushJournal();
+    stats.errors += runErrors;
+    
+    Logger::instance().info(std::format("Executed {} planned moves: {} files and {} directories {}, {} changed since planning, {} errors",
+                                        plan.size(), stats.filesMovedOrWouldMove, stats.directoriesMovedOrWouldMove,
+                                        dryRun ? "would be moved" : "moved", stats.itemsChangedSincePlan, stats.errors));
+}
+
 void DirectoryOrganizer::resetStatistics() {
+    std::lock_guard lock(statsMutex);
     stats = Statistics{};
+    moveExecutor->resetStatistics();
+}
+
+void DirectoryOrganizer::startRun() {
+    resetStatistics();
+    evaluationContext = EvaluationContext();
+}
+
+void DirectoryOrganizer::runPipeline(const std::filesystem::path& root) {
+    // scan -> ItemRepresentation -> rule match -> move, connected by bounded queues so that
+    // memory stays proportional to the queue depth and moves start as soon as the first
+    // entries are listed.
+    BoundedQueue<ScanEntry> scannedEntries(options.queueDepth);
+    BoundedQueue<ScannedItem> items(options.queueDepth);
+    BoundedQueue<MatchedItem> matchedItems(options.queueDepth);
+    
+    // the target tree is skipped by path, computed once instead of per item
+    const auto targetInSource = findTargetInsideSource();
+    if (targetInSource && isWithin(root, *targetInSource)) {
+        Logger::instance().warning(root == sourceDir
+            ? std::string("Target directory is the source directory, nothing to organize")
+            : "Not scanning a directory inside the target tree: " + root.string());
+        return;
+    }
+    
+    ParallelDirectoryWalker walker(options.scanThreads);
+    
+    // unchanged directories are not listed again; their recorded subdirectories are queued instead.
+    // The index describes the whole tree, so partial rescans neither use nor overwrite it.
+    const std::unique_ptr<ScanIndex> scanIndex = root == sourceDir ? openScanIndex() : nullptr;
+    if (scanIndex) {
+        walker.setListingHooks(
+            [&](const std::filesystem::path& directory) -> std::optional<std::vector<std::string>> {
+                const auto metadata = readFileMetadata(directory);
+                if (!metadata) {
+                    return std::nullopt;  // let the listing report it
+                }
+                return scanIndex->beginDirectory(scanIndexKey(directory), *metadata);
+            },
+            [&](const std::filesystem::path& directory, std::vector<std::string> subdirectories) {
+                scanIndex->completeDirectory(scanIndexKey(directory), std::move(subdirectories));
+            });
+    }
+    
+    std::jthread scanStage([&] {
+        walker.walk(root, [&](const ScanEntry& entry) {
+            // the name is compared first so that only a likely match composes a path
+            if (targetInSource && entry.name == targetInSource->filename() && entry.path() == *targetInSource) {
+                Logger::instance().debug("Skipping target directory tree: {}", targetInSource->string());
+                return WalkAction::SkipSubtree;
+            }
+            if (entry.type == ItemType::File || entry.type == ItemType::Other) {
+                scannedEntries.push(entry);
+                return WalkAction::Continue;
+            }
+            
+            // directories are matched right here so that a directory claimed by a rule is
+            // never descended into; symlinks and DT_UNKNOWN entries are classified first
+            auto scanned = buildItem(entry);
+            if (!scanned) {
+                return WalkAction::SkipSubtree;
+            }
+            if (scanned->item.getType() != ItemType::Directory) {
+                items.push(std::move(*scanned));
+                return WalkAction::Continue;
+            }
+            const ISortingRule* rule = findMatchingRule(scanned->item);
+            matchedItems.push(MatchedItem{std::move(*scanned), rule});
+            return rule ? WalkAction::SkipSubtree : WalkAction::Continue;
+        });
+        scannedEntries.close();
+    });
+    
+    // with io_uring the item stage stats whatever entries are queued together, one submission per batch
+    const bool batchMetadata = moveRing != nullptr;
+    std::jthread itemStage([&] {
+        std::unique_ptr<IoUring> ring;
+        if (batchMetadata) {
+            ring = std::make_unique<IoUring>(static_cast<unsigned>(options.ioUringDepth));
+        }
+        if (ring && ring->isAvailable()) {
+            std::vector<ScanEntry> batch;
+            while (auto entry = scannedEntries.pop()) {
+                batch.clear();
+                batch.push_back(std::move(*entry));
+                while (batch.size() < ring->getQueueDepth()) {
+                    auto next = scannedEntries.tryPop();
+                    if (!next) {
+                        break;
+                    }
+                    batch.push_back(std::move(*next));
+                }
+                for (auto& scanned : buildItems(batch, *ring)) {
+                    items.push(std::move(scanned));
+                }
+            }
+        } else {
+            while (auto entry = scannedEntries.pop()) {
+                if (auto scanned = buildItem(*entry)) {
+                    items.push(std::move(*scanned));
+                }
+            }
+        }
+        items.close();
+    });
+    
+    // items are matched a batch at a time, so that every condition runs once over a column
+    // of the batch instead of once per item
+    std::jthread matchStage([&] {
+        std::vector<ScannedItem> pending;
+        // the batch points into pending, which therefore never reallocates
+        pending.reserve(matchBatchSize);
+        ItemBatch batch(attributeDemand);
+        std::vector<ISortingRule*> rules;
+        while (auto scanned = items.pop()) {
+            pending.clear();
+            pending.push_back(std::move(*scanned));
+            while (pending.size() < matchBatchSize) {
+                auto next = items.tryPop();
+                if (!next) {
+                    break;
+                }
+                pending.push_back(std::move(*next));
+            }
+            
+            bool matchedBatch = false;
+            try {
+                batch.clear();
+                for (const ScannedItem& item : pending) {
+                    batch.add(item.item);
+                }
+                rules.resize(pending.size());
+                ruleIndex->findMatchingRules(batch, evaluationContext, rules);
+                matchedBatch = true;
+            } catch (const std::exception& e) {
+                Logger::instance().debug("Matching a batch failed, matching its items one by one: {}", e.what());
+            }
+            for (size_t i = 0; i < pending.size(); ++i) {
+                try {
+                    const ISortingRule* rule = matchedBatch ? rules[i] : findMatchingRule(pending[i].item);
+                    matchedItems.push(MatchedItem{std::move(pending[i]), rule});
+                } catch (const std::exception& e) {
+                    Logger::instance().error("Error matching rules for {}: {}", pending[i].item.getItemPath().string(), e.what());
+                    ++runErrors;
+                }
+            }
+        }
+        matchedItems.close();
+    });
+    
+    // the move stage runs on the calling thread and hands the renames to the move executor
+    while (auto matched = matchedItems.pop()) {
+        // a directory only stays in the index while none of its entries match a rule
+        if (scanIndex && matched->rule) {
+            scanIndex->invalidate(scanIndexKey(matched->source.item.getItemPath().parent_path()));
+        }
+        processMatchedItem(std::move(*matched));
+    }
+    finishMoves();
+    
+    scanStage.join();
+    itemStage.join();
+    matchStage.join();
+    
+    const auto& walkStats = walker.getStatistics();
+    // accumulated: a batch of changed items can run several pipelines
+    stats.entriesScanned += walkStats.entriesVisited;
+    stats.scanSeconds += walkStats.elapsedSeconds;
+    stats.scanEntriesPerSecond = stats.scanSeconds > 0.0
+        ? static_cast<double>(stats.entriesScanned) / stats.scanSeconds
+        : 0.0;
+    stats.directoriesReused += walkStats.directoriesReused;
+    runErrors += walkStats.errors;
+    Logger::instance().info(std::format("Scanned {} entries in {:.3f}s with {} threads ({:.0f} entries/sec), {} subtrees pruned",
+                                        walkStats.entriesVisited, walkStats.elapsedSeconds, walker.getWorkerCount(),
+                                        walkStats.elapsedSeconds > 0.0 ? walkStats.entriesVisited / walkStats.elapsedSeconds : 0.0,
+                                        walkStats.subtreesSkipped));
+    const auto moveStats = moveExecutor->getStatistics();
+    stats.moveQueuePeak = moveStats.peakQueueDepth;
+    stats.moveLatencyAverageMs = moveStats.averageLatencySeconds * 1000.0;
+    stats.moveLatencyMaxMs = moveStats.maxLatencySeconds * 1000.0;
+    Logger::instance().debug(std::format("Peak queue depth: scan {}, items {}, matched {}, moves {} (capacity {})",
+                                         scannedEntries.getPeakSize(), items.getPeakSize(),
+                                         matchedItems.getPeakSize(), moveStats.peakQueueDepth, options.queueDepth));
+    Logger::instance().info(std::format("{} moves on {} threads: {:.3f} ms average, {:.3f} ms max, {:.3f} ms average queue wait",
+                                        moveStats.tasksCompleted, moveExecutor->getWorkerCount(),
+                                        stats.moveLatencyAverageMs, stats.moveLatencyMaxMs,
+                                        moveStats.averageWaitSeconds * 1000.0));
+    if (stats.movesBatched > 0) {
+        Logger::instance().info(std::format("{} moves renamed in io_uring batches", stats.movesBatched));
+    }
+    if (stats.crossDeviceMoves > 0) {
+        Logger::instance().info(std::format("{} cross-device moves copied {} bytes ({:.1f} MiB/sec)",
+                                            stats.crossDeviceMoves, stats.bytesCopied,
+                                            stats.copyBytesPerSecond / (1024.0 * 1024.0)));
+    }
+    
+    if (scanIndex) {
+        Logger::instance().info(std::format("Scan index reused {} unchanged directories", walkStats.directoriesReused));
+        if (!scanIndex->save()) {
+            ++runErrors;
+        }
+    }
+}
+
+std::unique_ptr<ScanIndex> DirectoryOrganizer::openScanIndex() const {
+    if (options.scanIndexFile.empty()) {
+        return nullptr;
+    }
+    // a directory's timestamps only change when entries are added, removed or renamed, so
+    // skipping its listing is only safe when no rule reads anything but names and types
+    if (!hasAttributes(ItemAttribute::Type, attributeDemand)) {
+        Logger::instance().warning("Scan index disabled: rules read item sizes or timestamps, "
+                                   "which can change without touching the directory");
+        return nullptr;
+    }
+    
+    // records are only valid for the tree layout and rule set that produced them
+    auto scanIndex = std::make_unique<ScanIndex>(options.scanIndexFile, ruleSetFingerprint());
+    scanIndex->load();
+    return scanIndex;
+}
+
+std::uint64_t DirectoryOrganizer::ruleSetFingerprint() const {
+    std::uint64_t fingerprint = ScanIndex::hash(sourceDir.generic_string());
+    fingerprint = ScanIndex::hash(targetBaseDir.generic_string(), fingerprint);
+    for (const auto& rule : sortingRules) {
+        fingerprint = ScanIndex::hash(rule->describe(), fingerprint);
+    }
+    return fingerprint;
 }
 
-void DirectoryOrganizer::processItem(const std::filesystem::path& itemPath) {
+std::string DirectoryOrganizer::scanIndexKey(const std::filesystem::path& directory) const {
+    return directory.lexically_relative(sourceDir).generic_string();
+}
+
+std::optional<DirectoryOrganizer::ScannedItem> DirectoryOrganizer::buildItem(const ScanEntry& entry) {
+    // the one place a scanned entry's full path is composed
+    std::filesystem::path itemPath = entry.path();
     try {
-        const ItemRepresentation item(itemPath);
-        
-        if (!shouldProcessItem(item)) {
-            return;
+        // the dirent type classifies the item for free; only symlinks and DT_UNKNOWN need a stat
+        if (entry.type) {
+            return acceptItem(ScannedItem{ItemRepresentation(std::move(itemPath), *entry.type, attributeDemand),
+                                          entry.directory});
         }
-        
-        if (item.getType() == ItemType::File) {
-            processFile(item);
-        } else if (item.getType() == ItemType::Directory) {
-            processDirectory(item);
+        const auto metadata = entry.directory && entry.directory->isValid()
+            ? readFileMetadataAt(entry.directory->getFd(), entry.name.c_str())
+            : readFileMetadata(itemPath);
+        if (!metadata) {
+            Logger::instance().debug("Skipping broken symlink or vanished item: {}", itemPath.string());
+            return std::nullopt;
+        }
+        return acceptItem(ScannedItem{ItemRepresentation(std::move(itemPath), *metadata), entry.directory});
+    } catch (const std::exception& e) {
+        Logger::instance().error("Failed to create ItemRepresentation for {}: {}", entry.path().string(), e.what());
+        ++runErrors;
+        return std::nullopt;
+    }
+}
+
+std::vector<DirectoryOrganizer::ScannedItem> DirectoryOrganizer::buildItems(const std::vector<ScanEntry>& entries,
+                                                                            IoUring& ring) {
+    std::vector<ScannedItem> built;
+    built.reserve(entries.size());
+    const auto keep = [&built](std::optional<ScannedItem> scanned) {
+        if (scanned) {
+            built.push_back(std::move(*scanned));
+        }
+    };
+#if defined(__linux__)
+    // entries whose dirent type is all the rules need cost no syscall at all
+    const bool typeOnly = hasAttributes(ItemAttribute::Type, attributeDemand);
+    std::vector<struct statx> results(entries.size());
+    std::vector<size_t> queued;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        const ScanEntry& entry = entries[i];
+        // relative to the entry's open directory; an entry without one carries its full path
+        const bool relative = entry.directory && entry.directory->isValid();
+        if ((entry.type && typeOnly) || (entry.directory && !relative) ||
+            !ring.queueStatx(relative ? entry.directory->getFd() : AT_FDCWD, entry.name.c_str(),
+                             fileMetadataStatxMask(), &results[i])) {
+            keep(buildItem(entry));
+            continue;
+        }
+        queued.push_back(i);
+    }
+    const std::vector<int> outcomes = ring.submitAndWait();
+    for (size_t k = 0; k < queued.size(); ++k) {
+        const ScanEntry& entry = entries[queued[k]];
+        if (!ring.isAvailable() && (k >= outcomes.size() || outcomes[k] == -ECANCELED)) {
+            keep(buildItem(entry));  // the ring gave up before this one ran
+        } else if (outcomes[k] < 0) {
+            Logger::instance().debug("Skipping broken symlink or vanished item: {}", entry.path().string());
+        } else {
+            try {
+                keep(acceptItem(ScannedItem{ItemRepresentation(entry.path(), toFileMetadata(results[queued[k]])),
+                                            entry.directory}));
+            } catch (const std::exception& e) {
+                Logger::instance().error("Failed to create ItemRepresentation for {}: {}", entry.path().string(), e.what());
+                ++runErrors;
+            }
+        }
+    }
+#else
+    (void)ring;
+    for (const ScanEntry& entry : entries) {
+        keep(buildItem(entry));
+    }
+#endif
+    return built;
+}
+
+std::optional<DirectoryOrganizer::ScannedItem> DirectoryOrganizer::acceptItem(ScannedItem scanned) {
+    const ItemType type = scanned.item.getType();
+    if (type != ItemType::File && type != ItemType::Directory) {
+        Logger::instance().debug("Skipping unsupported item type: {}", scanned.item.getItemPath().string());
+        return std::nullopt;
+    }
+    return scanned;
+}
+
+std::optional<FileMetadata> DirectoryOrganizer::readSourceMetadata(const ScannedItem& source) {
+    if (source.sourceDirectory && source.sourceDirectory->isValid()) {
+        return readFileMetadataAt(source.sourceDirectory->getFd(), source.item.getName().c_str());
+    }
+    return readFileMetadata(source.item.getItemPath());
+}
+
+void DirectoryOrganizer::processMatchedItem(MatchedItem matched) {
+    try {
+        if (matched.source.item.getType() == ItemType::File) {
+            processFile(std::move(matched.source), matched.rule);
         } else {
-            Logger::instance().debug("Skipping unsupported item type: " + itemPath.string());
+            processDirectory(std::move(matched.source), matched.rule);
         }
     } catch (const std::exception& e) {
-        Logger::instance().error("Failed to create ItemRepresentation for " + itemPath.string() + ": " + e.what());
-        stats.errors++;
+        Logger::instance().error("Error processing item {}: {}", matched.source.item.getItemPath().string(), e.what());
+        ++runErrors;
     }
 }
 
-void DirectoryOrganizer::processFile(const ItemRepresentation& item) {
-    stats.filesProcessed++;
+void DirectoryOrganizer::processFile(ScannedItem source, const ISortingRule* matchingRule) {
+    const ItemRepresentation& item = source.item;
+    {
+        std::lock_guard lock(statsMutex);
+        stats.filesProcessed++;
+        if (!matchingRule) {
+            stats.filesSkipped++;
+        }
+    }
 
-    const ISortingRule* matchingRule = findMatchingRule(item);
     if (!matchingRule) {
-        Logger::instance().debug("No matching rule found for file: " + item.getName());
-        stats.filesSkipped++;
+        Logger::instance().debug("No matching rule found for file: {}", item.getName());
         return;
     }
     
     // calculate target path
-    const std::filesystem::path targetPath = targetBaseDir / matchingRule->getTargetRelativePath() / item.getName();
-    
-    Logger::instance().debug("File '" + item.getName() + "' matches rule: " + matchingRule->describe());
+    std::filesystem::path targetPath = targetBaseDir / matchingRule->getTargetRelativePath() / item.getName();
     
-    if (moveItem(item, targetPath)) {
-        stats.filesMovedOrWouldMove++;
-        if (dryRun) {
-            Logger::instance().info("[DRY RUN] Would move file '" + item.getItemPath().string() + "' to '" + targetPath.string() + "'");
-        } else {
-            Logger::instance().info("Moved file '" + item.getItemPath().string() + "' to '" + targetPath.string() + "'");
-        }
-    } else {
-        stats.filesSkipped++;
+    // describe() builds a string, so it is only called when the message is wanted
+    if (Logger::instance().isEnabled(LogLevel::DEBUG)) {
+        Logger::instance().debug("File '{}' matches rule: {}", item.getName(), matchingRule->describe());
     }
+    
+    submitMove(std::move(source), std::move(targetPath), *matchingRule);
 }
 
-void DirectoryOrganizer::processDirectory(const ItemRepresentation& item) {
-    stats.directoriesProcessed++;
+void DirectoryOrganizer::processDirectory(ScannedItem source, const ISortingRule* matchingRule) {
+    const ItemRepresentation& item = source.item;
+    {
+        std::lock_guard lock(statsMutex);
+        stats.directoriesProcessed++;
+        if (!matchingRule) {
+            stats.directoriesSkipped++;
+        }
+    }
 
-    const ISortingRule* matchingRule = findMatchingRule(item);
     if (!matchingRule) {
-        Logger::instance().debug("No matching rule found for directory: " + item.getName());
-        stats.directoriesSkipped++;
+        Logger::instance().debug("No matching rule found for directory: {}", item.getName());
         return;
     }
     
     // calculate target path
-    const std::filesystem::path targetPath = targetBaseDir / matchingRule->getTargetRelativePath() / item.getName();
+    std::filesystem::path targetPath = targetBaseDir / matchingRule->getTargetRelativePath() / item.getName();
+    
+    if (Logger::instance().isEnabled(LogLevel::DEBUG)) {
+        Logger::instance().debug("Directory '{}' matches rule: {}", item.getName(), matchingRule->describe());
+    }
     
-    Logger::instance().debug("Directory '" + item.getName() + "' matches rule: " + matchingRule->describe());
+    submitMove(std::move(source), std::move(targetPath), *matchingRule);
+}
+
+void DirectoryOrganizer::submitMove(ScannedItem source, std::filesystem::path targetPath,
+                                    const ISortingRule& rule) {
+    const ItemRepresentation& item = source.item;
+    if (planWriter) {
+        // planning: record what the move would be, size and mtime included for the re-check
+        const auto metadata = readSourceMetadata(source);
+        if (!metadata) {
+            Logger::instance().debug("Not planning vanished item: {}", item.getItemPath().string());
+            return;
+        }
+        const auto ruleId = std::ranges::find_if(sortingRules, [&](const auto& candidate) {
+            return candidate.get() == &rule;
+        }) - sortingRules.begin();
+        planWriter->add(item.getItemPath(), targetPath, item.getType(), static_cast<std::uint32_t>(ruleId), *metadata);
+        std::lock_guard lock(statsMutex);
+        item.getType() == ItemType::File ? stats.filesMovedOrWouldMove++ : stats.directoriesMovedOrWouldMove++;
+        return;
+    }
     
-    if (moveItem(item, targetPath)) {
-        stats.directoriesMovedOrWouldMove++;
-        if (dryRun) {
-            Logger::instance().info("[DRY RUN] Would move directory '" + item.getItemPath().string() + "' to '" + targetPath.string() + "'");
+    if (moveRing && !dryRun) {
+        // a name already in this batch waits for the next one, so the earlier item keeps it
+        if (moveBatchTargets.contains(targetPath.string())) {
+            runMoveBatch();
+        }
+        const auto journalEntry = planMove(source, targetPath);
+        moveBatchTargets.insert(targetPath.string());
+        moveBatch.push_back(PendingMove{std::move(source), std::move(targetPath), journalEntry});
+        if (moveBatch.size() >= moveRing->getQueueDepth()) {
+            runMoveBatch();
+        }
+        return;
+    }
+    
+    // moves into the same directory are serialized so collision suffixes are handed out in order
+    const std::string strand = targetPath.parent_path().string();
+    const auto journalEntry = planMove(source, targetPath);
+    moveExecutor->submit(strand, [this, source = std::move(source), targetPath = std::move(targetPath), journalEntry] {
+        recordMoveOutcome(source.item, targetPath, moveItem(source, targetPath, journalEntry));
+    });
+}
+
+void DirectoryOrganizer::recordMoveOutcome(const ItemRepresentation& item, const std::filesystem::path& targetPath,
+                                           const bool moved) {
+    const bool isFile = item.getType() == ItemType::File;
+    {
+        std::lock_guard lock(statsMutex);
+        if (isFile) {
+            moved ? stats.filesMovedOrWouldMove++ : stats.filesSkipped++;
         } else {
-            Logger::instance().info("Moved directory '" + item.getItemPath().string() + "' to '" + targetPath.string() + "'");
+            moved ? stats.directoriesMovedOrWouldMove++ : stats.directoriesSkipped++;
         }
+    }
+    if (!moved) {
+        return;
+    }
+    const char* kind = isFile ? "file" : "directory";
+    if (dryRun) {
+        Logger::instance().info("[DRY RUN] Would move {} '{}' to '{}'", kind, item.getItemPath().string(),
+                                targetPath.string());
     } else {
-        stats.directoriesSkipped++;
+        Logger::instance().info("Moved {} '{}' to '{}'", kind, item.getItemPath().string(), targetPath.string());
     }
 }
 
-ISortingRule* DirectoryOrganizer::findMatchingRule(const ItemRepresentation& item) const {
-    for (const auto& rule : sortingRules) {
-        if (rule->matches(item)) {
-            return rule.get();
+void DirectoryOrganizer::runMoveBatch() {
+    std::vector<PendingMove> batch;
+    batch.swap(moveBatch);
+    moveBatchTargets.clear();
+    if (batch.empty()) {
+        return;
+    }
+    
+    // anything beyond a plain rename takes the regular path, which handles every case
+    std::vector<bool> done(batch.size(), false);
+    const auto handOver = [&] {
+        for (size_t i = 0; i < batch.size(); ++i) {
+            if (done[i]) {
+                continue;
+            }
+            const std::string strand = batch[i].targetPath.parent_path().string();
+            moveExecutor->submit(strand, [this, move = std::move(batch[i])] {
+                recordMoveOutcome(move.source.item, move.targetPath, moveItem(move.source, move.targetPath, move.journalEntry));
+            });
+        }
+    };
+    
+#if defined(__linux__) && defined(RENAME_NOREPLACE)
+    // write-ahead: one group commit covers the whole batch
+    std::optional<std::uint64_t> lastJournalEntry;
+    for (const PendingMove& move : batch) {
+        if (move.journalEntry) {
+            lastJournalEntry = std::max(lastJournalEntry.value_or(0), *move.journalEntry);
         }
     }
-    return nullptr;
+    if (!moveRing->isAvailable() || (lastJournalEntry && !journal->commitThrough(*lastJournalEntry))) {
+        handOver();
+        return;
+    }
+    
+    // target directories not known yet are created with one mkdirat each; missing parents
+    // are left to the regular path
+    std::vector<std::string> missingDirectories;
+    for (const PendingMove& move : batch) {
+        std::string directory = move.targetPath.parent_path().string();
+        if (!findTargetDirectory(directory) && std::ranges::find(missingDirectories, directory) == missingDirectories.end()) {
+            missingDirectories.push_back(std::move(directory));
+        }
+    }
+    if (!missingDirectories.empty()) {
+        for (const std::string& directory : missingDirectories) {
+            moveRing->queueMkdirat(AT_FDCWD, directory.c_str(), 0777);
+        }
+        const std::vector<int> created = moveRing->submitAndWait();
+        for (size_t i = 0; i < created.size(); ++i) {
+            if (created[i] == 0 || created[i] == -EEXIST) {
+                rememberTargetDirectory(missingDirectories[i]);
+            }
+        }
+    }
+    
+    // moves handed to the executor earlier may still be pending in these directories; they
+    // go first so they keep the names they were planned for
+    std::vector<std::string> strands;
+    for (const PendingMove& move : batch) {
+        std::string strand = move.targetPath.parent_path().string();
+        if (std::ranges::find(strands, strand) == strands.end()) {
+            moveExecutor->waitForStrand(strand);
+            strands.push_back(std::move(strand));
+        }
+    }
+    
+    // reserved up front: the queued renames point into these strings
+    std::vector<std::string> names;
+    names.reserve(batch.size());
+    std::vector<size_t> queued;
+    for (size_t i = 0; i < batch.size(); ++i) {
+        names.push_back(batch[i].targetPath.filename().string());
+        const auto directory = findTargetDirectory(batch[i].targetPath.parent_path());
+        // the source is renamed relative to the directory it was listed from where it has one
+        const ScannedItem& source = batch[i].source;
+        const bool relative = source.sourceDirectory && source.sourceDirectory->isValid();
+        if (directory && directory->isValid() &&
+            moveRing->queueRenameat(relative ? source.sourceDirectory->getFd() : AT_FDCWD,
+                                    relative ? source.item.getName().c_str() : source.item.getItemPath().c_str(),
+                                    directory->getFd(), names.back().c_str(), RENAME_NOREPLACE)) {
+            queued.push_back(i);
+        }
+    }
+    const std::vector<int> outcomes = moveRing->submitAndWait();
+    size_t batched = 0;
+    for (size_t k = 0; k < queued.size() && k < outcomes.size(); ++k) {
+        if (outcomes[k] != 0) {
+            continue;
+        }
+        const PendingMove& move = batch[queued[k]];
+        targetNames.recordName(move.targetPath.parent_path(), names[queued[k]]);
+        if (move.journalEntry) {
+            journal->complete(*move.journalEntry, move.targetPath);
+        }
+        recordMoveOutcome(move.source.item, move.targetPath, true);
+        done[queued[k]] = true;
+        ++batched;
+    }
+    {
+        std::lock_guard lock(statsMutex);
+        stats.movesBatched += batched;
+    }
+#endif
+    handOver();
 }
 
-bool DirectoryOrganizer::moveItem(const ItemRepresentation& item, const std::filesystem::path& targetPath) {
+void DirectoryOrganizer::finishMoves() {
+    runMoveBatch();
+    moveExecutor->wait();
+}
+
+ISortingRule* DirectoryOrganizer::findMatchingRule(const ItemRepresentation& item) const {
+    return ruleIndex->findMatchingRule(item, evaluationContext);
+}
+
+bool DirectoryOrganizer::moveItem(const ScannedItem& source, const std::filesystem::path& targetPath,
+                                  const std::optional<std::uint64_t> journalEntry) {
+    const ItemRepresentation& item = source.item;
     if (dryRun) {
         // in dry run mode, just validate the move would be possible
         return true;
     }
     
+    // write-ahead: the planned move is on disk before the item leaves its place
+    if (journalEntry && !journal->commitThrough(*journalEntry)) {
+        Logger::instance().error("Not moving {} without a move journal", item.getItemPath().string());
+        ++runErrors;
+        return false;
+    }
+    
     try {
-        // ensure target directory exists
-        if (!ensureDirectoryExists(targetPath.parent_path())) {
-            Logger::instance().error("Failed to create target directory: " + targetPath.parent_path().string());
-            stats.errors++;
-            return false;
-        }
-        
-        // generate unique target if file already exists
-        std::filesystem::path finalTargetPath = targetPath;
-        if (std::filesystem::exists(targetPath)) {
-            finalTargetPath = generateUniqueTarget(targetPath);
-            Logger::instance().warning("Target already exists, using: " + finalTargetPath.string());
+        // ensure target directory exists; normally already created or cached
+        const std::filesystem::path targetDirectory = targetPath.parent_path();
+        auto directory = ensureTargetDirectory(targetDirectory);
+        if (!directory) {
+            throw std::runtime_error("Failed to create target directory: " + targetDirectory.string());
         }
         
         // perform the move
-        std::filesystem::rename(item.getItemPath(), finalTargetPath);
+        std::filesystem::path finalTargetPath;
+        std::error_code ec = placeItem(source, *directory, targetPath, finalTargetPath, journalEntry);
+        if (ec == std::errc::no_such_file_or_directory && !std::filesystem::exists(targetDirectory)) {
+            // the cached target directory was removed behind our back: create it again
+            forgetTargetDirectory(targetDirectory);
+            directory = ensureTargetDirectory(targetDirectory);
+            if (directory) {
+                ec = placeItem(source, *directory, targetPath, finalTargetPath, journalEntry);
+            }
+        }
+        if (ec) {
+            throw std::filesystem::filesystem_error("rename", item.getItemPath(), finalTargetPath, ec);
+        }
+        if (finalTargetPath != targetPath) {
+            Logger::instance().warning("Target already exists, using: {}", finalTargetPath.string());
+        }
+        targetNames.recordName(targetDirectory, finalTargetPath.filename().string());
+        if (journalEntry) {
+            journal->complete(*journalEntry, finalTargetPath);
+        }
         return true;
         
     } catch (const std::exception& e) {
-        Logger::instance().error(std::format("Failed to move item: {}", e.what()));
-        stats.errors++;
+        Logger::instance().error("Failed to move item: {}", e.what());
+        ++runErrors;
+        if (journalEntry) {
+            journal->fail(*journalEntry);
+        }
+        return false;
+    }
+}
+
+bool DirectoryOrganizer::openJournal() {
+    if (options.journalDirectory.empty() || journal) {
+        return true;
+    }
+    std::error_code ec;
+    std::filesystem::create_directories(options.journalDirectory, ec);
+    if (ec) {
+        Logger::instance().error(std::format("Failed to create journal directory {}: {}",
+                                             options.journalDirectory.string(), ec.message()));
+        return false;
+    }
+    
+    const std::string newRunId = MoveJournal::newRunId();
+    auto newJournal = std::make_unique<MoveJournal>(MoveJournal::journalPath(options.journalDirectory, newRunId));
+    if (!newJournal->create()) {
+        return false;
+    }
+    journal = std::move(newJournal);
+    runId = newRunId;
+    Logger::instance().info(std::format("Journaling moves of run {} to {}", runId, journal->getJournalFile().string()));
+    return true;
+}
+
+std::optional<std::uint64_t> DirectoryOrganizer::planMove(const ScannedItem& source,
+                                                          const std::filesystem::path& targetPath) {
+    if (dryRun || !journal) {
+        return std::nullopt;
+    }
+    // identifies the item after a crash, wherever the move left it
+    const auto identity = readSourceMetadata(source);
+    return journal->plan(source.item.getItemPath(), targetPath, identity.value_or(FileMetadata{}));
+}
+
+void DirectoryOrganizer::flushJournal() {
+    if (!journal) {
+        return;
+    }
+    if (!journal->flush()) {
+        ++runErrors;
+    }
+    const auto journalStats = journal->getStatistics();
+    Logger::instance().debug(std::format("Move journal: {} records in {} commits", journalStats.recordsWritten,
+                                         journalStats.commits));
+}
+
+std::error_code DirectoryOrganizer::placeItem(const ScannedItem& scanned, const DirectoryHandle& directory,
+                                              const std::filesystem::path& targetPath,
+                                              std::filesystem::path& finalTargetPath,
+                                              const std::optional<std::uint64_t> journalEntry) {
+    const std::filesystem::path& source = scanned.item.getItemPath();
+    // relative to the directory the item was listed from, so its path is never resolved again
+    const auto rename = [&] {
+        const std::string name = finalTargetPath.filename().string();
+        return scanned.sourceDirectory
+            ? renameNoReplace(*scanned.sourceDirectory, scanned.item.getName(), directory, name)
+            : renameNoReplace(source, directory, name);
+    };
+    // the common case is a single renameat2(); a taken name is only resolved when it happens
+    finalTargetPath = targetPath;
+    std::error_code ec = rename();
+    while (ec == std::errc::file_exists) {
+        finalTargetPath = targetNames.reserveUniqueTarget(targetPath, false);
+        ec = rename();
+    }
+    if (ec == std::errc::operation_not_supported) {
+        // no RENAME_NOREPLACE here: check, then rename, leaving a window for a concurrent writer
+        finalTargetPath = targetPath;
+        if (std::filesystem::exists(targetPath)) {
+            finalTargetPath = targetNames.reserveUniqueTarget(targetPath);
+        }
+        std::filesystem::rename(source, finalTargetPath, ec);
+    }
+    if (ec == std::errc::cross_device_link) {
+        return copyAcrossDevices(source, targetPath, finalTargetPath, journalEntry);
+    }
+    return ec;
+}
+
+std::error_code DirectoryOrganizer::copyAcrossDevices(const std::filesystem::path& source,
+                                                      const std::filesystem::path& targetPath,
+                                                      std::filesystem::path& finalTargetPath,
+                                                      const std::optional<std::uint64_t> journalEntry) {
+    CrossDeviceOptions copyOptions;
+    copyOptions.fsync = options.fsyncCopies;
+    copyOptions.threads = options.copyThreads > 0 ? options.copyThreads : std::max(1u, std::thread::hardware_concurrency());
+    // recovery only ever removes a copy the journal knows this move created
+    CopyCreated onCreated;
+    if (journalEntry) {
+        onCreated = [&](const std::uint64_t device, const std::uint64_t inode) {
+            return journal->recordCopy(*journalEntry, finalTargetPath, device, inode);
+        };
+    }
+    
+    const auto started = std::chrono::steady_clock::now();
+    CrossDeviceResult result = moveAcrossDevices(source, finalTargetPath, copyOptions, onCreated);
+    while (result.error == std::errc::file_exists) {
+        finalTargetPath = targetNames.reserveUniqueTarget(targetPath, false);
+        result = moveAcrossDevices(source, finalTargetPath, copyOptions, onCreated);
+    }
+    if (result.error) {
+        return result.error;
+    }
+    
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    std::lock_guard lock(statsMutex);
+    stats.crossDeviceMoves++;
+    stats.bytesCopied += result.bytesCopied;
+    stats.copySeconds += seconds;
+    stats.copyBytesPerSecond = stats.copySeconds > 0.0
+        ? static_cast<double>(stats.bytesCopied) / stats.copySeconds
+        : 0.0;
+    return {};
+}
+
+bool DirectoryOrganizer::prepareTargetDirectories() {
+    {
+        std::lock_guard lock(knownDirectoriesMutex);
+        knownDirectories.clear();
+    }
+    targetNames.clear();
+    if (!ensureTargetDirectory(targetBaseDir)) {
         return false;
     }
+    // a rule directory that can't be created is reported again by the first move into it
+    for (const auto& rule : sortingRules) {
+        ensureTargetDirectory(targetBaseDir / rule->getTargetRelativePath());
+    }
+    return true;
+}
+
+std::shared_ptr<const DirectoryHandle> DirectoryOrganizer::ensureTargetDirectory(const std::filesystem::path& directory) {
+    if (auto known = findTargetDirectory(directory)) {
+        return known;
+    }
+    if (!ensureDirectoryExists(directory)) {
+        return nullptr;
+    }
+    return rememberTargetDirectory(directory);
+}
+
+std::shared_ptr<const DirectoryHandle> DirectoryOrganizer::findTargetDirectory(const std::filesystem::path& directory) {
+    std::lock_guard lock(knownDirectoriesMutex);
+    const auto it = knownDirectories.find(directory.string());
+    return it != knownDirectories.end() ? it->second : nullptr;
+}
+
+std::shared_ptr<const DirectoryHandle> DirectoryOrganizer::rememberTargetDirectory(const std::filesystem::path& directory) {
+    // kept open so renames into the directory don't resolve its path again
+    auto handle = std::make_shared<const DirectoryHandle>(directory);
+    std::lock_guard lock(knownDirectoriesMutex);
+    knownDirectories.insert_or_assign(directory.string(), handle);
+    return handle;
+}
+
+void DirectoryOrganizer::forgetTargetDirectory(const std::filesystem::path& directory) {
+    std::lock_guard lock(knownDirectoriesMutex);
+    knownDirectories.erase(directory.string());
 }
 
 bool DirectoryOrganizer::ensureDirectoryExists(const std::filesystem::path& directory) {
     try {
         if (!std::filesystem::exists(directory)) {
             std::filesystem::create_directories(directory);
-            Logger::instance().debug("Created directory: " + directory.string());
+            Logger::instance().debug("Created directory: {}", directory.string());
         }
         return true;
     } catch (const std::exception& e) {
-        Logger::instance().error("Failed to create directory " + directory.string() + ": " + e.what());
+        Logger::instance().error("Failed to create directory {}: {}", directory.string(), e.what());
         return false;
     }
 }
 
-bool DirectoryOrganizer::shouldProcessItem(const ItemRepresentation& item) const {
-    // skip items that are already in the target directory tree
-    const std::filesystem::path itemPath = std::filesystem::absolute(item.getItemPath());
-    const std::filesystem::path targetPath = std::filesystem::absolute(targetBaseDir);
-    
-    // check if item is within target directory
-    try {
-        std::filesystem::path relativePath = std::filesystem::relative(itemPath, targetPath);
-        if (!relativePath.empty() && relativePath.string().find("..") != 0) {
-            Logger::instance().debug("Skipping item already in target directory: " + item.getName());
-            return false;
-        }
-    } catch (const std::exception&) {
-        // if relative path calculation fails, assume it's safe to process
+std::optional<std::filesystem::path> DirectoryOrganizer::findTargetInsideSource() const {
+    std::error_code ec;
+    const std::filesystem::path source = std::filesystem::weakly_canonical(sourceDir, ec);
+    if (ec) {
+        return std::nullopt;
+    }
+    const std::filesystem::path target = std::filesystem::weakly_canonical(targetBaseDir, ec);
+    if (ec) {
+        return std::nullopt;
     }
     
-    return true;
+    const std::filesystem::path relativePath = target.lexically_relative(source);
+    if (relativePath.empty() || *relativePath.begin() == "..") {
+        return std::nullopt;
+    }
+    if (relativePath == ".") {
+        return sourceDir;
+    }
+    // expressed the way the walker builds entry paths, so a plain comparison finds it
+    return sourceDir / relativePath;
 }
 
-std::filesystem::path DirectoryOrganizer::generateUniqueTarget(const std::filesystem::path& targetPath) {
-    const std::filesystem::path directory = targetPath.parent_path();
-    const std::string stem = targetPath.stem().string();
-    const std::string extension = targetPath.extension().string();
-    
-    int counter = 1;
-    std::filesystem::path uniquePath;
-    
-    do {
-        std::ostringstream ss;
-        ss << stem << "_" << std::setfill('0') << std::setw(3) << counter << extension;
-        uniquePath = directory / ss.str();
-        counter++;
-    } while (std::filesystem::exists(uniquePath) && counter < 1000);
-    
-    if (counter >= 1000) {
-        throw std::runtime_error("Could not generate unique filename after 1000 attempts");
-    }
-    
-    return uniquePath;
-} 
\ No newline at end of file
+bool DirectoryOrganizer::isWithin(const std::filesystem::path& path, const std::filesystem::path& directory) {
+    const auto [directoryEnd, pathEnd] = std::ranges::mismatch(directory, path);
+    return directoryEnd == directory.end();
+}
+ 
\ No newline at end of file
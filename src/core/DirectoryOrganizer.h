@@ -3,8 +3,36 @@
 #include <filesystem>
 #include <vector>
 #include <memory>
+#include <optional>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include "rules/ISortingRule.h"
+#include "rules/RuleIndex.h"
 #include "models/ItemRepresentation.h"
+#include "models/ItemBatch.h"
+#include "core/ParallelDirectoryWalker.h"
+#include "core/ScanIndex.h"
+#include "core/MoveExecutor.h"
+#include "core/TargetNameIndex.h"
+#include "core/FileOperations.h"
+#include "core/MoveJournal.h"
+#include "core/MovePlan.h"
+#include "core/IoUring.h"
+
+// Tuning knobs for a DirectoryOrganizer run
+struct OrganizerOptions {
+    size_t scanThreads = 0;  // directory walker workers, 0 = hardware concurrency
+    size_t moveThreads = 0;  // move executor workers, 0 = hardware concurrency
+    size_t queueDepth = 1024;  // capacity of each queue between pipeline stages
+    std::filesystem::path scanIndexFile;  // incremental scan index, empty = list every directory
+    size_t copyThreads = 0;  // threads sharing one large cross-device copy, 0 = hardware concurrency
+    bool fsyncCopies = false;  // flush cross-device copies to disk before removing the source
+    std::filesystem::path journalDirectory;  // where each run's move journal goes, empty = no journal
+    size_t ioUringDepth = 0;  // stats, mkdirs and renames per io_uring batch, 0 = one blocking call at a time
+};
 
 class DirectoryOrganizer {
 public:
@@ -12,7 +40,8 @@ public:
         std::filesystem::path sourceDirectory,
         std::filesystem::path targetBaseDirectory,
         std::vector<std::unique_ptr<ISortingRule>> rules,
-        bool dryRunEnabled = false
+        bool dryRunEnabled = false,
+        OrganizerOptions organizerOptions = {}
     );
     
     ~DirectoryOrganizer() = default;
@@ -20,6 +49,29 @@ public:
     // Main method to scan and organize files
     void scanAndOrganize();
     
+    // Organize only the given items of the source tree, e.g. ones reported by a file watcher.
+    // Vanished items are ignored; unclaimed directories have their contents organized too.
+    void organizeItems(const std::vector<std::filesystem::path>& paths);
+    
+    // Organize the contents of one directory below the source directory
+    void rescanDirectory(const std::filesystem::path& directory);
+    
+    // Scan and match like scanAndOrganize(), but write the moves to planFile instead of making them
+    void writePlan(const std::filesystem::path& planFile);
+    
+    // Make the moves of a plan written by writePlan() for the same directories and rules, without
+    // scanning. Items whose size or mtime changed since planning are left where they are.
+    void executePlan(const std::filesystem::path& planFile);
+    
+    const std::filesystem::path& getSourceDirectory() const { return sourceDir; }
+    const std::filesystem::path& getTargetBaseDirectory() const { return targetBaseDir; }
+    
+    // Where the target tree sits inside the source tree (as a walker path), if it does
+    std::optional<std::filesystem::path> findTargetInsideSource() const;
+    
+    // Whether path is directory or lies below it, compared lexically
+    static bool isWithin(const std::filesystem::path& path, const std::filesystem::path& directory);
+    
     // Get statistics about the last operation
     struct Statistics {
         size_t filesProcessed = 0;
@@ -29,37 +81,160 @@ public:
         size_t directoriesMovedOrWouldMove = 0;
         size_t directoriesSkipped = 0;
         size_t errors = 0;
+        size_t entriesScanned = 0;
+        double scanSeconds = 0.0;
+        double scanEntriesPerSecond = 0.0;
+        size_t directoriesReused = 0;  // unchanged directories the scan index saved a listing of
+        size_t moveQueuePeak = 0;
+        double moveLatencyAverageMs = 0.0;
+        double moveLatencyMaxMs = 0.0;
+        size_t crossDeviceMoves = 0;  // moves that had to copy because the target is on another filesystem
+        uintmax_t bytesCopied = 0;
+        double copySeconds = 0.0;
+        double copyBytesPerSecond = 0.0;
+        size_t itemsChangedSincePlan = 0;  // planned moves executePlan() skipped
+        size_t movesBatched = 0;  // moves made by a batched io_uring rename
     };
     
     const Statistics& getStatistics() const { return stats; }
     
     // Reset statistics
     void resetStatistics();
+    
+    // Id of the run's move journal, empty until the first move is journaled
+    const std::string& getRunId() const { return runId; }
+    
+    // Item attributes fetched for every scanned item, derived from the rules
+    ItemAttribute getAttributeDemand() const { return attributeDemand; }
 
 private:
     std::filesystem::path sourceDir;
     std::filesystem::path targetBaseDir;
     std::vector<std::unique_ptr<ISortingRule>> sortingRules;
+    // sortingRules by extension; items are only tried against the rules they can match, one
+    // at a time in findMatchingRule() as well as in the match stage's batches
+    std::unique_ptr<RuleIndex> ruleIndex;
+    // clock snapshot taken when a run starts; every age condition of the run measures from it
+    EvaluationContext evaluationContext;
+    // most items the match stage matches together, see ItemBatch
+    static constexpr size_t matchBatchSize = 256;
     bool dryRun;
+    OrganizerOptions options;
     Statistics stats;
+    // item counters are updated from move executor workers
+    std::mutex statsMutex;
+    
+    std::unordered_map<std::string, std::shared_ptr<const DirectoryHandle>> knownDirectories;
+    std::mutex knownDirectoriesMutex;
+    
+    // names already taken in target directories, for collision resolution
+    TargetNameIndex targetNames;
+    
+    // set while writePlan() runs: moves are recorded here instead of made
+    MovePlan::Writer* planWriter = nullptr;
+    
+    // one journal per organizer; watch mode appends every batch to it
+    std::unique_ptr<MoveJournal> journal;
+    std::string runId;
+    
+    // An item and the open directory it was listed from, so its metadata and rename are issued
+    // relative to that directory; sourceDirectory is nullptr for items known only by path
+    struct ScannedItem {
+        ItemRepresentation item;
+        std::shared_ptr<const DirectoryHandle> sourceDirectory;
+    };
+    // A move waiting in the current io_uring batch
+    struct PendingMove {
+        ScannedItem source;
+        std::filesystem::path targetPath;
+        std::optional<std::uint64_t> journalEntry;
+    };
+    std::unique_ptr<IoUring> moveRing;
+    std::vector<PendingMove> moveBatch;
+    std::unordered_set<std::string> moveBatchTargets;
+    
+    // attributes any rule can read, fetched for every item; anything else stays unfetched
+    ItemAttribute attributeDemand = ItemAttribute::Type;
+    
+    // errors raised by pipeline stages running on other threads, folded into stats at the end
+    std::atomic<size_t> runErrors{0};
+    
+    // An item that went through rule matching; rule is nullptr when nothing matched
+    struct MatchedItem {
+        ScannedItem source;
+        const ISortingRule* rule;
+    };
+    
+    // Run the scan -> item -> match -> move pipeline over the tree below root
+    void runPipeline(const std::filesystem::path& root);
+    
+    // The configured scan index, loaded; nullptr when disabled or unsafe for these rules
+    std::unique_ptr<ScanIndex> openScanIndex() const;
+    std::string scanIndexKey(const std::filesystem::path& directory) const;
+    // Identifies the directories and rule set that scan indexes and move plans were made for
+    std::uint64_t ruleSetFingerprint() const;
     
     // Helper methods
-    void processItem(const std::filesystem::path& itemPath);
-    void processFile(const ItemRepresentation& item);
-    void processDirectory(const ItemRepresentation& item);
+    std::optional<ScannedItem> buildItem(const ScanEntry& entry);
+    // buildItem() for a batch of entries, fetching their metadata with one io_uring submission
+    std::vector<ScannedItem> buildItems(const std::vector<ScanEntry>& entries, IoUring& ring);
+    std::optional<ScannedItem> acceptItem(ScannedItem scanned);
+    // Metadata of an item, stat'ed relative to its source directory where it has one
+    static std::optional<FileMetadata> readSourceMetadata(const ScannedItem& source);
+    void processMatchedItem(MatchedItem matched);
+    void processFile(ScannedItem source, const ISortingRule* matchingRule);
+    void processDirectory(ScannedItem source, const ISortingRule* matchingRule);
+    // Hand a matched item's move to the move executor, or to the plan while planning
+    void submitMove(ScannedItem source, std::filesystem::path targetPath, const ISortingRule& rule);
+    // Count a finished move and log it
+    void recordMoveOutcome(const ItemRepresentation& item, const std::filesystem::path& targetPath, bool moved);
+    
+    // Rename the batched moves with one io_uring submission; moves that need more than a plain
+    // rename (collisions, other filesystems, failures) go through moveItem() on the executor
+    void runMoveBatch();
+    // Run what is left of the batch and wait for every move handed to the executor
+    void finishMoves();
+    
+    // Reset statistics and take the run's evaluation context
+    void startRun();
     
     // Find the first matching rule for an item
     ISortingRule* findMatchingRule(const ItemRepresentation& item) const;
     
-    // Move item to target location
-    bool moveItem(const ItemRepresentation& item, const std::filesystem::path& targetPath);
+    // Move item to target location; journalEntry is the move's planned journal entry, if any
+    bool moveItem(const ScannedItem& source, const std::filesystem::path& targetPath,
+                  std::optional<std::uint64_t> journalEntry);
+    
+    // Start the move journal if one is configured and not started yet
+    bool openJournal();
+    // Record a move in the journal before it is handed to the move executor
+    std::optional<std::uint64_t> planMove(const ScannedItem& source, const std::filesystem::path& targetPath);
+    // Make the outcomes of finished moves durable
+    void flushJournal();
+    
+    // Rename source into directory without replacing anything, switching to a free "stem_NNN"
+    // name while the wanted one is taken; finalTargetPath receives the path actually used
+    std::error_code placeItem(const ScannedItem& scanned, const DirectoryHandle& directory,
+                              const std::filesystem::path& targetPath, std::filesystem::path& finalTargetPath,
+                              std::optional<std::uint64_t> journalEntry);
+    
+    // placeItem() for a target on another filesystem: copy, then remove the source; the
+    // copy is recorded in the journal entry before anything goes into it
+    std::error_code copyAcrossDevices(const std::filesystem::path& source, const std::filesystem::path& targetPath,
+                                      std::filesystem::path& finalTargetPath, std::optional<std::uint64_t> journalEntry);
     
     // Create directory structure if it doesn't exist
     static bool ensureDirectoryExists(const std::filesystem::path& directory);
     
-    // Check if an item should be processed (e.g., not already in target directory)
-    bool shouldProcessItem(const ItemRepresentation& item) const;
+    // Target directories known to exist, so a move into one costs no extra metadata calls.
+    // Cleared and refilled with every rule's directory at the start of each full run.
+    bool prepareTargetDirectories();
+    std::shared_ptr<const DirectoryHandle> ensureTargetDirectory(const std::filesystem::path& directory);
+    std::shared_ptr<const DirectoryHandle> findTargetDirectory(const std::filesystem::path& directory);
+    // Open and cache a target directory that exists
+    std::shared_ptr<const DirectoryHandle> rememberTargetDirectory(const std::filesystem::path& directory);
+    void forgetTargetDirectory(const std::filesystem::path& directory);
     
-    // Generate unique filename if target already exists
-    static std::filesystem::path generateUniqueTarget(const std::filesystem::path& targetPath);
+    // declared last so it is destroyed first: its tasks reference the members above
+    std::unique_ptr<MoveExecutor> moveExecutor;
 }; 
\ No newline at end of file
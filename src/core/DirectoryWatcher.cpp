@@ -0,0 +1,290 @@
+#include "core/DirectoryWatcher.h"
+#include "Logger.h"
+#include <format>
+#include <vector>
+#include <algorithm>
+#include <system_error>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <sys/eventfd.h>
+#include <poll.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdint>
+#endif
+
+namespace {
+
+// a steady stream of writes must not hold a batch back forever
+constexpr int maxDebounceWindows = 4;
+
+} // namespace
+
+DirectoryWatcher::DirectoryWatcher(DirectoryOrganizer& organizer, const WatchOptions watchOptions)
+    : organizer(organizer), options(watchOptions), targetInSource(organizer.findTargetInsideSource()) {
+#ifdef __linux__
+    // created up front so stop() works even before run() starts
+    stopFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+#endif
+}
+
+DirectoryWatcher::~DirectoryWatcher() {
+#ifdef __linux__
+    if (inotifyFd >= 0) {
+        ::close(inotifyFd);
+    }
+    if (stopFd >= 0) {
+        ::close(stopFd);
+    }
+#endif
+}
+
+void DirectoryWatcher::stop() {
+    stopRequested = true;
+#ifdef __linux__
+    if (stopFd >= 0) {
+        const std::uint64_t one = 1;
+        [[maybe_unused]] const auto written = ::write(stopFd, &one, sizeof(one));
+    }
+#endif
+}
+
+#ifdef __linux__
+
+bool DirectoryWatcher::run() {
+    const std::filesystem::path& sourceDir = organizer.getSourceDirectory();
+    if (stopFd < 0) {
+        Logger::instance().error(std::format("Failed to create watcher stop event: {}", std::generic_category().message(errno)));
+        return false;
+    }
+    inotifyFd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyFd < 0) {
+        Logger::instance().error(std::format("Failed to initialize inotify: {}", std::generic_category().message(errno)));
+        return false;
+    }
+
+    // watches go in before the first pass so nothing arriving during it is missed
+    addWatchTree(sourceDir);
+    Logger::instance().info(std::format("Watching {} directories below {}", watchPaths.size(), sourceDir.string()));
+    organizer.scanAndOrganize();
+    ++stats.fullRescans;
+
+    auto nextRescan = std::chrono::steady_clock::now() + options.rescanInterval;
+    while (!stopRequested) {
+        const auto now = std::chrono::steady_clock::now();
+
+        // sleep until the debounce window closes, or the next periodic rescan is due
+        auto deadline = nextRescan;
+        if (!pendingItems.empty() || fullRescanPending) {
+            deadline = std::min(lastEvent + options.debounce, firstPendingEvent + maxDebounceWindows * options.debounce);
+        }
+        const auto timeout = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now).count();
+
+        pollfd fds[2] = {{inotifyFd, POLLIN, 0}, {stopFd, POLLIN, 0}};
+        const int ready = ::poll(fds, 2, static_cast<int>(std::clamp<long long>(timeout, 0, 60'000)));
+        if (ready < 0 && errno != EINTR) {
+            Logger::instance().error(std::format("Failed to wait for file events: {}", std::generic_category().message(errno)));
+            break;
+        }
+        if (stopRequested) {
+            break;
+        }
+        if (ready > 0 && (fds[0].revents & (POLLERR | POLLNVAL))) {
+            Logger::instance().error("inotify descriptor failed, stopping watch mode");
+            break;
+        }
+        if (ready > 0 && (fds[0].revents & POLLIN)) {
+            readEvents();
+        }
+
+        const auto afterPoll = std::chrono::steady_clock::now();
+        if ((!pendingItems.empty() || fullRescanPending) &&
+            (afterPoll >= lastEvent + options.debounce ||
+             afterPoll >= firstPendingEvent + maxDebounceWindows * options.debounce)) {
+            flushPending();
+        }
+        if (afterPoll >= nextRescan) {
+            rescanUnwatched();
+            nextRescan = afterPoll + options.rescanInterval;
+        }
+    }
+
+    stats.watchedDirectories = watchPaths.size();
+    stats.unwatchedDirectories = unwatchedDirectories.size();
+    Logger::instance().info(std::format("Stopped watching {}: {} events, {} batches, {} items organized, {} overflows",
+                                        sourceDir.string(), stats.eventsReceived, stats.batchesProcessed,
+                                        stats.itemsOrganized, stats.overflows));
+    return true;
+}
+
+void DirectoryWatcher::addWatchTree(const std::filesystem::path& root) {
+    if (!addWatch(root)) {
+        return;
+    }
+
+    std::error_code ec;
+    std::filesystem::recursive_directory_iterator it(root, std::filesystem::directory_options::skip_permission_denied, ec);
+    for (const std::filesystem::recursive_directory_iterator end; !ec && it != end; it.increment(ec)) {
+        std::error_code typeEc;
+        if (it->is_symlink(typeEc) || !it->is_directory(typeEc)) {
+            continue;
+        }
+        if (!addWatch(it->path())) {
+            // covered by the periodic rescan of the unwatched directory instead
+            it.disable_recursion_pending();
+        }
+    }
+    if (ec && ec != std::errc::no_such_file_or_directory) {
+        Logger::instance().warning(std::format("Failed to watch everything below {}: {}", root.string(), ec.message()));
+    }
+}
+
+bool DirectoryWatcher::addWatch(const std::filesystem::path& directory) {
+    if (targetInSource && DirectoryOrganizer::isWithin(directory, *targetInSource)) {
+        return false;
+    }
+
+    constexpr uint32_t mask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_CREATE |
+                              IN_ONLYDIR | IN_DONT_FOLLOW | IN_EXCL_UNLINK;
+    const int wd = ::inotify_add_watch(inotifyFd, directory.c_str(), mask);
+    if (wd < 0) {
+        if (errno == ENOSPC) {
+            if (unwatchedDirectories.empty()) {
+                Logger::instance().warning("inotify watch limit reached (fs.inotify.max_user_watches), "
+                                           "falling back to periodic rescans of the remaining directories");
+            }
+            unwatchedDirectories.insert(directory);
+        } else if (errno != ENOENT && errno != ENOTDIR) {
+            Logger::instance().warning(std::format("Failed to watch {}: {}", directory.string(),
+                                                   std::generic_category().message(errno)));
+        }
+        return false;
+    }
+
+    watchPaths[wd] = directory;
+    unwatchedDirectories.erase(directory);
+    watchCount = watchPaths.size();
+    return true;
+}
+
+void DirectoryWatcher::removeWatchTree(const std::filesystem::path& root) {
+    for (auto it = watchPaths.begin(); it != watchPaths.end();) {
+        if (DirectoryOrganizer::isWithin(it->second, root)) {
+            ::inotify_rm_watch(inotifyFd, it->first);
+            it = watchPaths.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    std::erase_if(unwatchedDirectories, [&](const auto& directory) {
+        return DirectoryOrganizer::isWithin(directory, root);
+    });
+    watchCount = watchPaths.size();
+}
+
+void DirectoryWatcher::readEvents() {
+    alignas(inotify_event) char buffer[64 * 1024];
+
+    while (true) {
+        const ssize_t length = ::read(inotifyFd, buffer, sizeof(buffer));
+        if (length <= 0) {
+            if (length < 0 && errno != EAGAIN && errno != EINTR) {
+                Logger::instance().error(std::format("Failed to read file events: {}", std::generic_category().message(errno)));
+            }
+            return;
+        }
+
+        for (ssize_t offset = 0; offset < length;) {
+            const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+            offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+            ++stats.eventsReceived;
+            const bool batchWasEmpty = pendingItems.empty() && !fullRescanPending;
+
+            if (event->mask & IN_Q_OVERFLOW) {
+                // events were dropped somewhere in the tree, so only a full pass is safe
+                Logger::instance().warning("inotify event queue overflowed, scheduling a full rescan");
+                ++stats.overflows;
+                fullRescanPending = true;
+            } else if (event->mask & IN_IGNORED) {
+                watchPaths.erase(event->wd);
+                watchCount = watchPaths.size();
+                continue;
+            } else {
+                const auto watched = watchPaths.find(event->wd);
+                if (watched == watchPaths.end() || event->len == 0) {
+                    continue;
+                }
+                const std::filesystem::path path = watched->second / event->name;
+
+                if (event->mask & IN_ISDIR) {
+                    if (event->mask & IN_MOVED_FROM) {
+                        // a moved directory keeps its watches under a stale path; re-added if it reappears
+                        removeWatchTree(path);
+                        continue;
+                    }
+                    // IN_CREATE or IN_MOVED_TO: entries may land before the new watch is in place,
+                    // so the directory itself is organized along with its contents
+                    addWatchTree(path);
+                } else if (!(event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO))) {
+                    // files are organized once written, not when created
+                    continue;
+                }
+                pendingItems.insert(path);
+            }
+
+            const auto now = std::chrono::steady_clock::now();
+            if (batchWasEmpty) {
+                firstPendingEvent = now;
+            }
+            lastEvent = now;
+        }
+    }
+}
+
+void DirectoryWatcher::flushPending() {
+    ++stats.batchesProcessed;
+
+    if (fullRescanPending) {
+        // the full pass covers everything that was pending as well
+        fullRescanPending = false;
+        pendingItems.clear();
+        organizer.scanAndOrganize();
+        ++stats.fullRescans;
+        return;
+    }
+
+    const std::vector<std::filesystem::path> items(pendingItems.begin(), pendingItems.end());
+    pendingItems.clear();
+    Logger::instance().debug(std::format("Organizing {} changed items", items.size()));
+    organizer.organizeItems(items);
+    stats.itemsOrganized += items.size();
+}
+
+void DirectoryWatcher::rescanUnwatched() {
+    if (unwatchedDirectories.empty()) {
+        return;
+    }
+
+    // watches may have been freed since; whatever still fails stays on the rescan list
+    const std::vector<std::filesystem::path> directories(unwatchedDirectories.begin(), unwatchedDirectories.end());
+    for (const auto& directory : directories) {
+        std::error_code ec;
+        if (!std::filesystem::is_directory(directory, ec)) {
+            unwatchedDirectories.erase(directory);
+            continue;
+        }
+        addWatchTree(directory);
+        organizer.rescanDirectory(directory);
+        ++stats.targetedRescans;
+    }
+}
+
+#else
+
+bool DirectoryWatcher::run() {
+    Logger::instance().error("Watch mode requires inotify and is only available on Linux");
+    return false;
+}
+
+#endif
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <filesystem>
+#include <chrono>
+#include <set>
+#include <unordered_map>
+#include <atomic>
+#include <optional>
+#include "core/DirectoryOrganizer.h"
+
+// Tuning knobs for watch mode
+struct WatchOptions {
+    // quiet period after the last event before a batch of changes is organized
+    std::chrono::milliseconds debounce{250};
+    // how often directories that could not be watched are rescanned
+    std::chrono::seconds rescanInterval{60};
+};
+
+// Keeps a source tree organized by reacting to inotify events instead of rescanning it.
+// Bursts of IN_CLOSE_WRITE/IN_MOVED_TO events are coalesced over a debounce window and only
+// the changed entries are passed to DirectoryOrganizer::organizeItems(). A lost event queue
+// (IN_Q_OVERFLOW) triggers one full rescan; directories beyond the inotify watch limit are
+// rescanned periodically on their own.
+class DirectoryWatcher {
+public:
+    struct Statistics {
+        size_t eventsReceived = 0;
+        size_t batchesProcessed = 0;
+        size_t itemsOrganized = 0;
+        size_t overflows = 0;
+        size_t fullRescans = 0;
+        size_t targetedRescans = 0;
+        size_t watchedDirectories = 0;
+        size_t unwatchedDirectories = 0;
+    };
+
+    explicit DirectoryWatcher(DirectoryOrganizer& organizer, WatchOptions watchOptions = {});
+    ~DirectoryWatcher();
+
+    DirectoryWatcher(const DirectoryWatcher&) = delete;
+    DirectoryWatcher& operator=(const DirectoryWatcher&) = delete;
+
+    // Organize the whole tree once, then keep organizing changes until stop() is called.
+    // Returns false if watching is not supported or could not be set up.
+    bool run();
+
+    // Ask run() to return; safe to call from another thread or a signal handler
+    void stop();
+
+    // Number of watches currently registered, safe to poll while run() is active
+    size_t getWatchCount() const { return watchCount; }
+
+    // Valid once run() has returned
+    const Statistics& getStatistics() const { return stats; }
+
+private:
+    DirectoryOrganizer& organizer;
+    WatchOptions options;
+    Statistics stats;
+    std::optional<std::filesystem::path> targetInSource;
+
+    int inotifyFd = -1;
+    int stopFd = -1;
+    std::atomic<bool> stopRequested{false};
+    std::atomic<size_t> watchCount{0};
+
+    std::unordered_map<int, std::filesystem::path> watchPaths;
+    // directories refused by the kernel, typically because fs.inotify.max_user_watches was hit
+    std::set<std::filesystem::path> unwatchedDirectories;
+
+    // changed items waiting for the debounce window to close
+    std::set<std::filesystem::path> pendingItems;
+    bool fullRescanPending = false;
+    std::chrono::steady_clock::time_point firstPendingEvent;
+    std::chrono::steady_clock::time_point lastEvent;
+
+    void addWatchTree(const std::filesystem::path& root);
+    bool addWatch(const std::filesystem::path& directory);
+    void removeWatchTree(const std::filesystem::path& root);
+    void readEvents();
+    void flushPending();
+    void rescanUnwatched();
+};
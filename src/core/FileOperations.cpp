@@ -0,0 +1,506 @@
+#include "core/FileOperations.h"
+#include <atomic>
+#include <algorithm>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/resource.h>
+#include <climits>
+#include <cerrno>
+#endif
+
+#if defined(__linux__)
+#include <sys/syscall.h>
+#include <sys/sendfile.h>
+#include <linux/fs.h>
+#endif
+
+namespace {
+
+// set once the kernel turned out to lack renameat2 so later moves skip straight to the fallback
+std::atomic<bool> renameNoReplaceUnavailable{false};
+
+#if defined(__unix__) || defined(__APPLE__)
+
+std::error_code lastError() {
+    return {errno, std::generic_category()};
+}
+
+// Closes a descriptor when the copy of one file is done, successful or not
+class FileDescriptor {
+public:
+    explicit FileDescriptor(const int fd) : fd(fd) {}
+    ~FileDescriptor() {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+    FileDescriptor(const FileDescriptor&) = delete;
+    FileDescriptor& operator=(const FileDescriptor&) = delete;
+
+    int get() const { return fd; }
+
+private:
+    int fd;
+};
+
+struct ByteRange {
+    off_t offset;
+    off_t length;
+};
+
+// The parts of a file that hold data, so holes in sparse files stay holes in the copy.
+// Filesystems without SEEK_DATA report the whole file as one range.
+std::vector<ByteRange> findDataRanges(const int fd, const off_t size) {
+    std::vector<ByteRange> ranges;
+#if defined(SEEK_DATA) && defined(SEEK_HOLE)
+    off_t position = 0;
+    while (position < size) {
+        const off_t dataStart = ::lseek(fd, position, SEEK_DATA);
+        if (dataStart < 0) {
+            if (errno == ENXIO) {
+                return ranges;  // only a hole is left
+            }
+            ranges.clear();
+            break;
+        }
+        off_t dataEnd = ::lseek(fd, dataStart, SEEK_HOLE);
+        if (dataEnd < 0) {
+            dataEnd = size;
+        }
+        ranges.push_back({dataStart, std::min(dataEnd, size) - dataStart});
+        position = dataEnd;
+    }
+    if (position >= size) {
+        return ranges;
+    }
+#endif
+    ranges.assign(1, ByteRange{0, size});
+    return ranges;
+}
+
+bool isCopyUnsupported(const int error) {
+    return error == EXDEV || error == EINVAL || error == ENOSYS || error == EOPNOTSUPP || error == EBADF;
+}
+
+// Copy one range at the same offsets. copy_file_range keeps the data in the kernel (and may
+// reflink it); sendfile still avoids user space where that isn't available across these
+// filesystems; pread/pwrite is the portable last resort. output is private to the caller,
+// since sendfile writes at its file position.
+std::error_code copyRange(const int input, const int output, const off_t offset, const off_t length) {
+    off_t done = 0;
+#if defined(__linux__)
+    bool copyFileRange = true;
+    bool sendFile = true;
+#endif
+    while (done < length) {
+        const size_t wanted = static_cast<size_t>(length - done);
+        ssize_t copied = -1;
+#if defined(__linux__)
+        if (copyFileRange) {
+            off_t inputOffset = offset + done;
+            off_t outputOffset = offset + done;
+            copied = ::copy_file_range(input, &inputOffset, output, &outputOffset, wanted, 0);
+            if (copied < 0 && isCopyUnsupported(errno) && done == 0) {
+                copyFileRange = false;
+                continue;
+            }
+        } else if (sendFile) {
+            off_t inputOffset = offset + done;
+            if (::lseek(output, offset + done, SEEK_SET) < 0) {
+                return lastError();
+            }
+            copied = ::sendfile(output, input, &inputOffset, wanted);
+            if (copied < 0 && isCopyUnsupported(errno) && done == 0) {
+                sendFile = false;
+                continue;
+            }
+        } else
+#endif
+        {
+            char buffer[1 << 16];
+            copied = ::pread(input, buffer, std::min(wanted, sizeof(buffer)), offset + done);
+            for (ssize_t written = 0; copied > 0 && written < copied;) {
+                const ssize_t result = ::pwrite(output, buffer + written, static_cast<size_t>(copied - written),
+                                                offset + done + written);
+                if (result < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+                    return lastError();
+                }
+                written += result;
+            }
+        }
+        if (copied < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return lastError();
+        }
+        if (copied == 0) {
+            return std::make_error_code(std::errc::io_error);  // source shrank under us
+        }
+        done += copied;
+    }
+    return {};
+}
+
+// Tell onCreated, if there is one, about the entry just created at target; false if the
+// caller abandons the move
+bool reportCreated(const CopyCreated* onCreated, const struct stat& created) {
+    return !onCreated || !*onCreated || (*onCreated)(static_cast<std::uint64_t>(created.st_dev),
+                                                     static_cast<std::uint64_t>(created.st_ino));
+}
+
+std::error_code copyTimes(const int fd, const struct stat& status) {
+#if defined(__APPLE__)
+    const timespec times[2] = {status.st_atimespec, status.st_mtimespec};
+#else
+    const timespec times[2] = {status.st_atim, status.st_mtim};
+#endif
+    return ::futimens(fd, times) == 0 ? std::error_code{} : lastError();
+}
+
+// Copy a regular file to a new file at target, leaving nothing behind on failure
+std::error_code copyFile(const std::filesystem::path& source, const std::filesystem::path& target,
+                         const struct stat& status, const CrossDeviceOptions& options, std::uintmax_t& bytesCopied,
+                         const CopyCreated* onCreated) {
+    const FileDescriptor input(::open(source.c_str(), O_RDONLY | O_CLOEXEC));
+    if (input.get() < 0) {
+        return lastError();
+    }
+    const FileDescriptor output(::open(target.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, S_IRUSR | S_IWUSR));
+    if (output.get() < 0) {
+        return lastError();
+    }
+
+    auto fail = [&](const std::error_code ec) {
+        ::unlink(target.c_str());
+        return ec;
+    };
+    
+    struct stat created {};
+    if (::fstat(output.get(), &created) != 0) {
+        return fail(lastError());
+    }
+    if (!reportCreated(onCreated, created)) {
+        return fail(std::make_error_code(std::errc::operation_canceled));
+    }
+
+    // sized up front so holes between the copied ranges stay unallocated
+    if (::ftruncate(output.get(), status.st_size) != 0) {
+        return fail(lastError());
+    }
+
+    // cut data ranges into chunks that workers take in turn
+    std::vector<ByteRange> chunks;
+    const off_t chunkSize = static_cast<off_t>(std::max<std::uintmax_t>(options.chunkSize, 1 << 20));
+    for (const ByteRange& range : findDataRanges(input.get(), status.st_size)) {
+        for (off_t offset = 0; offset < range.length; offset += chunkSize) {
+            chunks.push_back({range.offset + offset, std::min(chunkSize, range.length - offset)});
+        }
+    }
+
+    std::atomic<size_t> nextChunk{0};
+    std::atomic<std::uintmax_t> copied{0};
+    std::atomic<int> firstError{0};
+    auto worker = [&](const int outputFd) {
+        for (size_t i = nextChunk++; i < chunks.size() && firstError.load() == 0; i = nextChunk++) {
+            if (const std::error_code ec = copyRange(input.get(), outputFd, chunks[i].offset, chunks[i].length)) {
+                int expected = 0;
+                firstError.compare_exchange_strong(expected, ec.value());
+                return;
+            }
+            copied += static_cast<std::uintmax_t>(chunks[i].length);
+        }
+    };
+
+    const size_t threadCount = static_cast<std::uintmax_t>(status.st_size) >= options.parallelThreshold
+        ? std::min(std::max<size_t>(options.threads, 1), chunks.size())
+        : 1;
+    if (threadCount <= 1) {
+        worker(output.get());
+    } else {
+        std::vector<std::jthread> helpers;
+        for (size_t i = 1; i < threadCount; ++i) {
+            helpers.emplace_back([&] {
+                // each worker writes through its own descriptor, see copyRange()
+                const FileDescriptor helperOutput(::open(target.c_str(), O_WRONLY | O_CLOEXEC));
+                if (helperOutput.get() < 0) {
+                    int expected = 0;
+                    firstError.compare_exchange_strong(expected, errno);
+                    return;
+                }
+                worker(helperOutput.get());
+            });
+        }
+        worker(output.get());
+    }
+    if (firstError.load() != 0) {
+        return fail({firstError.load(), std::generic_category()});
+    }
+
+    if (::fchmod(output.get(), status.st_mode & 07777) != 0) {
+        return fail(lastError());
+    }
+    if (const std::error_code ec = copyTimes(output.get(), status)) {
+        return fail(ec);
+    }
+    if (options.fsync && ::fsync(output.get()) != 0) {
+        return fail(lastError());
+    }
+    bytesCopied += copied.load();
+    return {};
+}
+
+// Copy source (of any type) to a new entry at target, leaving nothing behind on failure;
+// onCreated only hears about the top-level entry
+std::error_code copyEntry(const std::filesystem::path& source, const std::filesystem::path& target,
+                          const CrossDeviceOptions& options, std::uintmax_t& bytesCopied,
+                          const CopyCreated* onCreated = nullptr);
+
+// Fill the freshly created directory target with copies of source's entries
+std::error_code copyDirectoryContents(const std::filesystem::path& source, const std::filesystem::path& target,
+                                      const struct stat& status, const CrossDeviceOptions& options,
+                                      std::uintmax_t& bytesCopied) {
+    std::error_code ec;
+    for (std::filesystem::directory_iterator it(source, ec), end; !ec && it != end; it.increment(ec)) {
+        if (const std::error_code childError = copyEntry(it->path(), target / it->path().filename(), options, bytesCopied)) {
+            return childError;
+        }
+    }
+    if (ec) {
+        return ec;
+    }
+
+    // after the children, which would have bumped the mtime
+    const FileDescriptor directory(::open(target.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC));
+    if (directory.get() < 0) {
+        return lastError();
+    }
+    if (::fchmod(directory.get(), status.st_mode & 07777) != 0) {
+        return lastError();
+    }
+    if (const std::error_code timeError = copyTimes(directory.get(), status)) {
+        return timeError;
+    }
+    if (options.fsync && ::fsync(directory.get()) != 0) {
+        return lastError();
+    }
+    return {};
+}
+
+std::error_code copyEntry(const std::filesystem::path& source, const std::filesystem::path& target,
+                          const CrossDeviceOptions& options, std::uintmax_t& bytesCopied,
+                          const CopyCreated* onCreated) {
+    struct stat status {};
+    if (::lstat(source.c_str(), &status) != 0) {
+        return lastError();
+    }
+
+    if (S_ISREG(status.st_mode)) {
+        return copyFile(source, target, status, options, bytesCopied, onCreated);
+    }
+    
+    struct stat created {};
+    // discard takes the new entry away again if the move is abandoned
+    const auto report = [&](int (*discard)(const char*)) -> std::error_code {
+        if (::lstat(target.c_str(), &created) != 0) {
+            const std::error_code ec = lastError();
+            discard(target.c_str());
+            return ec;
+        }
+        if (!reportCreated(onCreated, created)) {
+            discard(target.c_str());
+            return std::make_error_code(std::errc::operation_canceled);
+        }
+        return {};
+    };
+
+    if (S_ISLNK(status.st_mode)) {
+        std::error_code ec;
+        const std::filesystem::path linkTarget = std::filesystem::read_symlink(source, ec);
+        if (ec) {
+            return ec;
+        }
+        if (::symlink(linkTarget.c_str(), target.c_str()) != 0) {
+            return lastError();
+        }
+        return report(::unlink);
+    }
+
+    if (!S_ISDIR(status.st_mode)) {
+        return std::make_error_code(std::errc::operation_not_supported);  // devices, fifos, sockets
+    }
+
+    if (::mkdir(target.c_str(), S_IRWXU) != 0) {
+        return lastError();
+    }
+    if (const std::error_code ec = report(::rmdir)) {
+        return ec;
+    }
+    if (const std::error_code ec = copyDirectoryContents(source, target, status, options, bytesCopied)) {
+        std::error_code ignored;
+        std::filesystem::remove_all(target, ignored);
+        return ec;
+    }
+    return {};
+}
+
+#endif
+
+} // namespace
+
+DirectoryHandle::DirectoryHandle(const std::filesystem::path& directory, const Access access) : path(directory) {
+#if defined(__linux__)
+    fd = ::open(directory.c_str(), (access == Access::Path ? O_PATH : O_RDONLY) | O_DIRECTORY | O_CLOEXEC);
+#elif defined(__unix__) || defined(__APPLE__)
+    (void)access;
+    fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+#else
+    (void)access;
+#endif
+}
+
+DirectoryHandle::DirectoryHandle(const DirectoryHandle& parent, const std::string& name, const Access access)
+    : path(parent.getPath() / name) {
+#if defined(__unix__) || defined(__APPLE__)
+    int flags = O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC;
+#if defined(__linux__)
+    if (access == Access::Path) {
+        flags = O_PATH | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC;
+    }
+#else
+    (void)access;
+#endif
+    fd = parent.isValid() ? ::openat(parent.getFd(), name.c_str(), flags) : ::open(path.c_str(), flags);
+#else
+    (void)access;
+#endif
+}
+
+DirectoryHandle::~DirectoryHandle() {
+#if defined(__unix__) || defined(__APPLE__)
+    if (fd >= 0) {
+        ::close(fd);
+    }
+#endif
+}
+
+namespace {
+
+std::error_code renameNoReplaceAt(const int sourceFd, const char* sourceName, const DirectoryHandle& targetDirectory,
+                                  const std::string& name) {
+#if defined(__linux__) && defined(SYS_renameat2) && defined(RENAME_NOREPLACE)
+    if (!targetDirectory.isValid() || renameNoReplaceUnavailable.load(std::memory_order_relaxed)) {
+        return std::make_error_code(std::errc::operation_not_supported);
+    }
+    if (::syscall(SYS_renameat2, sourceFd, sourceName, targetDirectory.getFd(), name.c_str(), RENAME_NOREPLACE) == 0) {
+        return {};
+    }
+    const int error = errno;
+    if (error == ENOSYS) {
+        renameNoReplaceUnavailable = true;
+    }
+    // EINVAL: this filesystem doesn't implement the flag
+    if (error == ENOSYS || error == EINVAL) {
+        return std::make_error_code(std::errc::operation_not_supported);
+    }
+    return {error, std::generic_category()};
+#else
+    (void)sourceFd;
+    (void)sourceName;
+    (void)targetDirectory;
+    (void)name;
+    return std::make_error_code(std::errc::operation_not_supported);
+#endif
+}
+
+} // namespace
+
+std::error_code renameNoReplace(const std::filesystem::path& source, const DirectoryHandle& targetDirectory,
+                                const std::string& name) {
+#if defined(__unix__) || defined(__APPLE__)
+    return renameNoReplaceAt(AT_FDCWD, source.c_str(), targetDirectory, name);
+#else
+    return renameNoReplaceAt(-1, nullptr, targetDirectory, name);
+#endif
+}
+
+std::error_code renameNoReplace(const DirectoryHandle& sourceDirectory, const std::string& sourceName,
+                                const DirectoryHandle& targetDirectory, const std::string& name) {
+    if (!sourceDirectory.isValid()) {
+        return renameNoReplace(sourceDirectory.getPath() / sourceName, targetDirectory, name);
+    }
+    return renameNoReplaceAt(sourceDirectory.getFd(), sourceName.c_str(), targetDirectory, name);
+}
+
+void raiseOpenFileLimit() {
+#if defined(__unix__) || defined(__APPLE__)
+    static std::once_flag raised;
+    std::call_once(raised, [] {
+        struct rlimit limit {};
+        if (::getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+            limit.rlim_cur = limit.rlim_max;
+#if defined(__APPLE__)
+            // macOS rejects anything above OPEN_MAX for the soft limit
+            limit.rlim_cur = std::min<rlim_t>(limit.rlim_cur, OPEN_MAX);
+#endif
+            ::setrlimit(RLIMIT_NOFILE, &limit);
+        }
+    });
+#endif
+}
+
+CrossDeviceResult moveAcrossDevices(const std::filesystem::path& source, const std::filesystem::path& target,
+                                    const CrossDeviceOptions& options, const CopyCreated& onCreated) {
+    CrossDeviceResult result;
+#if defined(__unix__) || defined(__APPLE__)
+    struct stat status {};
+    if (::lstat(source.c_str(), &status) != 0) {
+        result.error = lastError();
+        return result;
+    }
+
+    result.error = copyEntry(source, target, options, result.bytesCopied, &onCreated);
+    if (result.error) {
+        result.bytesCopied = 0;
+        return result;
+    }
+
+    if (options.fsync) {
+        // make the new entry itself durable before the only other copy goes away
+        const FileDescriptor parent(::open(target.parent_path().c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC));
+        if (parent.get() >= 0) {
+            ::fsync(parent.get());
+        }
+    }
+
+    // the copy is complete; if the source can't be removed, both stay and the error is reported
+    if (S_ISDIR(status.st_mode)) {
+        std::filesystem::remove_all(source, result.error);
+    } else if (::unlink(source.c_str()) != 0) {
+        result.error = lastError();
+    }
+#else
+    // no identities to report here: recovery leaves a copy cut short where it is
+    (void)options;
+    (void)onCreated;
+    std::error_code ec;
+    if (std::filesystem::exists(std::filesystem::symlink_status(target, ec))) {
+        result.error = std::make_error_code(std::errc::file_exists);
+        return result;
+    }
+    std::filesystem::copy(source, target, std::filesystem::copy_options::recursive | std::filesystem::copy_options::copy_symlinks, result.error);
+    if (!result.error) {
+        std::filesystem::remove_all(source, result.error);
+    }
+#endif
+    return result;
+}
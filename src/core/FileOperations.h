@@ -0,0 +1,75 @@
+#pragma once
+
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <system_error>
+#include <cstdint>
+#include <cstddef>
+
+// Owning handle to an open directory, used as the base of *at() system calls so that
+// operations inside it don't resolve the directory's path again
+class DirectoryHandle {
+public:
+    // Path handles only serve as the base of *at() calls; listable ones can also be read with
+    // fdopendir(), which the directory walker needs
+    enum class Access { Path, List };
+
+    // An invalid handle if the directory can't be opened (or on platforms without *at() calls)
+    explicit DirectoryHandle(const std::filesystem::path& directory, Access access = Access::Path);
+    // Open the subdirectory name of parent relative to parent's descriptor, never following a
+    // symlink; the path is only composed for logging and path-based fallbacks
+    DirectoryHandle(const DirectoryHandle& parent, const std::string& name, Access access = Access::Path);
+    ~DirectoryHandle();
+
+    DirectoryHandle(const DirectoryHandle&) = delete;
+    DirectoryHandle& operator=(const DirectoryHandle&) = delete;
+
+    bool isValid() const { return fd >= 0; }
+    int getFd() const { return fd; }
+    const std::filesystem::path& getPath() const { return path; }
+
+private:
+    std::filesystem::path path;
+    int fd = -1;
+};
+
+// Move source to name inside targetDirectory, never replacing an existing entry, in a single
+// renameat2(RENAME_NOREPLACE) call. Returns std::errc::file_exists if the name is taken and
+// std::errc::operation_not_supported if the kernel or filesystem lacks RENAME_NOREPLACE, in
+// which case the caller has to fall back to a checked rename.
+std::error_code renameNoReplace(const std::filesystem::path& source, const DirectoryHandle& targetDirectory,
+                                const std::string& name);
+// Same, with the source named relative to the open directory it is in
+std::error_code renameNoReplace(const DirectoryHandle& sourceDirectory, const std::string& sourceName,
+                                const DirectoryHandle& targetDirectory, const std::string& name);
+
+// Raise the soft limit on open descriptors to the hard limit, once per process. Walking a tree
+// with directory handles keeps a descriptor open for every directory with work in flight.
+void raiseOpenFileLimit();
+
+// Tuning for moves between filesystems
+struct CrossDeviceOptions {
+    bool fsync = false;  // flush copied files to disk before the source is removed
+    size_t threads = 4;  // workers sharing the chunks of one large file
+    std::uintmax_t parallelThreshold = 64ull << 20;  // files smaller than this are copied by one thread
+    std::uintmax_t chunkSize = 16ull << 20;
+};
+
+struct CrossDeviceResult {
+    std::error_code error;
+    std::uintmax_t bytesCopied = 0;
+};
+
+// Called with the device and inode of the entry a cross-device move just created at its
+// target, before anything is copied into it, so that the caller can record which item is its
+// copy. Returning false abandons the move: the entry is removed and the source left alone.
+using CopyCreated = std::function<bool(std::uint64_t device, std::uint64_t inode)>;
+
+// Move source (file, directory tree or symlink) to target on another filesystem, where
+// rename() fails with EXDEV. Data is copied in-kernel with copy_file_range (sendfile or
+// read/write where unsupported), sparse holes are kept, mode and mtime are preserved, and
+// the source is removed only once everything was copied. Never replaces an existing target:
+// returns std::errc::file_exists and leaves the source alone in that case.
+CrossDeviceResult moveAcrossDevices(const std::filesystem::path& source, const std::filesystem::path& target,
+                                    const CrossDeviceOptions& options, const CopyCreated& onCreated = {});
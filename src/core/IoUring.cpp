@@ -0,0 +1,271 @@
+#include "core/IoUring.h"
+#include "Logger.h"
+#include <atomic>
+#include <algorithm>
+#include <format>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define FILE_ORGANIZER_HAS_IO_URING 1
+#include <linux/io_uring.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+#if defined(FILE_ORGANIZER_HAS_IO_URING)
+
+namespace {
+
+int ioUringSetup(const unsigned entries, io_uring_params* params) {
+    return static_cast<int>(::syscall(__NR_io_uring_setup, entries, params));
+}
+
+int ioUringEnter(const int fd, const unsigned toSubmit, const unsigned minComplete, const unsigned flags) {
+    return static_cast<int>(::syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, nullptr, 0));
+}
+
+int ioUringRegister(const int fd, const unsigned opcode, void* argument, const unsigned count) {
+    return static_cast<int>(::syscall(__NR_io_uring_register, fd, opcode, argument, count));
+}
+
+// the ring indices are shared with the kernel
+unsigned loadAcquire(unsigned* value) {
+    return std::atomic_ref<unsigned>(*value).load(std::memory_order_acquire);
+}
+
+void storeRelease(unsigned* value, const unsigned newValue) {
+    std::atomic_ref<unsigned>(*value).store(newValue, std::memory_order_release);
+}
+
+template<typename T>
+T* at(void* base, const unsigned offset) {
+    return reinterpret_cast<T*>(static_cast<char*>(base) + offset);
+}
+
+// Whether the kernel implements every operation the organizer batches
+bool supportsOperations(const int fd) {
+    constexpr unsigned probedOperations = 256;
+    std::vector<char> buffer(sizeof(io_uring_probe) + probedOperations * sizeof(io_uring_probe_op));
+    auto* probe = reinterpret_cast<io_uring_probe*>(buffer.data());
+    if (ioUringRegister(fd, IORING_REGISTER_PROBE, probe, probedOperations) < 0) {
+        return false;
+    }
+    for (const unsigned operation : {IORING_OP_STATX, IORING_OP_MKDIRAT, IORING_OP_RENAMEAT}) {
+        if (operation > probe->last_op || !(probe->ops[operation].flags & IO_URING_OP_SUPPORTED)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+IoUring::IoUring(const unsigned queueDepth) {
+    io_uring_params params{};
+    ringFd = ioUringSetup(queueDepth > 0 ? queueDepth : 1, &params);
+    if (ringFd < 0) {
+        Logger::instance().debug(std::format("io_uring unavailable: {}", std::strerror(errno)));
+        ringFd = -1;
+        return;
+    }
+    if (!supportsOperations(ringFd)) {
+        Logger::instance().debug("io_uring lacks statx, mkdirat or renameat on this kernel");
+        shutdown();
+        return;
+    }
+    // the kernel rounds the depth up to a power of two
+    this->queueDepth = params.sq_entries;
+
+    submissionRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    completionRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    const bool singleMapping = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (singleMapping) {
+        submissionRingSize = std::max(submissionRingSize, completionRingSize);
+    }
+    submissionRing = ::mmap(nullptr, submissionRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                            ringFd, IORING_OFF_SQ_RING);
+    if (submissionRing == MAP_FAILED) {
+        submissionRing = nullptr;
+        shutdown();
+        return;
+    }
+    if (singleMapping) {
+        completionRing = submissionRing;
+        completionRingSize = 0;
+    } else {
+        completionRing = ::mmap(nullptr, completionRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                ringFd, IORING_OFF_CQ_RING);
+        if (completionRing == MAP_FAILED) {
+            completionRing = nullptr;
+            shutdown();
+            return;
+        }
+    }
+    submissionEntriesSize = params.sq_entries * sizeof(io_uring_sqe);
+    submissionEntries = ::mmap(nullptr, submissionEntriesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                               ringFd, IORING_OFF_SQES);
+    if (submissionEntries == MAP_FAILED) {
+        submissionEntries = nullptr;
+        shutdown();
+        return;
+    }
+
+    submissionTail = at<unsigned>(submissionRing, params.sq_off.tail);
+    submissionMask = *at<unsigned>(submissionRing, params.sq_off.ring_mask);
+    completionHead = at<unsigned>(completionRing, params.cq_off.head);
+    completionTail = at<unsigned>(completionRing, params.cq_off.tail);
+    completionMask = *at<unsigned>(completionRing, params.cq_off.ring_mask);
+    completionEntries = at<void>(completionRing, params.cq_off.cqes);
+    localTail = *submissionTail;
+
+    // submission slots map one to one onto entries, set once
+    unsigned* array = at<unsigned>(submissionRing, params.sq_off.array);
+    for (unsigned i = 0; i < params.sq_entries; ++i) {
+        array[i] = i;
+    }
+}
+
+IoUring::~IoUring() {
+    shutdown();
+}
+
+void IoUring::shutdown() {
+    if (submissionEntries) {
+        ::munmap(submissionEntries, submissionEntriesSize);
+        submissionEntries = nullptr;
+    }
+    if (completionRing && completionRing != submissionRing) {
+        ::munmap(completionRing, completionRingSize);
+    }
+    completionRing = nullptr;
+    if (submissionRing) {
+        ::munmap(submissionRing, submissionRingSize);
+        submissionRing = nullptr;
+    }
+    if (ringFd >= 0) {
+        ::close(ringFd);
+        ringFd = -1;
+    }
+    queued = 0;
+}
+
+io_uring_sqe* IoUring::nextEntry(const unsigned char opcode, const int fd, const void* address,
+                                 const unsigned length, const unsigned long long offset) {
+    if (!isAvailable() || queued >= queueDepth) {
+        return nullptr;
+    }
+    auto* entry = static_cast<io_uring_sqe*>(submissionEntries) + (localTail & submissionMask);
+    std::memset(entry, 0, sizeof(*entry));
+    entry->opcode = opcode;
+    entry->fd = fd;
+    entry->addr = reinterpret_cast<unsigned long long>(address);
+    entry->len = length;
+    entry->off = offset;
+    // completions are matched to their operation by queue position
+    entry->user_data = queued++;
+    storeRelease(submissionTail, ++localTail);
+    return entry;
+}
+
+bool IoUring::queueStatx(const int directoryFd, const char* path, const unsigned mask, struct statx* result) {
+    io_uring_sqe* entry = nextEntry(IORING_OP_STATX, directoryFd, path, mask, reinterpret_cast<unsigned long long>(result));
+    if (!entry) {
+        return false;
+    }
+    entry->statx_flags = AT_STATX_SYNC_AS_STAT;
+    return true;
+}
+
+bool IoUring::queueMkdirat(const int directoryFd, const char* path, const unsigned mode) {
+    return nextEntry(IORING_OP_MKDIRAT, directoryFd, path, mode, 0) != nullptr;
+}
+
+bool IoUring::queueRenameat(const int oldDirectoryFd, const char* oldPath, const int newDirectoryFd,
+                            const char* newPath, const unsigned flags) {
+    io_uring_sqe* entry = nextEntry(IORING_OP_RENAMEAT, oldDirectoryFd, oldPath, static_cast<unsigned>(newDirectoryFd),
+                                    reinterpret_cast<unsigned long long>(newPath));
+    if (!entry) {
+        return false;
+    }
+    entry->rename_flags = flags;
+    return true;
+}
+
+std::vector<int> IoUring::submitAndWait() {
+    const size_t batch = queued;
+    std::vector<int> results(batch, -ECANCELED);
+    size_t submitted = 0;
+    size_t completed = 0;
+    while (completed < batch) {
+        // collect whatever has completed so far
+        unsigned head = *completionHead;
+        const unsigned tail = loadAcquire(completionTail);
+        for (; head != tail; ++head) {
+            const auto& completion = static_cast<const io_uring_cqe*>(completionEntries)[head & completionMask];
+            if (completion.user_data < batch) {
+                results[completion.user_data] = completion.res;
+            }
+            ++completed;
+        }
+        storeRelease(completionHead, head);
+        if (completed >= batch) {
+            break;
+        }
+
+        const int entered = ioUringEnter(ringFd, static_cast<unsigned>(batch - submitted), 1, IORING_ENTER_GETEVENTS);
+        if (entered > 0 || (entered == 0 && submitted > completed)) {
+            submitted += static_cast<size_t>(entered);
+            continue;
+        }
+        if (entered < 0 && errno == EINTR) {
+            continue;
+        }
+        if (submitted > completed) {
+            // can't submit more right now; wait for the operations in flight, then retry
+            ioUringEnter(ringFd, 0, 1, IORING_ENTER_GETEVENTS);
+            continue;
+        }
+        // nothing in flight and nothing accepted: give up on the ring, callers fall back
+        Logger::instance().warning(std::format("io_uring submission failed ({}), using synchronous system calls",
+                                               entered < 0 ? std::strerror(errno) : "no progress"));
+        shutdown();
+        break;
+    }
+    queued = 0;
+    return results;
+}
+
+#else
+
+IoUring::IoUring(const unsigned) {
+}
+
+IoUring::~IoUring() = default;
+
+void IoUring::shutdown() {
+}
+
+io_uring_sqe* IoUring::nextEntry(unsigned char, int, const void*, unsigned, unsigned long long) {
+    return nullptr;
+}
+
+bool IoUring::queueStatx(int, const char*, unsigned, struct statx*) {
+    return false;
+}
+
+bool IoUring::queueMkdirat(int, const char*, unsigned) {
+    return false;
+}
+
+bool IoUring::queueRenameat(int, const char*, int, const char*, unsigned) {
+    return false;
+}
+
+std::vector<int> IoUring::submitAndWait() {
+    return {};
+}
+
+#endif
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+struct statx;
+struct io_uring_sqe;
+
+// Minimal io_uring submission/completion ring for batching metadata and rename system calls,
+// talking to the kernel directly so no liburing is needed. Operations are queued, then
+// submitAndWait() submits the whole batch with one io_uring_enter() and collects every
+// completion, so the kernel can overlap the calls instead of the caller paying for each in turn.
+//
+// Not thread-safe: each thread that batches calls owns its own ring. isAvailable() is false
+// where io_uring or one of the needed operations is missing (non-Linux, kernels before 5.11,
+// seccomp filters); callers then issue the calls synchronously.
+class IoUring {
+public:
+    explicit IoUring(unsigned queueDepth);
+    ~IoUring();
+
+    IoUring(const IoUring&) = delete;
+    IoUring& operator=(const IoUring&) = delete;
+
+    bool isAvailable() const { return ringFd >= 0; }
+    // Operations that fit in one batch
+    unsigned getQueueDepth() const { return queueDepth; }
+    size_t getQueuedCount() const { return queued; }
+
+    // Queue an operation. Paths and buffers must stay valid until submitAndWait() returns.
+    // Return false when the ring is unavailable or the batch is full.
+    bool queueStatx(int directoryFd, const char* path, unsigned mask, struct statx* result);
+    bool queueMkdirat(int directoryFd, const char* path, unsigned mode);
+    bool queueRenameat(int oldDirectoryFd, const char* oldPath, int newDirectoryFd, const char* newPath,
+                       unsigned flags);
+
+    // Submit the queued operations and wait for all of them. Element i is the result of the
+    // i-th queued operation: 0 on success or a negative errno.
+    std::vector<int> submitAndWait();
+
+private:
+    int ringFd = -1;
+    unsigned queueDepth = 0;
+    size_t queued = 0;
+
+    // shared ring memory
+    void* submissionRing = nullptr;
+    size_t submissionRingSize = 0;
+    void* completionRing = nullptr;
+    size_t completionRingSize = 0;
+    void* submissionEntries = nullptr;
+    size_t submissionEntriesSize = 0;
+
+    unsigned* submissionTail = nullptr;
+    unsigned submissionMask = 0;
+    unsigned* completionHead = nullptr;
+    unsigned* completionTail = nullptr;
+    unsigned completionMask = 0;
+    void* completionEntries = nullptr;
+    unsigned localTail = 0;
+
+    io_uring_sqe* nextEntry(unsigned char opcode, int fd, const void* address, unsigned length, unsigned long long offset);
+    void shutdown();
+};
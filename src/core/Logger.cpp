@@ -1,8 +1,8 @@
 #include "core/Logger.h"
 #include <iostream>
 #include <chrono>
-#include <iomanip>
-#include <sstream>
+#include <ctime>
+#include <format>
 
 Logger& Logger::instance() {
     static Logger instance;
@@ -10,12 +10,14 @@ Logger& Logger::instance() {
 }
 
 Logger::~Logger() {
+    stopAsync();
     if (logFile.is_open()) {
         logFile.close();
     }
 }
 
 void Logger::init(const LogLevel level, const std::string& logFilePath) {
+    stopAsync();
     std::lock_guard lock(logMutex);
     currentLevel = level;
     this->logFilePath = logFilePath;
@@ -26,7 +28,7 @@ void Logger::init(const LogLevel level, const std::string& logFilePath) {
         }
     }
 
-    initialized = true;
+    initialized.store(true, std::memory_order_release);
 
     // log initialization without calling log() to avoid deadlock
     const std::string initMessage = "[" + getCurrentTimestamp() + "] [INFO] Logger initialized with level: " + levelToString(level);
@@ -37,14 +39,19 @@ void Logger::init(const LogLevel level, const std::string& logFilePath) {
 }
 
 void Logger::log(LogLevel level, const std::string& message) {
-    if (!initialized) {
+    if (!initialized.load(std::memory_order_acquire)) {
         init(LogLevel::INFO);  // initialize with default settings
     }
 
-    if (static_cast<int>(level) < static_cast<int>(currentLevel)) {
+    if (static_cast<int>(level) < static_cast<int>(currentLevel.load(std::memory_order_relaxed))) {
         return;  // skip logging if level is below current threshold
     }
 
+    if (asyncActive.load(std::memory_order_acquire)) {
+        enqueue(level, message);
+        return;
+    }
+
     std::lock_guard lock(logMutex);
 
     const std::string timestamp = getCurrentTimestamp();
@@ -60,8 +67,7 @@ void Logger::log(LogLevel level, const std::string& message) {
 }
 
 void Logger::setLogLevel(const LogLevel level) {
-    std::lock_guard lock(logMutex);
-    currentLevel = level;
+    currentLevel.store(level, std::memory_order_relaxed);
 }
 
 void Logger::debug(const std::string& message) {
@@ -81,6 +87,7 @@ void Logger::error(const std::string& message) {
 }
 
 void Logger::reset() {
+    stopAsync();
     std::lock_guard lock(logMutex);
     if (logFile.is_open()) {
         logFile.close();
@@ -90,6 +97,168 @@ void Logger::reset() {
     logFilePath = "";
 }
 
+void Logger::startAsync(const AsyncLogOptions& options) {
+    stopAsync();
+    if (!initialized.load(std::memory_order_acquire)) {
+        init(LogLevel::INFO);
+    }
+    asyncOptions = options;
+    asyncRing = std::make_unique<MpscRingBuffer<Record>>(options.queueCapacity);
+    stopping = false;
+    messagesQueued = 0;
+    messagesFlushed = 0;
+    droppedUnreported = 0;
+    droppedTotal = 0;
+    writerThread = std::thread([this] { writerLoop(); });
+    asyncActive.store(true, std::memory_order_release);
+}
+
+void Logger::stopAsync() {
+    if (!asyncActive.exchange(false, std::memory_order_acq_rel)) {
+        return;
+    }
+    stopping = true;
+    wakeups.fetch_add(1);
+    wakeups.notify_one();
+    writerThread.join();
+    asyncRing.reset();
+}
+
+void Logger::flush() {
+    if (!asyncActive.load(std::memory_order_acquire)) {
+        std::lock_guard lock(logMutex);
+        std::cout.flush();
+        if (logFile.is_open()) {
+            logFile.flush();
+        }
+        return;
+    }
+    const size_t target = messagesQueued.load();
+    while (messagesFlushed.load() < target) {
+        wakeWriter();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+void Logger::enqueue(const LogLevel level, const std::string& message) {
+    Record record{level, std::chrono::system_clock::now(), message};
+    while (!asyncRing->tryPush(std::move(record))) {
+        if (asyncOptions.overflow == LogOverflow::Drop) {
+            droppedUnreported.fetch_add(1, std::memory_order_relaxed);
+            droppedTotal.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        // full: make sure the writer is draining and give it the CPU
+        wakeWriter();
+        std::this_thread::yield();
+    }
+    messagesQueued.fetch_add(1);
+    wakeWriter();
+}
+
+void Logger::wakeWriter() {
+    // pairs with the writer's store of writerSleeping and re-check of the ring: either the
+    // writer sees the new message or this thread sees that it has to wake it
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (writerSleeping.load()) {
+        wakeups.fetch_add(1);
+        wakeups.notify_one();
+    }
+}
+
+void Logger::writerLoop() {
+    std::string outBatch;
+    std::string errBatch;
+    std::string fileBatch;
+    // seconds repeat across thousands of messages, so the formatted timestamp is reused
+    std::time_t cachedSecond = -1;
+    std::string cachedTimestamp;
+    size_t written = 0;
+    auto lastFlush = std::chrono::steady_clock::now();
+
+    const auto append = [&](const LogLevel level, const std::chrono::system_clock::time_point time,
+                            const std::string& message) {
+        const std::time_t second = std::chrono::system_clock::to_time_t(time);
+        if (second != cachedSecond) {
+            cachedSecond = second;
+            cachedTimestamp = formatTimestamp(time);
+        }
+        std::string& console = level == LogLevel::ERROR || level == LogLevel::WARNING ? errBatch : outBatch;
+        const size_t start = console.size();
+        console += '[';
+        console += cachedTimestamp;
+        console += "] [";
+        console += levelToString(level);
+        console += "] ";
+        console += message;
+        console += '\n';
+        if (logFile.is_open()) {
+            fileBatch.append(console, start);
+        }
+    };
+    const auto writeBatches = [&](const bool flushStreams) {
+        if (const size_t dropped = droppedUnreported.exchange(0, std::memory_order_relaxed); dropped > 0) {
+            append(LogLevel::WARNING, std::chrono::system_clock::now(),
+                   std::format("{} log messages dropped, the log queue was full", dropped));
+        }
+        if (!outBatch.empty()) {
+            std::cout.write(outBatch.data(), static_cast<std::streamsize>(outBatch.size()));
+            outBatch.clear();
+        }
+        if (!errBatch.empty()) {
+            std::cerr.write(errBatch.data(), static_cast<std::streamsize>(errBatch.size()));
+            errBatch.clear();
+        }
+        if (!fileBatch.empty()) {
+            logFile.write(fileBatch.data(), static_cast<std::streamsize>(fileBatch.size()));
+            fileBatch.clear();
+        }
+        if (flushStreams) {
+            std::cout.flush();
+            if (logFile.is_open()) {
+                logFile.flush();
+            }
+            lastFlush = std::chrono::steady_clock::now();
+            messagesFlushed.store(written);
+        }
+    };
+
+    while (true) {
+        size_t drained = 0;
+        while (auto record = asyncRing->tryPop()) {
+            append(record->level, record->time, record->message);
+            ++written;
+            // bounded batches keep memory flat under a flood of messages
+            if (++drained >= asyncRing->getCapacity()) {
+                break;
+            }
+        }
+        if (drained > 0) {
+            writeBatches(std::chrono::steady_clock::now() - lastFlush >= asyncOptions.flushInterval);
+            continue;
+        }
+
+        writeBatches(true);
+        if (stopping.load()) {
+            return;
+        }
+        // announce the sleep, then look once more so a message pushed meanwhile isn't missed
+        const std::uint32_t seen = wakeups.load();
+        writerSleeping.store(true);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (auto record = asyncRing->tryPop()) {
+            writerSleeping.store(false);
+            append(record->level, record->time, record->message);
+            ++written;
+            continue;
+        }
+        if (!stopping.load()) {
+            wakeups.wait(seen);
+        }
+        writerSleeping.store(false);
+    }
+}
+
 std::string Logger::levelToString(const LogLevel level) {
     switch (level) {
         case LogLevel::DEBUG: return "DEBUG";
@@ -101,12 +270,20 @@ std::string Logger::levelToString(const LogLevel level) {
 }
 
 std::string Logger::getCurrentTimestamp() {
-    const auto now = std::chrono::system_clock::now();
-    const auto time_t = std::chrono::system_clock::to_time_t(now);
-    
-    std::ostringstream oss;
-    oss << std::put_time(std::localtime(&time_t), "%Y-%m-%d %H:%M:%S");
-    return oss.str();
+    return formatTimestamp(std::chrono::system_clock::now());
+}
+
+std::string Logger::formatTimestamp(const std::chrono::system_clock::time_point time) {
+    const std::time_t seconds = std::chrono::system_clock::to_time_t(time);
+    std::tm local{};
+#if defined(_WIN32)
+    localtime_s(&local, &seconds);
+#else
+    localtime_r(&seconds, &local);
+#endif
+    char buffer[32];
+    const size_t length = std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &local);
+    return {buffer, length};
 }
 
 void Logger::writeToConsole(const LogLevel level, const std::string& formattedMessage) {
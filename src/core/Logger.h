@@ -3,7 +3,16 @@
 #include <string>
 #include <fstream>
 #include <mutex>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <format>
+#include <iterator>
+#include <utility>
 #include <cstdint>
+#include <cstddef>
+#include "core/MpscRingBuffer.h"
 
 enum class LogLevel : std::uint8_t {
     DEBUG = 0,
@@ -12,6 +21,20 @@ enum class LogLevel : std::uint8_t {
     ERROR = 3
 };
 
+// What an asynchronous logger does with a message while its queue is full
+enum class LogOverflow : std::uint8_t {
+    Block,  // wait for the writer thread to make room
+    Drop    // discard the message; the writer reports how many were lost
+};
+
+struct AsyncLogOptions {
+    size_t queueCapacity = 8192;  // messages, rounded up to a power of two
+    // longest time written messages may sit in stream buffers while messages keep coming;
+    // everything is flushed as soon as the queue runs empty
+    std::chrono::milliseconds flushInterval{200};
+    LogOverflow overflow = LogOverflow::Block;
+};
+
 class Logger {
 public:
     static Logger& instance();
@@ -19,7 +42,7 @@ public:
     Logger(const Logger&) = delete;
     Logger& operator=(const Logger&) = delete;
 
-    // Initialize the logger with log level and optional file path
+    // Initialize the logger with log level and optional file path. Stops asynchronous logging.
     void init(LogLevel level, const std::string& logFilePath = "");
     // Main logging method
     void log(LogLevel level, const std::string& message);
@@ -30,23 +53,102 @@ public:
     void info(const std::string& message);
     void warning(const std::string& message);
     void error(const std::string& message);
+
+    // Whether a message of this level would be written; a lock-free load. Guard arguments that
+    // are expensive to compute themselves, since those are evaluated before the call.
+    bool isEnabled(LogLevel level) const {
+        return static_cast<int>(level) >= static_cast<int>(currentLevel.load(std::memory_order_relaxed));
+    }
+
+    // std::format-style variants: the message is only formatted when the level is enabled,
+    // straight into a buffer each thread reuses, e.g. debug("Moved '{}' to '{}'", from, to)
+    template<typename Arg, typename... Args>
+    void log(LogLevel level, std::format_string<Arg, Args...> format, Arg&& arg, Args&&... args) {
+        if (!isEnabled(level)) {
+            return;
+        }
+        std::string& buffer = formatBuffer();
+        buffer.clear();
+        std::format_to(std::back_inserter(buffer), format, std::forward<Arg>(arg), std::forward<Args>(args)...);
+        log(level, buffer);
+    }
+    template<typename Arg, typename... Args>
+    void debug(std::format_string<Arg, Args...> format, Arg&& arg, Args&&... args) {
+        log(LogLevel::DEBUG, format, std::forward<Arg>(arg), std::forward<Args>(args)...);
+    }
+    template<typename Arg, typename... Args>
+    void info(std::format_string<Arg, Args...> format, Arg&& arg, Args&&... args) {
+        log(LogLevel::INFO, format, std::forward<Arg>(arg), std::forward<Args>(args)...);
+    }
+    template<typename Arg, typename... Args>
+    void warning(std::format_string<Arg, Args...> format, Arg&& arg, Args&&... args) {
+        log(LogLevel::WARNING, format, std::forward<Arg>(arg), std::forward<Args>(args)...);
+    }
+    template<typename Arg, typename... Args>
+    void error(std::format_string<Arg, Args...> format, Arg&& arg, Args&&... args) {
+        log(LogLevel::ERROR, format, std::forward<Arg>(arg), std::forward<Args>(args)...);
+    }
+
     // Reset logger state (useful for testing)
     void reset();
 
+    // Hand messages to a background writer thread: log() only timestamps the message and
+    // pushes it into a lock-free queue, the writer formats and writes them in batches.
+    // Start and stop while no other thread is logging.
+    void startAsync(const AsyncLogOptions& options = {});
+    // Write and flush everything queued so far, then return to writing on the calling thread
+    void stopAsync();
+    // Block until every message logged before the call is written and flushed
+    void flush();
+    bool isAsync() const { return asyncActive.load(std::memory_order_acquire); }
+    // Messages discarded under LogOverflow::Drop since asynchronous logging last started
+    size_t getDroppedCount() const { return droppedTotal.load(std::memory_order_relaxed); }
+
 private:
     Logger() = default;
     ~Logger();
 
-    LogLevel currentLevel = LogLevel::INFO;
+    // A message waiting for the writer thread
+    struct Record {
+        LogLevel level = LogLevel::INFO;
+        std::chrono::system_clock::time_point time;
+        std::string message;
+    };
+
+    std::atomic<LogLevel> currentLevel{LogLevel::INFO};
     std::string logFilePath;
     std::ofstream logFile;
     std::mutex logMutex;
-    bool initialized = false;
+    std::atomic<bool> initialized{false};
+
+    // asynchronous mode; the ring and the file are only touched by the writer while it runs
+    AsyncLogOptions asyncOptions;
+    std::unique_ptr<MpscRingBuffer<Record>> asyncRing;
+    std::thread writerThread;
+    std::atomic<bool> asyncActive{false};
+    std::atomic<bool> stopping{false};
+    // bumped to wake the writer; only when it announced it is going to sleep
+    std::atomic<std::uint32_t> wakeups{0};
+    std::atomic<bool> writerSleeping{false};
+    std::atomic<size_t> messagesQueued{0};
+    std::atomic<size_t> messagesFlushed{0};
+    std::atomic<size_t> droppedUnreported{0};
+    std::atomic<size_t> droppedTotal{0};
 
     // Helper methods
     static std::string levelToString(LogLevel level);
+    // keeps its capacity, so formatting a message usually allocates nothing
+    static std::string& formatBuffer() {
+        thread_local std::string buffer;
+        return buffer;
+    }
 
     static std::string getCurrentTimestamp();
+    static std::string formatTimestamp(std::chrono::system_clock::time_point time);
     static void writeToConsole(LogLevel level, const std::string& formattedMessage);
     void writeToFile(const std::string& formattedMessage);
+
+    void enqueue(LogLevel level, const std::string& message);
+    void wakeWriter();
+    void writerLoop();
 };
@@ -0,0 +1,123 @@
+#include "core/MoveExecutor.h"
+#include "Logger.h"
+#include <algorithm>
+
+MoveExecutor::MoveExecutor(const size_t workerCount, const size_t capacity)
+    : capacity(capacity > 0 ? capacity : 1) {
+    const size_t count = workerCount > 0 ? workerCount : std::max(1u, std::thread::hardware_concurrency());
+    workers.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        workers.emplace_back([this] { workerLoop(); });
+    }
+}
+
+MoveExecutor::~MoveExecutor() {
+    wait();
+    {
+        std::lock_guard lock(mutex);
+        stopping = true;
+    }
+    workAvailable.notify_all();
+    workers.clear();
+}
+
+void MoveExecutor::submit(const std::string& strand, Task task) {
+    std::unique_lock lock(mutex);
+    spaceAvailable.wait(lock, [this] { return outstanding < capacity; });
+
+    auto [it, created] = strands.try_emplace(strand);
+    it->second.push_back(PendingTask{std::move(task), std::chrono::steady_clock::now()});
+    ++outstanding;
+    peakQueueDepth = std::max(peakQueueDepth, outstanding);
+
+    // an existing strand is either queued already or held by a worker that will requeue it
+    if (created) {
+        readyStrands.push_back(strand);
+        lock.unlock();
+        workAvailable.notify_one();
+    }
+}
+
+void MoveExecutor::wait() {
+    std::unique_lock lock(mutex);
+    allDone.wait(lock, [this] { return outstanding == 0; });
+}
+
+void MoveExecutor::waitForStrand(const std::string& strand) {
+    std::unique_lock lock(mutex);
+    strandDone.wait(lock, [&] { return !strands.contains(strand); });
+}
+
+void MoveExecutor::workerLoop() {
+    std::unique_lock lock(mutex);
+    while (true) {
+        workAvailable.wait(lock, [this] { return stopping || !readyStrands.empty(); });
+        if (readyStrands.empty()) {
+            return;
+        }
+
+        const std::string strand = std::move(readyStrands.front());
+        readyStrands.pop_front();
+        auto& tasks = strands[strand];
+        PendingTask pending = std::move(tasks.front());
+        tasks.pop_front();
+        lock.unlock();
+
+        const auto started = std::chrono::steady_clock::now();
+        try {
+            pending.task();
+        } catch (const std::exception& e) {
+            Logger::instance().error("Move task failed: " + std::string(e.what()));
+        }
+        const auto finished = std::chrono::steady_clock::now();
+
+        lock.lock();
+        const double latency = std::chrono::duration<double>(finished - started).count();
+        totalLatencySeconds += latency;
+        maxLatencySeconds = std::max(maxLatencySeconds, latency);
+        totalWaitSeconds += std::chrono::duration<double>(started - pending.submitted).count();
+        ++tasksCompleted;
+
+        // to the back of the line, so one busy directory doesn't starve the others
+        if (auto it = strands.find(strand); it->second.empty()) {
+            strands.erase(it);
+            strandDone.notify_all();
+        } else {
+            readyStrands.push_back(strand);
+            workAvailable.notify_one();
+        }
+
+        --outstanding;
+        spaceAvailable.notify_one();
+        if (outstanding == 0) {
+            allDone.notify_all();
+        }
+    }
+}
+
+MoveExecutor::Statistics MoveExecutor::getStatistics() const {
+    std::lock_guard lock(mutex);
+    Statistics stats;
+    stats.tasksCompleted = tasksCompleted;
+    stats.peakQueueDepth = peakQueueDepth;
+    stats.maxLatencySeconds = maxLatencySeconds;
+    if (tasksCompleted > 0) {
+        stats.averageLatencySeconds = totalLatencySeconds / static_cast<double>(tasksCompleted);
+        stats.averageWaitSeconds = totalWaitSeconds / static_cast<double>(tasksCompleted);
+    }
+    return stats;
+}
+
+void MoveExecutor::resetStatistics() {
+    std::lock_guard lock(mutex);
+    peakQueueDepth = outstanding;
+    tasksCompleted = 0;
+    totalLatencySeconds = 0.0;
+    maxLatencySeconds = 0.0;
+    totalWaitSeconds = 0.0;
+}
+
+size_t MoveExecutor::getQueueDepth() const {
+    std::lock_guard lock(mutex);
+    return outstanding;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <deque>
+#include <unordered_map>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <cstddef>
+
+// Worker pool for the move stage. Every task belongs to a strand (the target directory):
+// tasks of one strand run one at a time in submission order, so collision resolution in a
+// directory stays deterministic, while different strands run concurrently.
+class MoveExecutor {
+public:
+    using Task = std::function<void()>;
+
+    struct Statistics {
+        size_t tasksCompleted = 0;
+        size_t peakQueueDepth = 0;  // most tasks submitted but not yet finished
+        double averageLatencySeconds = 0.0;  // time spent running a task
+        double maxLatencySeconds = 0.0;
+        double averageWaitSeconds = 0.0;  // time from submit() until a worker picked the task up
+    };
+
+    // A worker count of 0 selects std::thread::hardware_concurrency(); submit() blocks while
+    // capacity tasks are outstanding
+    explicit MoveExecutor(size_t workerCount = 0, size_t capacity = 1024);
+    // Finishes every submitted task before returning
+    ~MoveExecutor();
+
+    MoveExecutor(const MoveExecutor&) = delete;
+    MoveExecutor& operator=(const MoveExecutor&) = delete;
+
+    void submit(const std::string& strand, Task task);
+
+    // Block until every task submitted so far has finished
+    void wait();
+    // Block until the strand has no queued or running task
+    void waitForStrand(const std::string& strand);
+
+    Statistics getStatistics() const;
+    void resetStatistics();
+
+    size_t getWorkerCount() const { return workers.size(); }
+    size_t getQueueDepth() const;
+
+private:
+    struct PendingTask {
+        Task task;
+        std::chrono::steady_clock::time_point submitted;
+    };
+
+    const size_t capacity;
+    mutable std::mutex mutex;
+    std::condition_variable workAvailable;
+    std::condition_variable spaceAvailable;
+    std::condition_variable allDone;
+    std::condition_variable strandDone;
+
+    // strands with queued or running tasks; a strand is in readyStrands only while no worker holds it
+    std::unordered_map<std::string, std::deque<PendingTask>> strands;
+    std::deque<std::string> readyStrands;
+    size_t outstanding = 0;
+    bool stopping = false;
+
+    size_t peakQueueDepth = 0;
+    size_t tasksCompleted = 0;
+    double totalLatencySeconds = 0.0;
+    double maxLatencySeconds = 0.0;
+    double totalWaitSeconds = 0.0;
+
+    std::vector<std::jthread> workers;
+
+    void workerLoop();
+};
@@ -0,0 +1,713 @@
+#include "core/MoveJournal.h"
+#include "core/ScanIndex.h"
+#include "core/MoveExecutor.h"
+#include "core/FileOperations.h"
+#include "Logger.h"
+#include <fstream>
+#include <sstream>
+#include <array>
+#include <algorithm>
+#include <cstring>
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <random>
+#include <ranges>
+#include <unordered_map>
+#include <unordered_set>
+#include <format>
+#include <system_error>
+#include <cerrno>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/file.h>
+#endif
+
+namespace {
+
+constexpr std::array<char, 4> journalMagic{'F', 'O', 'M', 'J'};
+constexpr std::uint32_t journalVersion = 1;
+constexpr std::uint32_t maxRecordLength = 1u << 20;
+constexpr const char* journalExtension = ".journal";
+
+enum class RecordType : std::uint8_t {
+    Planned = 1,
+    Completed = 2,
+    Failed = 3,
+    Undone = 4,
+    Closed = 5,
+    RolledBack = 6,
+    CopyCreated = 7,
+};
+
+template<typename T>
+void appendValue(std::string& out, const T& value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void appendString(std::string& out, const std::string& text) {
+    appendValue(out, static_cast<std::uint32_t>(text.size()));
+    out.append(text);
+}
+
+// Reads values from one record's payload
+class RecordReader {
+public:
+    explicit RecordReader(const std::string_view data) : data(data) {}
+
+    template<typename T>
+    bool read(T& value) {
+        if (data.size() - position < sizeof(value)) {
+            return false;
+        }
+        std::memcpy(&value, data.data() + position, sizeof(value));
+        position += sizeof(value);
+        return true;
+    }
+
+    bool readString(std::string& text) {
+        std::uint32_t length = 0;
+        if (!read(length) || data.size() - position < length) {
+            return false;
+        }
+        text.assign(data.substr(position, length));
+        position += length;
+        return true;
+    }
+
+private:
+    std::string_view data;
+    size_t position = 0;
+};
+
+std::string encodeOutcome(const RecordType type, const std::uint64_t id) {
+    std::string payload;
+    appendValue(payload, type);
+    appendValue(payload, id);
+    return payload;
+}
+
+std::int64_t toNanoseconds(const std::filesystem::file_time_type time) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+// Whether candidate is the item an entry renamed: the same inode on the same device
+bool isRenamedItem(const MoveJournal::Entry& entry, const std::filesystem::path& candidate) {
+    const auto metadata = readFileMetadata(candidate);
+    return metadata && metadata->device == entry.device && metadata->inode == entry.inode;
+}
+
+// Where a planned rename put its item, if it happened: the planned target or one of the
+// "stem_NNN" names a collision would have picked
+std::optional<std::filesystem::path> findRenamedItem(const MoveJournal::Entry& entry) {
+    if (isRenamedItem(entry, entry.target)) {
+        return entry.target;
+    }
+    const std::string prefix = entry.target.stem().string() + "_";
+    const std::string extension = entry.target.extension().string();
+    std::error_code ec;
+    for (std::filesystem::directory_iterator it(entry.target.parent_path(), ec), end; !ec && it != end; it.increment(ec)) {
+        const std::string name = it->path().filename().string();
+        if (name.size() < prefix.size() + extension.size() + 3 || !name.starts_with(prefix) || !name.ends_with(extension)) {
+            continue;
+        }
+        const std::string_view suffix = std::string_view(name).substr(prefix.size(), name.size() - prefix.size() - extension.size());
+        if (std::ranges::all_of(suffix, [](const char c) { return c >= '0' && c <= '9'; }) && isRenamedItem(entry, it->path())) {
+            return it->path();
+        }
+    }
+    return std::nullopt;
+}
+
+// Whether the journal recorded a copy for an interrupted move to another filesystem and it
+// is still the entry that move created; never an item another entry settled at
+bool hasRecordedCopy(const MoveJournal::Entry& entry, const std::unordered_set<std::string>& settledTargets) {
+    if (entry.copy.empty() || settledTargets.contains(entry.copy.string())) {
+        return false;
+    }
+#if defined(__unix__) || defined(__APPLE__)
+    struct stat status {};
+    return ::lstat(entry.copy.c_str(), &status) == 0 && static_cast<std::uint64_t>(status.st_dev) == entry.copyDevice &&
+           static_cast<std::uint64_t>(status.st_ino) == entry.copyInode;
+#else
+    return false;
+#endif
+}
+
+// A directory copy gets its times last, so a copy whose mtime is the source's is complete
+bool isCompleteDirectoryCopy(const MoveJournal::Entry& entry) {
+    const auto metadata = readFileMetadata(entry.copy);
+    return metadata && metadata->type == ItemType::Directory &&
+           toNanoseconds(metadata->lastModified) == entry.modifiedNanoseconds;
+}
+
+// Move an undone entry's item back, never replacing whatever now sits at its source
+std::error_code moveBack(const MoveJournal::Entry& entry) {
+    std::error_code ec;
+    std::filesystem::create_directories(entry.source.parent_path(), ec);
+    if (ec) {
+        return ec;
+    }
+    const DirectoryHandle directory(entry.source.parent_path());
+    ec = renameNoReplace(entry.finalTarget, directory, entry.source.filename().string());
+    if (ec == std::errc::operation_not_supported) {
+        if (std::filesystem::exists(std::filesystem::symlink_status(entry.source, ec))) {
+            return std::make_error_code(std::errc::file_exists);
+        }
+        std::filesystem::rename(entry.finalTarget, entry.source, ec);
+    }
+    if (ec == std::errc::cross_device_link) {
+        ec = moveAcrossDevices(entry.finalTarget, entry.source, {}).error;
+    }
+    return ec;
+}
+
+// Paths of the restores in flight, to find a restore that has to wait for them: one whose
+// source or target lies inside or around a path they use. Siblings don't conflict.
+class RestoreClaims {
+public:
+    bool conflicts(const MoveJournal::Entry& entry) const {
+        return conflicts(entry.source) || conflicts(entry.finalTarget);
+    }
+
+    void claim(const MoveJournal::Entry& entry) {
+        claim(entry.source);
+        claim(entry.finalTarget);
+    }
+
+    void clear() {
+        claimed.clear();
+        claimedAncestors.clear();
+    }
+
+private:
+    std::unordered_set<std::string> claimed;
+    std::unordered_set<std::string> claimedAncestors;
+
+    bool conflicts(const std::filesystem::path& path) const {
+        if (claimedAncestors.contains(path.string())) {
+            return true;
+        }
+        for (std::filesystem::path current = path; ; current = current.parent_path()) {
+            if (claimed.contains(current.string())) {
+                return true;
+            }
+            if (!current.has_relative_path()) {
+                return false;
+            }
+        }
+    }
+
+    void claim(const std::filesystem::path& path) {
+        claimed.insert(path.string());
+        for (std::filesystem::path current = path; current.has_relative_path(); ) {
+            current = current.parent_path();
+            claimedAncestors.insert(current.string());
+        }
+    }
+};
+
+} // namespace
+
+MoveJournal::MoveJournal(std::filesystem::path journalFile) : journalFile(std::move(journalFile)) {
+}
+
+MoveJournal::~MoveJournal() {
+    close();
+}
+
+bool MoveJournal::create() {
+    // "x": never take over another run's journal
+    file = std::fopen(journalFile.string().c_str(), "wbx");
+    if (!file) {
+        Logger::instance().error("Failed to create move journal: " + journalFile.string());
+        return false;
+    }
+    // only a recovery that looked at the new, still empty file can hold it, and only briefly
+    if (!lock(true)) {
+        Logger::instance().error("Failed to lock move journal: " + journalFile.string());
+        std::fclose(file);
+        file = nullptr;
+        return false;
+    }
+    std::string header(journalMagic.begin(), journalMagic.end());
+    appendValue(header, journalVersion);
+    if (!writeAndSync(header)) {
+        Logger::instance().error("Failed to write move journal: " + journalFile.string());
+        return false;
+    }
+#if defined(__unix__) || defined(__APPLE__)
+    // the journal's directory entry has to survive a crash too
+    if (const int directory = ::open(journalFile.parent_path().c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC); directory >= 0) {
+        ::fsync(directory);
+        ::close(directory);
+    }
+#endif
+    return true;
+}
+
+bool MoveJournal::reopen() {
+    file = std::fopen(journalFile.string().c_str(), "ab");
+    if (!file) {
+        Logger::instance().error("Failed to open move journal: " + journalFile.string());
+        return false;
+    }
+    // dropped without a closing record: whatever else happens to the journal is its holder's
+    const auto abandon = [this] {
+        std::fclose(file);
+        file = nullptr;
+        return false;
+    };
+    if (!lock(false)) {
+        Logger::instance().info("Move journal in use by a running organizer: " + journalFile.string());
+        return abandon();
+    }
+    const auto contents = read(journalFile);
+    if (!contents) {
+        return abandon();
+    }
+    std::error_code ec;
+    if (std::filesystem::file_size(journalFile, ec) != contents->validBytes) {
+        Logger::instance().warning("Dropping torn record at the end of move journal " + journalFile.string());
+        std::filesystem::resize_file(journalFile, contents->validBytes, ec);
+        if (ec) {
+            Logger::instance().error(std::format("Failed to truncate move journal {}: {}", journalFile.string(), ec.message()));
+            return abandon();
+        }
+    }
+    // planned entry ids are record numbers, so new records continue after the recorded ones
+    std::lock_guard lock(mutex);
+    for (const Entry& entry : contents->entries) {
+        nextRecord = std::max(nextRecord, entry.id + 1);
+    }
+    durableRecord = nextRecord - 1;
+    return true;
+}
+
+bool MoveJournal::lock(const bool wait) {
+#if defined(__unix__) || defined(__APPLE__)
+    // released when the file is closed, or by the kernel when the process dies
+    int result = 0;
+    do {
+        result = ::flock(::fileno(file), LOCK_EX | (wait ? 0 : LOCK_NB));
+    } while (result != 0 && errno == EINTR);
+    return result == 0;
+#else
+    (void)wait;
+    return true;
+#endif
+}
+
+std::uint64_t MoveJournal::plan(const std::filesystem::path& source, const std::filesystem::path& target,
+                                const FileMetadata& identity) {
+    std::string payload;
+    appendValue(payload, RecordType::Planned);
+    appendValue(payload, std::uint64_t{0});  // the entry id is the record number, filled in by append()
+    appendString(payload, source.string());
+    appendString(payload, target.string());
+    appendValue(payload, identity.device);
+    appendValue(payload, identity.inode);
+    appendValue(payload, static_cast<std::uint64_t>(identity.sizeInBytes));
+    appendValue(payload, toNanoseconds(identity.lastModified));
+    return append(std::move(payload));
+}
+
+bool MoveJournal::recordCopy(const std::uint64_t id, const std::filesystem::path& copy, const std::uint64_t device,
+                             const std::uint64_t inode) {
+    std::string payload = encodeOutcome(RecordType::CopyCreated, id);
+    appendString(payload, copy.string());
+    appendValue(payload, device);
+    appendValue(payload, inode);
+    return commitThrough(append(std::move(payload)));
+}
+
+void MoveJournal::complete(const std::uint64_t id, const std::filesystem::path& finalTarget) {
+    std::string payload = encodeOutcome(RecordType::Completed, id);
+    appendString(payload, finalTarget.string());
+    append(std::move(payload));
+}
+
+void MoveJournal::fail(const std::uint64_t id) {
+    append(encodeOutcome(RecordType::Failed, id));
+}
+
+void MoveJournal::markUndone(const std::uint64_t id) {
+    append(encodeOutcome(RecordType::Undone, id));
+}
+
+void MoveJournal::markRolledBack(const std::uint64_t id) {
+    append(encodeOutcome(RecordType::RolledBack, id));
+}
+
+std::uint64_t MoveJournal::append(std::string payload) {
+    std::lock_guard lock(mutex);
+    const std::uint64_t record = nextRecord++;
+    if (static_cast<RecordType>(payload[0]) == RecordType::Planned) {
+        std::memcpy(payload.data() + sizeof(RecordType), &record, sizeof(record));
+    }
+    appendValue(pending, static_cast<std::uint32_t>(payload.size()));
+    appendValue(pending, ScanIndex::hash(payload));
+    pending += payload;
+    ++stats.recordsWritten;
+    return record;
+}
+
+bool MoveJournal::commitThrough(const std::uint64_t id) {
+    std::unique_lock lock(mutex);
+    while (durableRecord < id) {
+        if (broken) {
+            return false;
+        }
+        if (committing) {
+            // another thread is writing; its batch may already include our record
+            committed.wait(lock);
+            continue;
+        }
+
+        // lead a group commit of everything buffered so far
+        committing = true;
+        std::string batch;
+        batch.swap(pending);
+        const std::uint64_t batchEnd = nextRecord - 1;
+        lock.unlock();
+        const bool written = writeAndSync(batch);
+        lock.lock();
+
+        committing = false;
+        ++stats.commits;
+        if (written) {
+            durableRecord = batchEnd;
+        } else {
+            broken = true;
+            Logger::instance().error("Failed to write move journal: " + journalFile.string());
+        }
+        committed.notify_all();
+    }
+    return true;
+}
+
+bool MoveJournal::flush() {
+    std::unique_lock lock(mutex);
+    const std::uint64_t last = nextRecord - 1;
+    lock.unlock();
+    return commitThrough(last);
+}
+
+bool MoveJournal::close() {
+    if (!file) {
+        return true;
+    }
+    const std::uint64_t last = append(encodeOutcome(RecordType::Closed, 0));
+    const bool written = commitThrough(last);
+    std::fclose(file);
+    file = nullptr;
+    return written;
+}
+
+MoveJournal::Statistics MoveJournal::getStatistics() const {
+    std::lock_guard lock(mutex);
+    return stats;
+}
+
+bool MoveJournal::writeAndSync(const std::string& batch) {
+    if (!file || std::fwrite(batch.data(), 1, batch.size(), file) != batch.size() || std::fflush(file) != 0) {
+        return false;
+    }
+#if defined(__APPLE__)
+    return ::fsync(::fileno(file)) == 0;
+#elif defined(__unix__)
+    return ::fdatasync(::fileno(file)) == 0;
+#else
+    return true;
+#endif
+}
+
+std::string MoveJournal::newRunId() {
+    const std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+    const std::tm time = *std::gmtime(&now);
+    std::random_device random;
+    return std::format("{:04}{:02}{:02}-{:02}{:02}{:02}-{:04x}", time.tm_year + 1900, time.tm_mon + 1, time.tm_mday,
+                       time.tm_hour, time.tm_min, time.tm_sec, random() & 0xffff);
+}
+
+std::filesystem::path MoveJournal::journalPath(const std::filesystem::path& directory, const std::string& runId) {
+    return directory / (runId + journalExtension);
+}
+
+std::optional<MoveJournal::Contents> MoveJournal::read(const std::filesystem::path& journalFile) {
+    std::ifstream in(journalFile, std::ios::binary);
+    if (!in.is_open()) {
+        Logger::instance().error("Failed to open move journal: " + journalFile.string());
+        return std::nullopt;
+    }
+    std::ostringstream buffer;
+    buffer << in.rdbuf();
+    const std::string data = std::move(buffer).str();
+
+    std::uint32_t version = 0;
+    if (data.size() < journalMagic.size() + sizeof(version) ||
+        !std::ranges::equal(std::string_view(data).substr(0, journalMagic.size()), journalMagic)) {
+        Logger::instance().error("Not a move journal: " + journalFile.string());
+        return std::nullopt;
+    }
+    std::memcpy(&version, data.data() + journalMagic.size(), sizeof(version));
+    if (version != journalVersion) {
+        Logger::instance().error(std::format("Unsupported move journal version {}: {}", version, journalFile.string()));
+        return std::nullopt;
+    }
+
+    Contents contents;
+    std::unordered_map<std::uint64_t, size_t> entryIndex;
+    size_t offset = journalMagic.size() + sizeof(version);
+    contents.validBytes = offset;
+
+    // the records after a crash mid-write fail their length or checksum; everything before stands
+    while (data.size() - offset >= sizeof(std::uint32_t) + sizeof(std::uint64_t)) {
+        std::uint32_t length = 0;
+        std::uint64_t checksum = 0;
+        std::memcpy(&length, data.data() + offset, sizeof(length));
+        std::memcpy(&checksum, data.data() + offset + sizeof(length), sizeof(checksum));
+        const size_t payloadOffset = offset + sizeof(length) + sizeof(checksum);
+        if (length == 0 || length > maxRecordLength || data.size() - payloadOffset < length) {
+            break;
+        }
+        const std::string_view payload = std::string_view(data).substr(payloadOffset, length);
+        if (ScanIndex::hash(payload) != checksum) {
+            break;
+        }
+
+        RecordReader reader(payload);
+        RecordType type{};
+        std::uint64_t id = 0;
+        if (!reader.read(type) || !reader.read(id)) {
+            break;
+        }
+        const auto existing = entryIndex.find(id);
+        Entry* entry = existing != entryIndex.end() ? &contents.entries[existing->second] : nullptr;
+
+        bool valid = true;
+        switch (type) {
+            case RecordType::Planned: {
+                Entry planned;
+                std::string source;
+                std::string target;
+                planned.id = id;
+                valid = reader.readString(source) && reader.readString(target) &&
+                        reader.read(planned.device) && reader.read(planned.inode) &&
+                        reader.read(planned.size) && reader.read(planned.modifiedNanoseconds);
+                planned.source = source;
+                planned.target = target;
+                if (valid) {
+                    entryIndex[id] = contents.entries.size();
+                    contents.entries.push_back(std::move(planned));
+                }
+                break;
+            }
+            case RecordType::Completed: {
+                std::string finalTarget;
+                valid = entry && reader.readString(finalTarget);
+                if (valid) {
+                    entry->finalTarget = finalTarget;
+                    entry->state = Entry::State::Completed;
+                }
+                break;
+            }
+            case RecordType::CopyCreated: {
+                std::string copy;
+                valid = entry && reader.readString(copy) && reader.read(entry->copyDevice) && reader.read(entry->copyInode);
+                if (valid) {
+                    entry->copy = copy;
+                }
+                break;
+            }
+            case RecordType::Failed:
+            case RecordType::Undone:
+            case RecordType::RolledBack:
+                valid = entry != nullptr;
+                if (valid) {
+                    entry->state = type == RecordType::Failed ? Entry::State::Failed
+                        : type == RecordType::Undone          ? Entry::State::Undone
+                                                              : Entry::State::RolledBack;
+                }
+                break;
+            case RecordType::Closed:
+                break;
+            default:
+                valid = false;
+        }
+        if (!valid) {
+            break;
+        }
+        contents.closed = type == RecordType::Closed;
+        offset = payloadOffset + length;
+        contents.validBytes = offset;
+    }
+    return contents;
+}
+
+bool MoveJournal::recover(const std::filesystem::path& journalFile) {
+    // holding the lock proves the journal's writer is gone
+    MoveJournal journal(journalFile);
+    if (!journal.reopen()) {
+        return false;
+    }
+    const auto contents = read(journalFile);
+    if (!contents) {
+        return false;
+    }
+    journal.settleOpenEntries(*contents);
+    return journal.close();
+}
+
+void MoveJournal::settleOpenEntries(const Contents& contents) {
+    // where completed entries put their items; whatever sits there is not this run's debris
+    std::unordered_set<std::string> settledTargets;
+    for (const Entry& entry : contents.entries) {
+        if (entry.state == Entry::State::Completed) {
+            settledTargets.insert(entry.finalTarget.string());
+        }
+    }
+
+    size_t completed = 0;
+    size_t failed = 0;
+    size_t rolledBack = 0;
+    for (const Entry& entry : contents.entries) {
+        if (entry.state != Entry::State::Planned) {
+            continue;
+        }
+        const bool copied = hasRecordedCopy(entry, settledTargets);
+        std::error_code ec;
+        if (std::filesystem::exists(std::filesystem::symlink_status(entry.source, ec))) {
+            if (!copied) {
+                // the rename never happened, nor did a copy get going
+                fail(entry.id);
+                ++failed;
+                continue;
+            }
+            // a complete directory copy means the crash came while the source was being
+            // removed, which may have taken parts of it
+            if (isCompleteDirectoryCopy(entry)) {
+                std::filesystem::remove_all(entry.source, ec);
+                if (!ec) {
+                    complete(entry.id, entry.copy);
+                    ++completed;
+                    continue;
+                }
+                Logger::instance().error(std::format("Failed to finish removing {} after copying it to {}: {}",
+                                                     entry.source.string(), entry.copy.string(), ec.message()));
+                fail(entry.id);
+                ++failed;
+                continue;
+            }
+            // the source is whole: drop the copy
+            std::filesystem::remove_all(entry.copy, ec);
+            if (ec) {
+                Logger::instance().error(std::format("Failed to remove {} left by an interrupted copy of {}: {}",
+                                                     entry.copy.string(), entry.source.string(), ec.message()));
+                fail(entry.id);
+                ++failed;
+                continue;
+            }
+            markRolledBack(entry.id);
+            ++rolledBack;
+        } else if (copied) {
+            // copied, and the source removed before the outcome was recorded
+            complete(entry.id, entry.copy);
+            ++completed;
+        } else if (const auto movedTo = findRenamedItem(entry)) {
+            complete(entry.id, *movedTo);
+            ++completed;
+        } else {
+            Logger::instance().warning(std::format("Item of interrupted move {} -> {} not found",
+                                                   entry.source.string(), entry.target.string()));
+            fail(entry.id);
+            ++failed;
+        }
+    }
+    Logger::instance().info(std::format("Recovered move journal {}: {} interrupted moves had completed, {} were rolled back, "
+                                        "{} had not happened", journalFile.string(), completed, rolledBack, failed));
+}
+
+size_t MoveJournal::recoverAll(const std::filesystem::path& directory) {
+    size_t recovered = 0;
+    std::error_code ec;
+    for (std::filesystem::directory_iterator it(directory, ec), end; !ec && it != end; it.increment(ec)) {
+        if (it->path().extension() != journalExtension) {
+            continue;
+        }
+        if (const auto contents = read(it->path()); contents && !contents->closed) {
+            recovered += recover(it->path());
+        }
+    }
+    return recovered;
+}
+
+std::optional<MoveJournal::UndoResult> MoveJournal::undo(const std::filesystem::path& directory,
+                                                         const std::string& runId, const size_t threads) {
+    const std::filesystem::path journalFile = journalPath(directory, runId);
+    // a run still writing its journal can't be undone
+    MoveJournal journal(journalFile);
+    if (!journal.reopen()) {
+        return std::nullopt;
+    }
+    auto contents = read(journalFile);
+    if (contents && !contents->closed) {
+        journal.settleOpenEntries(*contents);
+        contents = read(journalFile);
+    }
+    if (!contents) {
+        return std::nullopt;
+    }
+
+    std::atomic<size_t> restored{0};
+    std::atomic<size_t> skipped{0};
+    std::atomic<size_t> failed{0};
+    {
+        // moves back into one directory run in reverse order, different directories in parallel;
+        // a restore nested with one in flight, such as a file moved out of a directory that was
+        // moved later, waits until everything in flight is done
+        MoveExecutor executor(threads);
+        RestoreClaims inFlight;
+        for (const Entry& entry : contents->entries | std::views::reverse) {
+            if (entry.state == Entry::State::Undone) {
+                ++skipped;
+                continue;
+            }
+            if (entry.state != Entry::State::Completed) {
+                continue;
+            }
+            if (inFlight.conflicts(entry)) {
+                executor.wait();
+                inFlight.clear();
+            }
+            inFlight.claim(entry);
+            executor.submit(entry.source.parent_path().string(), [&journal, &restored, &skipped, &failed, &entry] {
+                // an earlier undo moved it back but died before recording that
+                std::error_code ec;
+                if (!std::filesystem::exists(std::filesystem::symlink_status(entry.finalTarget, ec)) &&
+                    std::filesystem::exists(std::filesystem::symlink_status(entry.source, ec))) {
+                    journal.markUndone(entry.id);
+                    ++skipped;
+                    return;
+                }
+                if (const std::error_code ec = moveBack(entry)) {
+                    Logger::instance().error(std::format("Failed to move {} back to {}: {}", entry.finalTarget.string(),
+                                                         entry.source.string(), ec.message()));
+                    ++failed;
+                    return;
+                }
+                journal.markUndone(entry.id);
+                ++restored;
+                Logger::instance().info("Moved '" + entry.finalTarget.string() + "' back to '" + entry.source.string() + "'");
+            });
+        }
+        executor.wait();
+    }
+    if (!journal.close()) {
+        return std::nullopt;
+    }
+    return UndoResult{restored.load(), skipped.load(), failed.load()};
+}
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <optional>
+#include <mutex>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdint>
+#include "models/FileMetadata.h"
+
+// Write-ahead log of the moves made by one run. Every move is recorded as planned, and
+// that record is on disk before the rename happens; its outcome is appended afterwards.
+// Records are flushed in groups: whoever needs a planned record to be durable writes and
+// syncs everything buffered so far, so moves planned together share one fsync.
+//
+// The writer holds an exclusive flock() on the journal for as long as it has it open, so a
+// journal that was not closed and that nobody holds belonged to a run that died; recover()
+// settles its open entries by looking for the moved items on disk. undo() moves a run's
+// items back.
+class MoveJournal {
+public:
+    struct Entry {
+        enum class State { Planned, Completed, Failed, Undone, RolledBack };
+
+        std::uint64_t id = 0;
+        std::filesystem::path source;
+        std::filesystem::path target;       // as planned
+        std::filesystem::path finalTarget;  // where the item ended up, once completed
+        // identity of the source, to find it again after a crash
+        std::uint64_t device = 0;
+        std::uint64_t inode = 0;
+        std::uint64_t size = 0;
+        std::int64_t modifiedNanoseconds = 0;
+        // the entry a move to another filesystem created at the target, once recorded; the
+        // only item recovery ever removes
+        std::filesystem::path copy;
+        std::uint64_t copyDevice = 0;
+        std::uint64_t copyInode = 0;
+        State state = State::Planned;
+    };
+
+    struct Contents {
+        std::vector<Entry> entries;  // in planning order
+        bool closed = false;
+        std::uintmax_t validBytes = 0;  // a torn record after this offset is ignored
+    };
+
+    struct Statistics {
+        size_t recordsWritten = 0;
+        size_t commits = 0;  // fsyncs
+    };
+
+    struct UndoResult {
+        size_t restored = 0;
+        size_t skipped = 0;  // already undone
+        size_t failed = 0;
+    };
+
+    explicit MoveJournal(std::filesystem::path journalFile);
+    // closes the journal
+    ~MoveJournal();
+
+    MoveJournal(const MoveJournal&) = delete;
+    MoveJournal& operator=(const MoveJournal&) = delete;
+
+    // Start the journal of a new run; fails if the file already exists
+    bool create();
+    // Append to an existing journal, dropping a torn record at its end; fails if another
+    // writer holds it
+    bool reopen();
+
+    // Record a planned move and return its entry id. Buffered only: call commitThrough(id)
+    // before the move happens.
+    std::uint64_t plan(const std::filesystem::path& source, const std::filesystem::path& target,
+                       const FileMetadata& identity);
+
+    // Make every record up to and including id durable. Returns false if the journal can't be
+    // written, in which case the move must not happen.
+    bool commitThrough(std::uint64_t id);
+
+    // Record the entry a move to another filesystem created at copy, before anything is
+    // copied into it, and make that durable. Returns false if it can't be, in which case the
+    // copy must not go on.
+    bool recordCopy(std::uint64_t id, const std::filesystem::path& copy, std::uint64_t device, std::uint64_t inode);
+
+    // Outcomes; buffered until the next commit
+    void complete(std::uint64_t id, const std::filesystem::path& finalTarget);
+    void fail(std::uint64_t id);
+    void markUndone(std::uint64_t id);
+    // the interrupted move's copy was removed and the item left at its source
+    void markRolledBack(std::uint64_t id);
+
+    // Make every record so far durable
+    bool flush();
+
+    // Append the closing record and flush everything
+    bool close();
+
+    const std::filesystem::path& getJournalFile() const { return journalFile; }
+    Statistics getStatistics() const;
+
+    // A run id from the current time, unique enough to name the run's journal
+    static std::string newRunId();
+    static std::filesystem::path journalPath(const std::filesystem::path& directory, const std::string& runId);
+
+    static std::optional<Contents> read(const std::filesystem::path& journalFile);
+
+    // Settle the open entries of a journal that was not closed: moves whose item is found at
+    // the target are completed, the rest failed. A copy to another filesystem that was cut
+    // short is removed and its entry rolled back; a directory copy that was complete when
+    // the crash came during removal of the source has that removal finished and is
+    // completed. Only copies recordCopy() recorded, still with the recorded identity, are
+    // touched. Returns false if the journal is unusable.
+    static bool recover(const std::filesystem::path& journalFile);
+    // recover() every unclosed journal in directory that no running organizer holds; returns
+    // how many there were
+    static size_t recoverAll(const std::filesystem::path& directory);
+
+    // Move the completed entries of a run back to their sources, newest first, on threads
+    // workers; moves back into the same directory keep their order, and an entry whose paths
+    // lie inside or around those of an entry still being restored waits for it
+    static std::optional<UndoResult> undo(const std::filesystem::path& directory, const std::string& runId,
+                                          size_t threads);
+
+private:
+    std::filesystem::path journalFile;
+    std::FILE* file = nullptr;
+
+    mutable std::mutex mutex;
+    std::condition_variable committed;
+    std::string pending;  // encoded records not yet written
+    std::uint64_t nextRecord = 1;  // record numbers double as entry ids of planned records
+    std::uint64_t durableRecord = 0;
+    bool committing = false;
+    bool broken = false;
+    Statistics stats;
+
+    std::uint64_t append(std::string payload);
+    bool writeAndSync(const std::string& batch);
+    // Take the writer's lock on the open file, waiting for it only if wait is set
+    bool lock(bool wait);
+    // recover() for this reopened journal, without closing it
+    void settleOpenEntries(const Contents& contents);
+};
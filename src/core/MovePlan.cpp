@@ -0,0 +1,295 @@
+#include "core/MovePlan.h"
+#include "core/ScanIndex.h"
+#include "Logger.h"
+#include <fstream>
+#include <sstream>
+#include <array>
+#include <algorithm>
+#include <cstring>
+#include <chrono>
+#include <format>
+#include <system_error>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr std::array<char, 4> planMagic{'F', 'O', 'M', 'P'};
+constexpr std::uint32_t planVersion = 1;
+// offsets of the header fields finish() fills in once the scan is done
+constexpr long entryCountOffset = planMagic.size() + sizeof(std::uint32_t) + sizeof(std::uint64_t);
+constexpr long checksumOffset = entryCountOffset + sizeof(std::uint64_t);
+
+std::int64_t toNanoseconds(const std::filesystem::file_time_type time) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+template<typename T>
+void appendValue(std::string& out, const T& value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void appendString(std::string& out, const std::string& text) {
+    appendValue(out, static_cast<std::uint32_t>(text.size()));
+    out.append(text);
+}
+
+// Reads values from the mapped plan
+class PlanReader {
+public:
+    explicit PlanReader(const std::string_view data, const size_t position = 0) : data(data), position(position) {}
+
+    template<typename T>
+    bool read(T& value) {
+        if (data.size() - position < sizeof(value)) {
+            return false;
+        }
+        std::memcpy(&value, data.data() + position, sizeof(value));
+        position += sizeof(value);
+        return true;
+    }
+
+    bool readView(std::string_view& text, const std::uint32_t length) {
+        if (data.size() - position < length) {
+            return false;
+        }
+        text = data.substr(position, length);
+        position += length;
+        return true;
+    }
+
+    bool readString(std::string& text) {
+        std::uint32_t length = 0;
+        std::string_view view;
+        if (!read(length) || !readView(view, length)) {
+            return false;
+        }
+        text.assign(view);
+        return true;
+    }
+
+    bool readEntry(MovePlan::Entry& entry) {
+        std::uint8_t type = 0;
+        std::uint32_t sourceLength = 0;
+        std::uint32_t targetLength = 0;
+        if (!read(type) || type > static_cast<std::uint8_t>(ItemType::Other) ||
+            !read(entry.ruleId) || !read(entry.size) || !read(entry.modifiedNanoseconds) ||
+            !read(sourceLength) || !read(targetLength) ||
+            !readView(entry.source, sourceLength) || !readView(entry.target, targetLength)) {
+            return false;
+        }
+        entry.type = static_cast<ItemType>(type);
+        return true;
+    }
+
+    size_t getPosition() const { return position; }
+    bool atEnd() const { return position == data.size(); }
+
+private:
+    std::string_view data;
+    size_t position;
+};
+
+// Whether a stored path names something inside the root it is relative to: not empty, not
+// absolute, and without "." or ".." components, which could name the root or leave it
+bool staysInsideRoot(const std::string_view path) {
+    const std::filesystem::path relative(path);
+    return !relative.empty() && !relative.has_root_path() &&
+           std::ranges::none_of(relative, [](const std::filesystem::path& part) { return part == "." || part == ".."; });
+}
+
+} // namespace
+
+bool MovePlan::Entry::matches(const FileMetadata& metadata) const {
+    return metadata.type == type &&
+           metadata.sizeInBytes == size &&
+           toNanoseconds(metadata.lastModified) == modifiedNanoseconds;
+}
+
+MovePlan::Writer::Writer(std::filesystem::path planFile, const std::uint64_t fingerprint,
+                         std::filesystem::path sourceRoot, std::filesystem::path targetRoot)
+    : planFile(std::move(planFile)), fingerprint(fingerprint),
+      sourceRoot(std::move(sourceRoot)), targetRoot(std::move(targetRoot)),
+      checksum(ScanIndex::hash({})) {
+    temporaryFile = this->planFile;
+    temporaryFile += ".tmp";
+}
+
+MovePlan::Writer::~Writer() {
+    if (file) {
+        std::fclose(file);
+        std::error_code ec;
+        std::filesystem::remove(temporaryFile, ec);
+    }
+}
+
+bool MovePlan::Writer::open() {
+    file = std::fopen(temporaryFile.string().c_str(), "wb");
+    if (!file) {
+        Logger::instance().error("Failed to create move plan: " + temporaryFile.string());
+        return false;
+    }
+    std::string header(planMagic.begin(), planMagic.end());
+    appendValue(header, planVersion);
+    appendValue(header, fingerprint);
+    appendValue(header, std::uint64_t{0});  // entry count
+    appendValue(header, std::uint64_t{0});  // checksum of the entries
+    appendString(header, sourceRoot.string());
+    appendString(header, targetRoot.string());
+    failed = std::fwrite(header.data(), 1, header.size(), file) != header.size();
+    return !failed;
+}
+
+void MovePlan::Writer::add(const std::filesystem::path& source, const std::filesystem::path& target,
+                           const ItemType type, const std::uint32_t ruleId, const FileMetadata& metadata) {
+    if (!file || failed) {
+        return;
+    }
+    const std::string relativeSource = source.lexically_relative(sourceRoot).string();
+    const std::string relativeTarget = target.lexically_relative(targetRoot).string();
+
+    std::string record;
+    appendValue(record, static_cast<std::uint8_t>(type));
+    appendValue(record, ruleId);
+    appendValue(record, static_cast<std::uint64_t>(metadata.sizeInBytes));
+    appendValue(record, toNanoseconds(metadata.lastModified));
+    appendValue(record, static_cast<std::uint32_t>(relativeSource.size()));
+    appendValue(record, static_cast<std::uint32_t>(relativeTarget.size()));
+    record += relativeSource;
+    record += relativeTarget;
+
+    failed = std::fwrite(record.data(), 1, record.size(), file) != record.size();
+    checksum = ScanIndex::hash(record, checksum);
+    ++entryCount;
+}
+
+bool MovePlan::Writer::finish() {
+    if (!file) {
+        return false;
+    }
+    if (!failed) {
+        failed = std::fseek(file, entryCountOffset, SEEK_SET) != 0 ||
+                 std::fwrite(&entryCount, sizeof(entryCount), 1, file) != 1 ||
+                 std::fseek(file, checksumOffset, SEEK_SET) != 0 ||
+                 std::fwrite(&checksum, sizeof(checksum), 1, file) != 1 ||
+                 std::fflush(file) != 0;
+    }
+#if defined(__unix__) || defined(__APPLE__)
+    // the plan may wait days for its maintenance window; it should survive a reboot
+    failed = failed || ::fsync(::fileno(file)) != 0;
+#endif
+    std::fclose(file);
+    file = nullptr;
+
+    std::error_code ec;
+    if (failed) {
+        Logger::instance().error("Failed to write move plan: " + temporaryFile.string());
+        std::filesystem::remove(temporaryFile, ec);
+        return false;
+    }
+    std::filesystem::rename(temporaryFile, planFile, ec);
+    if (ec) {
+        Logger::instance().error(std::format("Failed to replace move plan {}: {}", planFile.string(), ec.message()));
+        std::filesystem::remove(temporaryFile, ec);
+        return false;
+    }
+    return true;
+}
+
+MovePlan::MovePlan(std::filesystem::path planFile) : planFile(std::move(planFile)) {
+}
+
+MovePlan::~MovePlan() {
+#if defined(__unix__) || defined(__APPLE__)
+    if (mapped) {
+        ::munmap(const_cast<char*>(data), dataSize);
+    }
+#endif
+}
+
+bool MovePlan::open() {
+#if defined(__unix__) || defined(__APPLE__)
+    const int fd = ::open(planFile.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        Logger::instance().error("Failed to open move plan: " + planFile.string());
+        return false;
+    }
+    struct stat st{};
+    if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+        void* mapping = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping != MAP_FAILED) {
+            // read front to back, once to validate and once to execute
+            ::madvise(mapping, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+            data = static_cast<const char*>(mapping);
+            dataSize = static_cast<size_t>(st.st_size);
+            mapped = true;
+        }
+    }
+    ::close(fd);
+#endif
+    if (!mapped) {
+        std::ifstream in(planFile, std::ios::binary);
+        if (!in.is_open()) {
+            Logger::instance().error("Failed to open move plan: " + planFile.string());
+            return false;
+        }
+        std::ostringstream contents;
+        contents << in.rdbuf();
+        buffer = std::move(contents).str();
+        data = buffer.data();
+        dataSize = buffer.size();
+    }
+
+    const std::string_view contents(data, dataSize);
+    PlanReader reader(contents);
+    std::array<char, 4> magic{};
+    std::uint32_t version = 0;
+    std::uint64_t storedChecksum = 0;
+    std::string source;
+    std::string target;
+    if (!reader.read(magic) || magic != planMagic) {
+        Logger::instance().error("Not a move plan: " + planFile.string());
+        return false;
+    }
+    if (!reader.read(version) || version != planVersion) {
+        Logger::instance().error(std::format("Unsupported move plan version {}: {}", version, planFile.string()));
+        return false;
+    }
+    if (!reader.read(fingerprint) || !reader.read(entryCount) || !reader.read(storedChecksum) ||
+        !reader.readString(source) || !reader.readString(target)) {
+        Logger::instance().error("Truncated move plan: " + planFile.string());
+        return false;
+    }
+    sourceRoot = source;
+    targetRoot = target;
+    entriesOffset = reader.getPosition();
+
+    // one pass up front, so that executing never stops halfway through a damaged plan or
+    // touches anything outside the roots
+    std::uint64_t count = 0;
+    ruleCount = 0;
+    Entry entry;
+    while (!reader.atEnd() && reader.readEntry(entry) && staysInsideRoot(entry.source) && staysInsideRoot(entry.target)) {
+        ruleCount = std::max<std::uint64_t>(ruleCount, std::uint64_t{entry.ruleId} + 1);
+        ++count;
+    }
+    if (!reader.atEnd() || count != entryCount ||
+        ScanIndex::hash(contents.substr(entriesOffset)) != storedChecksum) {
+        Logger::instance().error("Corrupt move plan: " + planFile.string());
+        return false;
+    }
+    return true;
+}
+
+void MovePlan::forEachEntry(const std::function<void(const Entry&)>& visit) const {
+    PlanReader reader(std::string_view(data, dataSize), entriesOffset);
+    Entry entry;
+    while (!reader.atEnd() && reader.readEntry(entry)) {
+        visit(entry);
+    }
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <functional>
+#include <cstdio>
+#include <cstdint>
+#include "models/ItemType.h"
+#include "models/FileMetadata.h"
+
+// The moves a scan decided on, written to a binary file so that they can be applied later
+// without scanning again. Entries are streamed to the file as the scan finds them; paths
+// are stored relative to the plan's source and target roots.
+//
+// A plan is read through a read-only memory mapping. open() validates the whole file once,
+// after which forEachEntry() hands out views straight into the mapping.
+class MovePlan {
+public:
+    struct Entry {
+        ItemType type = ItemType::File;
+        std::uint32_t ruleId = 0;  // position of the matching rule in priority order
+        std::uint64_t size = 0;
+        std::int64_t modifiedNanoseconds = 0;
+        std::string_view source;  // relative to the source root
+        std::string_view target;  // relative to the target root
+
+        // Whether the item still is what was planned: same type, size and mtime
+        bool matches(const FileMetadata& metadata) const;
+    };
+
+    // Writes a plan next to planFile and renames it into place once finished, so a scan that
+    // dies never leaves a truncated plan behind
+    class Writer {
+    public:
+        Writer(std::filesystem::path planFile, std::uint64_t fingerprint,
+               std::filesystem::path sourceRoot, std::filesystem::path targetRoot);
+        // discards an unfinished plan
+        ~Writer();
+
+        Writer(const Writer&) = delete;
+        Writer& operator=(const Writer&) = delete;
+
+        bool open();
+        // Not thread-safe; the organizer adds entries from its move stage only
+        void add(const std::filesystem::path& source, const std::filesystem::path& target, ItemType type,
+                 std::uint32_t ruleId, const FileMetadata& metadata);
+        // Fill in the header, flush and replace planFile
+        bool finish();
+
+        size_t getEntryCount() const { return entryCount; }
+
+    private:
+        std::filesystem::path planFile;
+        std::filesystem::path temporaryFile;
+        std::uint64_t fingerprint;
+        std::filesystem::path sourceRoot;
+        std::filesystem::path targetRoot;
+        std::FILE* file = nullptr;
+        std::uint64_t entryCount = 0;
+        std::uint64_t checksum;
+        bool failed = false;
+    };
+
+    explicit MovePlan(std::filesystem::path planFile);
+    ~MovePlan();
+
+    MovePlan(const MovePlan&) = delete;
+    MovePlan& operator=(const MovePlan&) = delete;
+
+    // Map the plan and validate it. Returns false if it is missing, truncated or corrupt,
+    // which includes paths that are absolute or lead out of their root with "..".
+    bool open();
+
+    // Identifies the roots and rule set the plan was made for
+    std::uint64_t getFingerprint() const { return fingerprint; }
+    const std::filesystem::path& getSourceRoot() const { return sourceRoot; }
+    const std::filesystem::path& getTargetRoot() const { return targetRoot; }
+    size_t size() const { return entryCount; }
+    // One more than the highest rule id of any entry; executing needs at least this many rules
+    std::uint64_t getRuleCount() const { return ruleCount; }
+
+    // Visit the entries in the order they were planned; the views live as long as the plan
+    void forEachEntry(const std::function<void(const Entry&)>& visit) const;
+
+    const std::filesystem::path& getPlanFile() const { return planFile; }
+
+private:
+    std::filesystem::path planFile;
+    const char* data = nullptr;
+    size_t dataSize = 0;
+    bool mapped = false;
+    std::string buffer;  // holds the file where it can't be mapped
+    size_t entriesOffset = 0;
+    std::uint64_t entryCount = 0;
+    std::uint64_t ruleCount = 0;
+    std::uint64_t fingerprint = 0;
+    std::filesystem::path sourceRoot;
+    std::filesystem::path targetRoot;
+};
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <cstddef>
+#include <cstdint>
+#include <bit>
+
+// Fixed-capacity lock-free queue for many producers and a single consumer. Every slot
+// carries a sequence number that tells producers whether it is free and the consumer
+// whether it is filled, so a push is one compare-and-swap on the shared position and
+// a pop touches no shared counter at all. Unlike BoundedQueue nothing ever blocks:
+// tryPush() fails when the ring is full and tryPop() when it is empty.
+template<typename T>
+class MpscRingBuffer {
+public:
+    // The capacity is rounded up to a power of two
+    explicit MpscRingBuffer(size_t capacity)
+        : capacity(std::bit_ceil(capacity > 1 ? capacity : 2)), mask(this->capacity - 1),
+          slots(std::make_unique<Slot[]>(this->capacity)) {
+        for (size_t i = 0; i < this->capacity; ++i) {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscRingBuffer(const MpscRingBuffer&) = delete;
+    MpscRingBuffer& operator=(const MpscRingBuffer&) = delete;
+
+    // Safe from any thread. item is only moved from when the push succeeds.
+    bool tryPush(T&& item) {
+        size_t position = enqueuePosition.load(std::memory_order_relaxed);
+        while (true) {
+            Slot& slot = slots[position & mask];
+            const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            const auto distance = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position);
+            if (distance == 0) {
+                // the slot is free for this position; claim it unless another producer was faster
+                if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    slot.value = std::move(item);
+                    slot.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (distance < 0) {
+                return false;  // the consumer has not freed this slot yet: full
+            } else {
+                position = enqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Consumer thread only
+    std::optional<T> tryPop() {
+        Slot& slot = slots[dequeuePosition & mask];
+        if (slot.sequence.load(std::memory_order_acquire) != dequeuePosition + 1) {
+            return std::nullopt;  // empty, or the producer of the next item is still writing it
+        }
+        T item = std::move(slot.value);
+        slot.sequence.store(dequeuePosition + capacity, std::memory_order_release);
+        ++dequeuePosition;
+        return item;
+    }
+
+    size_t getCapacity() const { return capacity; }
+
+private:
+    // a slot per cache line so producers filling neighbouring slots don't contend
+    struct alignas(64) Slot {
+        std::atomic<size_t> sequence{0};
+        T value{};
+    };
+
+    const size_t capacity;
+    const size_t mask;
+    std::unique_ptr<Slot[]> slots;
+    alignas(64) std::atomic<size_t> enqueuePosition{0};
+    alignas(64) size_t dequeuePosition = 0;
+};
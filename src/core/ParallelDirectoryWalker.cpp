@@ -0,0 +1,327 @@
+#include "core/ParallelDirectoryWalker.h"
+#include "Logger.h"
+#include <thread>
+#include <algorithm>
+#include <chrono>
+#include <format>
+#include <system_error>
+#include <string_view>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <cerrno>
+#endif
+
+ParallelDirectoryWalker::ParallelDirectoryWalker(const size_t workerCount)
+    : workerCount(workerCount > 0 ? workerCount : std::max(1u, std::thread::hardware_concurrency())) {
+    queues.reserve(this->workerCount);
+    for (size_t i = 0; i < this->workerCount; ++i) {
+        queues.push_back(std::make_unique<WorkerQueue>());
+    }
+}
+
+void ParallelDirectoryWalker::walk(const std::filesystem::path& root, const EntryVisitor& visitor) {
+    stats = Statistics{};
+    pendingDirectories = 0;
+    queuedDirectories = 0;
+    idleWorkers = 0;
+    entriesVisited = 0;
+    directoriesScanned = 0;
+    steals = 0;
+    subtreesSkipped = 0;
+    directoriesReused = 0;
+    errors = 0;
+
+    const auto start = std::chrono::steady_clock::now();
+
+    raiseOpenFileLimit();
+    pushDirectory(0, PendingDirectory{nullptr, root.string()});
+
+    // the calling thread acts as worker 0
+    std::vector<std::jthread> threads;
+    threads.reserve(workerCount - 1);
+    for (size_t i = 1; i < workerCount; ++i) {
+        threads.emplace_back([this, i, &visitor] { workerLoop(i, visitor); });
+    }
+    workerLoop(0, visitor);
+    threads.clear();
+
+    stats.entriesVisited = entriesVisited;
+    stats.directoriesScanned = directoriesScanned;
+    stats.steals = steals;
+    stats.subtreesSkipped = subtreesSkipped;
+    stats.directoriesReused = directoriesReused;
+    stats.errors = errors;
+    stats.elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void ParallelDirectoryWalker::setListingHooks(ListingOverride listingOverride, ListingObserver listingObserver) {
+    this->listingOverride = std::move(listingOverride);
+    this->listingObserver = std::move(listingObserver);
+}
+
+void ParallelDirectoryWalker::workerLoop(const size_t workerIndex, const EntryVisitor& visitor) {
+    while (true) {
+        PendingDirectory pending;
+        if (popLocal(workerIndex, pending) || steal(workerIndex, pending)) {
+            auto directory = pending.parent
+                ? std::make_shared<const DirectoryHandle>(*pending.parent, pending.name, DirectoryHandle::Access::List)
+                : std::make_shared<const DirectoryHandle>(pending.name, DirectoryHandle::Access::List);
+            const int openError = errno;
+            // the parent's descriptor closes as soon as its last queued child is open
+            pending = PendingDirectory{};
+            processDirectory(workerIndex, directory, openError, visitor);
+            finishDirectory();
+            continue;
+        }
+
+        // nothing to do locally or to steal: sleep until new work appears or the walk is over
+        std::unique_lock lock(idleMutex);
+        ++idleWorkers;
+        idleCondition.wait(lock, [this] {
+            return pendingDirectories == 0 || queuedDirectories > 0;
+        });
+        --idleWorkers;
+        if (pendingDirectories == 0) {
+            return;
+        }
+    }
+}
+
+void ParallelDirectoryWalker::processDirectory(const size_t workerIndex,
+                                               const std::shared_ptr<const DirectoryHandle>& directory,
+                                               const int openError, const EntryVisitor& visitor) {
+    try {
+        if (listingOverride) {
+            if (const auto subdirectories = listingOverride(directory->getPath())) {
+                ++directoriesReused;
+                for (const auto& name : *subdirectories) {
+                    pushDirectory(workerIndex, PendingDirectory{directory, name});
+                }
+                return;
+            }
+        }
+
+        std::vector<std::string> subdirectories;
+        if (scanDirectory(workerIndex, directory, openError, visitor, listingObserver ? &subdirectories : nullptr) &&
+            listingObserver) {
+            listingObserver(directory->getPath(), std::move(subdirectories));
+        }
+    } catch (const std::exception& e) {
+        Logger::instance().error("Error processing directory " + directory->getPath().string() + ": " + e.what());
+        ++errors;
+    }
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+
+namespace {
+
+struct DirCloser {
+    void operator()(DIR* dir) const { ::closedir(dir); }
+};
+
+// dirent types that classify an entry without a stat; symlinks are followed like
+// std::filesystem::status, so they need one
+std::optional<ItemType> itemTypeFromDirent(const unsigned char direntType) {
+    switch (direntType) {
+        case DT_REG:
+            return ItemType::File;
+        case DT_DIR:
+            return ItemType::Directory;
+        case DT_LNK:
+        case DT_UNKNOWN:
+            return std::nullopt;
+        default:
+            return ItemType::Other;
+    }
+}
+
+} // namespace
+
+bool ParallelDirectoryWalker::scanDirectory(const size_t workerIndex,
+                                            const std::shared_ptr<const DirectoryHandle>& directory,
+                                            const int openError, const EntryVisitor& visitor,
+                                            std::vector<std::string>* subdirectories) {
+    const std::filesystem::path& path = directory->getPath();
+    // fdopendir() takes over the descriptor it is given; the handle keeps its own for the children
+    std::unique_ptr<DIR, DirCloser> dir;
+    int error = openError;
+    if (directory->isValid()) {
+        const int listFd = ::fcntl(directory->getFd(), F_DUPFD_CLOEXEC, 0);
+        dir.reset(listFd >= 0 ? ::fdopendir(listFd) : nullptr);
+        error = errno;
+        if (listFd >= 0 && !dir) {
+            ::close(listFd);
+        }
+    }
+    if (!dir) {
+        // a directory that vanished since it was queued (e.g. moved by a rule) is not an error
+        if (error == ENOENT) {
+            Logger::instance().debug("Directory disappeared before scan: " + path.string());
+        } else if (error == EACCES) {
+            Logger::instance().warning("Permission denied, skipping directory: " + path.string());
+        } else {
+            Logger::instance().error(std::format("Failed to scan directory {}: {}", path.string(),
+                                                 std::generic_category().message(error)));
+            ++errors;
+        }
+        return false;
+    }
+    ++directoriesScanned;
+
+    while (true) {
+        errno = 0;
+        const dirent* direntry = ::readdir(dir.get());
+        if (!direntry) {
+            break;
+        }
+        const std::string_view name(direntry->d_name);
+        if (name == "." || name == "..") {
+            continue;
+        }
+
+        const ScanEntry entry{directory, std::string(name), itemTypeFromDirent(direntry->d_type)};
+
+        // only DT_UNKNOWN needs a stat to decide whether to descend; symlinks are never followed
+        bool isDirectory = direntry->d_type == DT_DIR;
+        if (direntry->d_type == DT_UNKNOWN) {
+            struct stat st{};
+            isDirectory = ::fstatat(directory->getFd(), direntry->d_name, &st, AT_SYMLINK_NOFOLLOW) == 0 &&
+                          S_ISDIR(st.st_mode);
+        }
+        if (visitEntry(workerIndex, entry, isDirectory, visitor) && subdirectories) {
+            subdirectories->emplace_back(name);
+        }
+    }
+    if (errno != 0) {
+        Logger::instance().error(std::format("Error while scanning directory {}: {}", path.string(),
+                                             std::generic_category().message(errno)));
+        ++errors;
+        return false;
+    }
+    return true;
+}
+
+#else
+
+bool ParallelDirectoryWalker::scanDirectory(const size_t workerIndex,
+                                            const std::shared_ptr<const DirectoryHandle>& directory,
+                                            const int, const EntryVisitor& visitor,
+                                            std::vector<std::string>* subdirectories) {
+    // no *at() calls here: the handle only carries the path
+    const std::filesystem::path& path = directory->getPath();
+    std::error_code ec;
+    std::filesystem::directory_iterator it(path, std::filesystem::directory_options::skip_permission_denied, ec);
+    if (ec) {
+        // a directory that vanished since it was queued (e.g. moved by a rule) is not an error
+        if (ec == std::errc::no_such_file_or_directory) {
+            Logger::instance().debug("Directory disappeared before scan: " + path.string());
+        } else {
+            Logger::instance().error(std::format("Failed to scan directory {}: {}", path.string(), ec.message()));
+            ++errors;
+        }
+        return false;
+    }
+    ++directoriesScanned;
+
+    for (const std::filesystem::directory_iterator end; it != end; it.increment(ec)) {
+        std::error_code typeEc;
+        const bool isSymlink = it->is_symlink(typeEc);
+        ScanEntry entry{directory, it->path().filename().string(), std::nullopt};
+        if (!isSymlink) {
+            entry.type = it->is_regular_file(typeEc) ? ItemType::File
+                       : it->is_directory(typeEc) ? ItemType::Directory
+                       : ItemType::Other;
+        }
+        if (visitEntry(workerIndex, entry, entry.type == ItemType::Directory, visitor) && subdirectories) {
+            subdirectories->push_back(entry.name);
+        }
+    }
+    if (ec) {
+        Logger::instance().error(std::format("Error while scanning directory {}: {}", path.string(), ec.message()));
+        ++errors;
+        return false;
+    }
+    return true;
+}
+
+#endif
+
+bool ParallelDirectoryWalker::visitEntry(const size_t workerIndex, const ScanEntry& entry, const bool isDirectory,
+                                         const EntryVisitor& visitor) {
+    ++entriesVisited;
+
+    WalkAction action = WalkAction::Continue;
+    try {
+        action = visitor(entry);
+    } catch (const std::exception& e) {
+        Logger::instance().error("Error visiting " + entry.path().string() + ": " + e.what());
+        ++errors;
+    }
+
+    if (!isDirectory) {
+        return false;
+    }
+    if (action == WalkAction::SkipSubtree) {
+        ++subtreesSkipped;
+        return false;
+    }
+    // queued only after the visit so a directory is always reported before its children
+    pushDirectory(workerIndex, PendingDirectory{entry.directory, entry.name});
+    return true;
+}
+
+void ParallelDirectoryWalker::pushDirectory(const size_t workerIndex, PendingDirectory directory) {
+    ++pendingDirectories;
+    {
+        std::lock_guard lock(queues[workerIndex]->mutex);
+        queues[workerIndex]->directories.push_back(std::move(directory));
+    }
+    ++queuedDirectories;
+
+    if (idleWorkers > 0) {
+        std::lock_guard lock(idleMutex);
+        idleCondition.notify_one();
+    }
+}
+
+bool ParallelDirectoryWalker::popLocal(const size_t workerIndex, PendingDirectory& directory) {
+    auto& queue = *queues[workerIndex];
+    std::lock_guard lock(queue.mutex);
+    if (queue.directories.empty()) {
+        return false;
+    }
+    // newest first keeps a worker on the subtree it is already in
+    directory = std::move(queue.directories.back());
+    queue.directories.pop_back();
+    --queuedDirectories;
+    return true;
+}
+
+bool ParallelDirectoryWalker::steal(const size_t workerIndex, PendingDirectory& directory) {
+    for (size_t offset = 1; offset < workerCount; ++offset) {
+        auto& victim = *queues[(workerIndex + offset) % workerCount];
+        std::lock_guard lock(victim.mutex);
+        if (victim.directories.empty()) {
+            continue;
+        }
+        // oldest first: directories near the root carry the most remaining work
+        directory = std::move(victim.directories.front());
+        victim.directories.pop_front();
+        --queuedDirectories;
+        ++steals;
+        return true;
+    }
+    return false;
+}
+
+void ParallelDirectoryWalker::finishDirectory() {
+    if (--pendingDirectories == 0) {
+        std::lock_guard lock(idleMutex);
+        idleCondition.notify_all();
+    }
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <filesystem>
+#include <functional>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include "models/ItemType.h"
+#include "core/FileOperations.h"
+
+// One directory entry as reported by readdir(), named relative to the directory it was
+// listed from. That directory stays open while the entry is in flight, so the entry can be
+// stat'ed and renamed with *at() calls; the full path is only composed where one is needed.
+struct ScanEntry {
+    // nullptr when name is a full path, e.g. for items reported by a file watcher
+    std::shared_ptr<const DirectoryHandle> directory;
+    std::string name;
+    // type from the dirent; nullopt for symlinks and DT_UNKNOWN, which need a stat to classify
+    std::optional<ItemType> type;
+
+    static ScanEntry fromPath(const std::filesystem::path& path) { return {nullptr, path.string(), std::nullopt}; }
+
+    std::filesystem::path path() const { return directory ? directory->getPath() / name : std::filesystem::path(name); }
+};
+
+// What the walker should do after visiting an entry
+enum class WalkAction {
+    Continue,     // descend into the entry if it is a directory
+    SkipSubtree   // never list the entry's children
+};
+
+// Multi-threaded directory tree walker. Every worker owns a deque of pending
+// directories; it pops its own work from the back and steals from the front of
+// other workers' deques when it runs dry. Each directory is opened relative to its
+// parent's descriptor, listed with fdopendir() and its entries classified with fstatat(),
+// so the kernel never resolves a full path during the walk.
+class ParallelDirectoryWalker {
+public:
+    // Called from worker threads for every entry below the root (root excluded)
+    using EntryVisitor = std::function<WalkAction(const ScanEntry& entry)>;
+    // Consulted before a directory is listed. Returning the names of its subdirectories
+    // skips the listing and queues those instead; nullopt lists the directory as usual.
+    using ListingOverride = std::function<std::optional<std::vector<std::string>>(const std::filesystem::path& directory)>;
+    // Called after a directory was listed completely, with the subdirectories queued from it
+    using ListingObserver = std::function<void(const std::filesystem::path& directory,
+                                               std::vector<std::string> subdirectories)>;
+
+    struct Statistics {
+        size_t entriesVisited = 0;
+        size_t directoriesScanned = 0;
+        size_t steals = 0;
+        size_t subtreesSkipped = 0;
+        size_t directoriesReused = 0;  // listings replaced by the ListingOverride
+        size_t errors = 0;
+        double elapsedSeconds = 0.0;
+    };
+
+    // A worker count of 0 selects std::thread::hardware_concurrency()
+    explicit ParallelDirectoryWalker(size_t workerCount = 0);
+    ~ParallelDirectoryWalker() = default;
+
+    ParallelDirectoryWalker(const ParallelDirectoryWalker&) = delete;
+    ParallelDirectoryWalker& operator=(const ParallelDirectoryWalker&) = delete;
+
+    // Walk the tree below root and block until every directory has been listed
+    void walk(const std::filesystem::path& root, const EntryVisitor& visitor);
+
+    // Install hooks used by subsequent walks; either may be empty
+    void setListingHooks(ListingOverride listingOverride, ListingObserver listingObserver);
+
+    const Statistics& getStatistics() const { return stats; }
+    size_t getWorkerCount() const { return workerCount; }
+
+private:
+    // A directory waiting to be listed: name inside parent, or the root when parent is nullptr
+    struct PendingDirectory {
+        std::shared_ptr<const DirectoryHandle> parent;
+        std::string name;
+    };
+
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<PendingDirectory> directories;
+    };
+
+    size_t workerCount;
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    Statistics stats;
+    ListingOverride listingOverride;
+    ListingObserver listingObserver;
+
+    // directories queued or currently being listed; the walk ends when this reaches 0
+    std::atomic<size_t> pendingDirectories{0};
+    // directories sitting in a deque, used to wake idle workers
+    std::atomic<size_t> queuedDirectories{0};
+    std::atomic<size_t> idleWorkers{0};
+    std::atomic<size_t> entriesVisited{0};
+    std::atomic<size_t> directoriesScanned{0};
+    std::atomic<size_t> steals{0};
+    std::atomic<size_t> subtreesSkipped{0};
+    std::atomic<size_t> directoriesReused{0};
+    std::atomic<size_t> errors{0};
+    std::mutex idleMutex;
+    std::condition_variable idleCondition;
+
+    void workerLoop(size_t workerIndex, const EntryVisitor& visitor);
+    // openError is errno from opening directory, reported if the handle is invalid
+    void processDirectory(size_t workerIndex, const std::shared_ptr<const DirectoryHandle>& directory, int openError,
+                          const EntryVisitor& visitor);
+    // Returns false if the directory could not be listed completely
+    bool scanDirectory(size_t workerIndex, const std::shared_ptr<const DirectoryHandle>& directory, int openError,
+                       const EntryVisitor& visitor, std::vector<std::string>* subdirectories);
+    // Returns true if the entry was queued for descent
+    bool visitEntry(size_t workerIndex, const ScanEntry& entry, bool isDirectory, const EntryVisitor& visitor);
+    void pushDirectory(size_t workerIndex, PendingDirectory directory);
+    bool popLocal(size_t workerIndex, PendingDirectory& directory);
+    bool steal(size_t workerIndex, PendingDirectory& directory);
+    void finishDirectory();
+};
@@ -2,36 +2,105 @@
 #include "conditions/ExtensionCondition.h"
 #include "conditions/SizeCondition.h"
 #include "conditions/AgeCondition.h"
+#include "conditions/NameCondition.h"
 #include "rules/ConfigurableRule.h"
 #include "core/ValueParser.h"
 #include "Logger.h"
 #include <algorithm>
+#include <array>
 #include <ranges>
+#include <string_view>
 #include <utility>
 
-RuleFactory::RuleFactory() {
-    registerDefaultConditions();
+namespace {
+
+CompiledCondition makeExtensionCondition(const std::string& value) {
+    return ExtensionCondition(value);
+}
+
+template<SizeComparison Comparison>
+CompiledCondition makeSizeCondition(const std::string& value) {
+    return SizeCondition(Comparison, parseValue<std::uintmax_t>(value));
+}
+
+template<AgeComparison Comparison>
+CompiledCondition makeAgeCondition(const std::string& value) {
+    return AgeCondition(Comparison, parseValue<std::chrono::system_clock::duration>(value));
+}
+
+template<bool IgnoreCase>
+CompiledCondition makeNameCondition(const std::string& value) {
+    return NameCondition(value, IgnoreCase);
+}
+
+struct BuiltinConditionType {
+    std::string_view key;
+    CompiledCondition (*create)(const std::string& value);
+};
+
+// Built-in condition types, fixed at compile time: each key resolves to a plain function
+// that builds its variant alternative, with no std::function or registration at runtime
+constexpr std::array builtinConditionTypes{
+    BuiltinConditionType{"EXTENSION", &makeExtensionCondition},
+    BuiltinConditionType{"SIZE_GREATER_THAN", &makeSizeCondition<SizeComparison::GreaterThan>},
+    BuiltinConditionType{"SIZE_LESS_THAN", &makeSizeCondition<SizeComparison::LessThan>},
+    BuiltinConditionType{"AGE_OLDER_THAN", &makeAgeCondition<AgeComparison::OlderThan>},
+    BuiltinConditionType{"AGE_NEWER_THAN", &makeAgeCondition<AgeComparison::NewerThan>},
+    BuiltinConditionType{"NAME_MATCHES", &makeNameCondition<false>},
+    BuiltinConditionType{"NAME_MATCHES_NOCASE", &makeNameCondition<true>},
+    // TODO: IS_EMPTY
+};
+
+const BuiltinConditionType* findBuiltinConditionType(const std::string_view key) {
+    const auto it = std::ranges::find(builtinConditionTypes, key, &BuiltinConditionType::key);
+    return it != builtinConditionTypes.end() ? &*it : nullptr;
 }
 
+} // namespace
+
+RuleFactory::RuleFactory() = default;
+
 void RuleFactory::registerConditionType(const std::string& key, ConditionCreationFunction creator) {
     conditionRegistry[key] = std::move(creator);
-    Logger::instance().debug("Registered condition type: " + key);
+    Logger::instance().debug("Registered condition type: {}", key);
 }
 
 std::unique_ptr<ICondition> RuleFactory::createCondition(const std::string& key, const std::string& value) {
-    auto it = conditionRegistry.find(key);
-    if (it == conditionRegistry.end()) {
-        Logger::instance().warning("Unknown condition type: " + key);
+    auto condition = compileCondition(key, value);
+    if (!condition) {
         return nullptr;
     }
+    return std::visit([]<typename Alternative>(Alternative&& alternative) -> std::unique_ptr<ICondition> {
+        if constexpr (BuiltinCondition<Alternative>) {
+            return std::make_unique<Alternative>(std::move(alternative));
+        } else {
+            return std::move(alternative);
+        }
+    }, std::move(*condition));
+}
+
+std::optional<CompiledCondition> RuleFactory::compileCondition(const std::string& key, const std::string& value) {
+    const auto custom = conditionRegistry.find(key);
+    const BuiltinConditionType* builtin = custom == conditionRegistry.end() ? findBuiltinConditionType(key) : nullptr;
+    if (custom == conditionRegistry.end() && !builtin) {
+        Logger::instance().warning("Unknown condition type: {}", key);
+        return std::nullopt;
+    }
     
     try {
-        auto condition = it->second(value);
-        Logger::instance().debug("Created condition: " + key + " = " + value);
+        std::optional<CompiledCondition> condition;
+        if (builtin) {
+            condition = builtin->create(value);
+        } else if (auto created = custom->second(value)) {
+            condition = std::move(created);
+        } else {
+            return std::nullopt;
+        }
+        Logger::instance().debug("Created condition: {} = {}", key, value);
         return condition;
     } catch (const std::exception& e) {
-        Logger::instance().error("Failed to create condition " + key + ": " + e.what());
-        return nullptr;
+        Logger::instance().error("Failed to create condition {}: {}", key, e.what());
+        return std::nullopt;
     }
 }
 
@@ -43,15 +112,15 @@ std::unique_ptr<ISortingRule> RuleFactory::createRule(const RuleConfig& ruleConf
     
     // add conditions to the rule
     for (const auto& [conditionKey, conditionValue] : ruleConfig.conditions) {
-        auto condition = createCondition(conditionKey, conditionValue);
+        auto condition = compileCondition(conditionKey, conditionValue);
         if (condition) {
-            rule->addCondition(std::move(condition));
+            rule->addCompiledCondition(std::move(*condition));
         } else {
-            Logger::instance().warning("Skipping invalid condition: " + conditionKey + " = " + conditionValue);
+            Logger::instance().warning("Skipping invalid condition: {} = {}", conditionKey, conditionValue);
         }
     }
     
-    Logger::instance().info("Created rule: " + ruleConfig.targetPath + " (priority: " + std::to_string(ruleConfig.priority) + ")");
+    Logger::instance().info("Created rule: {} (priority: {})", ruleConfig.targetPath, ruleConfig.priority);
     return rule;
 }
 
@@ -70,62 +139,20 @@ std::vector<std::unique_ptr<ISortingRule>> RuleFactory::createRulesFromConfig(co
         return a->getPriority() < b->getPriority();
     });
     
-    Logger::instance().info("Created " + std::to_string(rules.size()) + " rules from configuration");
+    Logger::instance().info("Created {} rules from configuration", rules.size());
     return rules;
 }
 
 std::vector<std::string> RuleFactory::getRegisteredConditionTypes() const {
     std::vector<std::string> types;
+    for (const auto& type : builtinConditionTypes) {
+        if (!conditionRegistry.contains(std::string(type.key))) {
+            types.emplace_back(type.key);
+        }
+    }
     for (const auto &key: conditionRegistry | std::views::keys) {
         types.push_back(key);
     }
+    std::ranges::sort(types);
     return types;
 }
-
-void RuleFactory::registerDefaultConditions() {
-    // register extension condition
-    registerConditionType("EXTENSION", [](const std::string& value) -> std::unique_ptr<ICondition> {
-        std::string normalizedExt = normalizeExtension(value);
-        return std::make_unique<ExtensionCondition>(normalizedExt);
-    });
-    
-    // register size conditions using template parsing
-    registerConditionType("SIZE_GREATER_THAN", [](const std::string& value) -> std::unique_ptr<ICondition> {
-        auto sizeThreshold = parseValue<std::uintmax_t>(value);
-        return std::make_unique<SizeCondition>(SizeComparison::GreaterThan, sizeThreshold);
-    });
-    
-    registerConditionType("SIZE_LESS_THAN", [](const std::string& value) -> std::unique_ptr<ICondition> {
-        auto sizeThreshold = parseValue<std::uintmax_t>(value);
-        return std::make_unique<SizeCondition>(SizeComparison::LessThan, sizeThreshold);
-    });
-    
-    // register age conditions using template parsing
-    registerConditionType("AGE_OLDER_THAN", [](const std::string& value) -> std::unique_ptr<ICondition> {
-        auto ageThreshold = parseValue<std::chrono::system_clock::duration>(value);
-        return std::make_unique<AgeCondition>(AgeComparison::OlderThan, ageThreshold);
-    });
-    
-    registerConditionType("AGE_NEWER_THAN", [](const std::string& value) -> std::unique_ptr<ICondition> {
-        auto ageThreshold = parseValue<std::chrono::system_clock::duration>(value);
-        return std::make_unique<AgeCondition>(AgeComparison::NewerThan, ageThreshold);
-    });
-    
-    // TODO: Register remaining condition types
-    // registerConditionType("NAME_MATCHES", [...]);
-    // registerConditionType("IS_EMPTY", [...]);
-}
-
-std::string RuleFactory::normalizeExtension(const std::string& extension) {
-    std::string normalized = extension;
-    
-    // ensure extension starts with a dot
-    if (!normalized.empty() && normalized[0] != '.') {
-        normalized = "." + normalized;
-    }
-    
-    // convert to lowercase for case-insensitive comparison
-    std::ranges::transform(normalized, normalized.begin(), tolower);
-    
-    return normalized;
-} 
\ No newline at end of file
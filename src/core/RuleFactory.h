@@ -4,8 +4,10 @@
 #include <map>
 #include <functional>
 #include <string>
+#include <optional>
 #include "rules/ISortingRule.h"
 #include "conditions/ICondition.h"
+#include "conditions/CompiledCondition.h"
 #include "ConfigurationParser.h"
 
 class RuleFactory {
@@ -15,12 +17,16 @@ public:
     RuleFactory();
     ~RuleFactory() = default;
     
-    // Register a condition type with its creation function
+    // Register a custom condition type with its creation function; it takes precedence over
+    // a built-in type with the same key
     void registerConditionType(const std::string& key, ConditionCreationFunction creator);
     
     // Create a condition from configuration data
     std::unique_ptr<ICondition> createCondition(const std::string& key, const std::string& value);
     
+    // Create a condition in the form rules store it, nullopt if the key is unknown or the value invalid
+    std::optional<CompiledCondition> compileCondition(const std::string& key, const std::string& value);
+    
     // Create a sorting rule from configuration data
     std::unique_ptr<ISortingRule> createRule(const RuleConfig& ruleConfig);
     
@@ -31,11 +37,6 @@ public:
     std::vector<std::string> getRegisteredConditionTypes() const;
 
 private:
+    // custom condition types only; the built-in ones are a compile-time table
     std::map<std::string, ConditionCreationFunction> conditionRegistry;
-    
-    // Initialize default condition types
-    void registerDefaultConditions();
-    
-    // Helper methods for parsing values
-    static std::string normalizeExtension(const std::string& extension);
 }; 
\ No newline at end of file
@@ -0,0 +1,212 @@
+#include "core/ScanIndex.h"
+#include "Logger.h"
+#include <fstream>
+#include <chrono>
+#include <array>
+#include <ranges>
+#include <format>
+#include <system_error>
+
+namespace {
+
+constexpr std::array<char, 4> indexMagic{'F', 'O', 'S', 'I'};
+constexpr std::uint32_t indexVersion = 1;
+// guards against allocating absurd sizes from a corrupt file
+constexpr std::uint32_t maxStringLength = 1u << 16;
+
+std::int64_t toNanoseconds(const std::filesystem::file_time_type time) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+template<typename T>
+void writeValue(std::ostream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void writeString(std::ostream& out, const std::string& text) {
+    writeValue(out, static_cast<std::uint32_t>(text.size()));
+    out.write(text.data(), static_cast<std::streamsize>(text.size()));
+}
+
+template<typename T>
+bool readValue(std::istream& in, T& value) {
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(value)));
+}
+
+bool readString(std::istream& in, std::string& text) {
+    std::uint32_t length = 0;
+    if (!readValue(in, length) || length > maxStringLength) {
+        return false;
+    }
+    text.resize(length);
+    return static_cast<bool>(in.read(text.data(), length));
+}
+
+} // namespace
+
+bool ScanIndex::DirectoryRecord::matches(const FileMetadata& metadata) const {
+    return metadata.type == ItemType::Directory &&
+           modifiedNanoseconds == toNanoseconds(metadata.lastModified) &&
+           changedNanoseconds == toNanoseconds(metadata.lastStatusChange) &&
+           inode == metadata.inode &&
+           device == metadata.device;
+}
+
+ScanIndex::ScanIndex(std::filesystem::path indexFile, const std::uint64_t fingerprint)
+    : indexFile(std::move(indexFile)), fingerprint(fingerprint) {
+}
+
+bool ScanIndex::load() {
+    std::lock_guard lock(mutex);
+    previous.clear();
+
+    std::ifstream in(indexFile, std::ios::binary);
+    if (!in.is_open()) {
+        Logger::instance().debug("No scan index at " + indexFile.string() + ", listing every directory");
+        return false;
+    }
+
+    std::array<char, 4> magic{};
+    std::uint32_t version = 0;
+    std::uint64_t storedFingerprint = 0;
+    std::uint64_t count = 0;
+    if (!in.read(magic.data(), magic.size()) || magic != indexMagic ||
+        !readValue(in, version) || version != indexVersion ||
+        !readValue(in, storedFingerprint) || !readValue(in, count)) {
+        Logger::instance().warning("Ignoring unreadable scan index: " + indexFile.string());
+        return false;
+    }
+    if (storedFingerprint != fingerprint) {
+        Logger::instance().info("Rules changed since the scan index was written, listing every directory");
+        return false;
+    }
+
+    std::unordered_map<std::string, DirectoryRecord> records;
+    for (std::uint64_t i = 0; i < count; ++i) {
+        std::string key;
+        DirectoryRecord record;
+        std::uint32_t subdirectoryCount = 0;
+        bool ok = readString(in, key) &&
+                  readValue(in, record.modifiedNanoseconds) &&
+                  readValue(in, record.changedNanoseconds) &&
+                  readValue(in, record.inode) &&
+                  readValue(in, record.device) &&
+                  readValue(in, subdirectoryCount);
+        for (std::uint32_t j = 0; ok && j < subdirectoryCount; ++j) {
+            ok = readString(in, record.subdirectories.emplace_back());
+        }
+        if (!ok) {
+            Logger::instance().warning("Ignoring truncated scan index: " + indexFile.string());
+            return false;
+        }
+        records.emplace(std::move(key), std::move(record));
+    }
+
+    previous = std::move(records);
+    Logger::instance().debug(std::format("Loaded {} directories from scan index {}", previous.size(), indexFile.string()));
+    return true;
+}
+
+bool ScanIndex::save() const {
+    std::lock_guard lock(mutex);
+
+    // written next to the index and renamed over it so a crash never leaves a torn index
+    std::filesystem::path temporaryFile = indexFile;
+    temporaryFile += ".tmp";
+    {
+        std::ofstream out(temporaryFile, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) {
+            Logger::instance().error("Failed to write scan index: " + temporaryFile.string());
+            return false;
+        }
+
+        std::uint64_t count = 0;
+        for (const auto& pending : current | std::views::values) {
+            count += pending.complete && !pending.invalidated;
+        }
+        out.write(indexMagic.data(), indexMagic.size());
+        writeValue(out, indexVersion);
+        writeValue(out, fingerprint);
+        writeValue(out, count);
+
+        for (const auto& [key, pending] : current) {
+            if (!pending.complete || pending.invalidated) {
+                continue;
+            }
+            const DirectoryRecord& record = pending.record;
+            writeString(out, key);
+            writeValue(out, record.modifiedNanoseconds);
+            writeValue(out, record.changedNanoseconds);
+            writeValue(out, record.inode);
+            writeValue(out, record.device);
+            writeValue(out, static_cast<std::uint32_t>(record.subdirectories.size()));
+            for (const auto& name : record.subdirectories) {
+                writeString(out, name);
+            }
+        }
+        if (!out.flush()) {
+            Logger::instance().error("Failed to write scan index: " + temporaryFile.string());
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(temporaryFile, indexFile, ec);
+    if (ec) {
+        Logger::instance().error(std::format("Failed to replace scan index {}: {}", indexFile.string(), ec.message()));
+        std::filesystem::remove(temporaryFile, ec);
+        return false;
+    }
+    return true;
+}
+
+std::optional<std::vector<std::string>> ScanIndex::beginDirectory(const std::string& key, const FileMetadata& metadata) {
+    std::lock_guard lock(mutex);
+
+    if (const auto it = previous.find(key); it != previous.end() && it->second.matches(metadata)) {
+        current[key] = PendingRecord{it->second, true, false};
+        return it->second.subdirectories;
+    }
+
+    PendingRecord& pending = current[key];
+    pending.record.modifiedNanoseconds = toNanoseconds(metadata.lastModified);
+    pending.record.changedNanoseconds = toNanoseconds(metadata.lastStatusChange);
+    pending.record.inode = metadata.inode;
+    pending.record.device = metadata.device;
+    return std::nullopt;
+}
+
+void ScanIndex::completeDirectory(const std::string& key, std::vector<std::string> subdirectories) {
+    std::lock_guard lock(mutex);
+    if (const auto it = current.find(key); it != current.end()) {
+        it->second.record.subdirectories = std::move(subdirectories);
+        it->second.complete = true;
+    }
+}
+
+void ScanIndex::invalidate(const std::string& key) {
+    std::lock_guard lock(mutex);
+    current[key].invalidated = true;
+}
+
+size_t ScanIndex::getPreviousSize() const {
+    std::lock_guard lock(mutex);
+    return previous.size();
+}
+
+size_t ScanIndex::getRecordedSize() const {
+    std::lock_guard lock(mutex);
+    size_t count = 0;
+    for (const auto& pending : current | std::views::values) {
+        count += pending.complete && !pending.invalidated;
+    }
+    return count;
+}
+
+std::uint64_t ScanIndex::hash(const std::string_view text, std::uint64_t seed) {
+    for (const unsigned char c : text) {
+        seed ^= c;
+        seed *= 1099511628211ull;
+    }
+    return seed;
+}
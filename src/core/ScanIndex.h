@@ -0,0 +1,73 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <optional>
+#include <mutex>
+#include <cstdint>
+#include "models/FileMetadata.h"
+
+// Directory listings remembered between runs. A directory's mtime and ctime change whenever
+// an entry is added, removed or renamed in it, so a directory whose timestamps and identity
+// are unchanged since a run that left every entry in place holds nothing new: the next run
+// queues its recorded subdirectories without listing it again.
+//
+// Directories are keyed by their path relative to the scan root. All methods are thread-safe.
+class ScanIndex {
+public:
+    struct DirectoryRecord {
+        std::int64_t modifiedNanoseconds = 0;
+        std::int64_t changedNanoseconds = 0;
+        std::uint64_t inode = 0;
+        std::uint64_t device = 0;
+        // subdirectories the walker descended into (claimed and pruned ones are left out)
+        std::vector<std::string> subdirectories;
+
+        bool matches(const FileMetadata& metadata) const;
+    };
+
+    // The fingerprint identifies the rule set; records written for other rules are ignored
+    ScanIndex(std::filesystem::path indexFile, std::uint64_t fingerprint);
+
+    // Load the previous run's records. Returns false if there are none usable (missing,
+    // corrupt or written for a different rule set), in which case every directory is listed.
+    bool load();
+
+    // Atomically replace the index file with the records collected during this run
+    bool save() const;
+
+    // Called before a directory is listed. Returns the recorded subdirectories if the
+    // directory is unchanged since the previous run, nullopt if it has to be listed.
+    std::optional<std::vector<std::string>> beginDirectory(const std::string& key, const FileMetadata& metadata);
+
+    // Record the subdirectories found by listing a directory passed to beginDirectory()
+    void completeDirectory(const std::string& key, std::vector<std::string> subdirectories);
+
+    // An entry of the directory matched a rule, so it has to be listed again next run
+    void invalidate(const std::string& key);
+
+    size_t getPreviousSize() const;
+    // Records save() would write
+    size_t getRecordedSize() const;
+
+    const std::filesystem::path& getIndexFile() const { return indexFile; }
+
+    // FNV-1a, stable across builds so fingerprints survive a rebuild
+    static std::uint64_t hash(std::string_view text, std::uint64_t seed = 14695981039346656037ull);
+
+private:
+    struct PendingRecord {
+        DirectoryRecord record;
+        bool complete = false;
+        bool invalidated = false;
+    };
+
+    std::filesystem::path indexFile;
+    std::uint64_t fingerprint;
+    mutable std::mutex mutex;
+    std::unordered_map<std::string, DirectoryRecord> previous;
+    std::unordered_map<std::string, PendingRecord> current;
+};
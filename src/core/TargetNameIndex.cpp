@@ -0,0 +1,78 @@
+#include "core/TargetNameIndex.h"
+#include "Logger.h"
+#include <format>
+#include <system_error>
+
+std::filesystem::path TargetNameIndex::reserveUniqueTarget(const std::filesystem::path& targetPath, const bool verifyOnDisk) {
+    const std::filesystem::path directory = targetPath.parent_path();
+    const std::string key = directory.string();
+
+    std::unique_lock lock(mutex);
+    if (!directories.contains(key)) {
+        // list without blocking lookups in other directories; if another thread indexed the
+        // directory in the meantime its listing is kept
+        lock.unlock();
+        DirectoryNames listed = listDirectory(directory);
+        lock.lock();
+        directories.try_emplace(key, std::move(listed));
+    }
+    lock.unlock();
+
+    while (true) {
+        std::filesystem::path candidate = reserveNextName(key, targetPath);
+        // the listing may be stale if another process writes into the directory; the name
+        // stays reserved either way, so the check needs no lock
+        std::error_code ec;
+        if (!verifyOnDisk || !std::filesystem::exists(candidate, ec)) {
+            return candidate;
+        }
+    }
+}
+
+std::filesystem::path TargetNameIndex::reserveNextName(const std::string& key, const std::filesystem::path& targetPath) {
+    const std::string fileName = targetPath.filename().string();
+    const std::string stem = targetPath.stem().string();
+    const std::string extension = targetPath.extension().string();
+
+    std::lock_guard lock(mutex);
+    // an entry dropped by clear() since the listing starts over empty
+    DirectoryNames& entry = directories.try_emplace(key).first->second;
+    entry.names.insert(fileName);
+
+    size_t& suffix = entry.nextSuffix.try_emplace(fileName, 1).first->second;
+    while (true) {
+        std::string candidate = std::format("{}_{:03}{}", stem, suffix++, extension);
+        if (entry.names.insert(candidate).second) {
+            return targetPath.parent_path() / candidate;
+        }
+    }
+}
+
+void TargetNameIndex::recordName(const std::filesystem::path& directory, const std::string& name) {
+    std::lock_guard lock(mutex);
+    if (const auto it = directories.find(directory.string()); it != directories.end()) {
+        it->second.names.insert(name);
+    }
+}
+
+void TargetNameIndex::clear() {
+    std::lock_guard lock(mutex);
+    directories.clear();
+}
+
+size_t TargetNameIndex::getIndexedDirectoryCount() const {
+    std::lock_guard lock(mutex);
+    return directories.size();
+}
+
+TargetNameIndex::DirectoryNames TargetNameIndex::listDirectory(const std::filesystem::path& directory) {
+    DirectoryNames entry;
+    std::error_code ec;
+    for (std::filesystem::directory_iterator it(directory, ec), end; !ec && it != end; it.increment(ec)) {
+        entry.names.insert(it->path().filename().string());
+    }
+    if (ec) {
+        Logger::instance().warning(std::format("Failed to list target directory {}: {}", directory.string(), ec.message()));
+    }
+    return entry;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <mutex>
+#include <cstddef>
+
+// Names present in target directories, used to resolve name collisions without probing the
+// filesystem once per candidate. A directory is listed once, the first time a collision
+// happens in it; after that each collision costs a hash lookup plus one check that the
+// chosen name was not taken by someone else in the meantime.
+class TargetNameIndex {
+public:
+    // Pick a free "stem_NNN.ext" variant of targetPath and reserve it. verifyOnDisk checks the
+    // pick with exists(); callers whose rename refuses to replace anything can skip that.
+    std::filesystem::path reserveUniqueTarget(const std::filesystem::path& targetPath, bool verifyOnDisk = true);
+
+    // Note a name that now exists in directory, if that directory is indexed
+    void recordName(const std::filesystem::path& directory, const std::string& name);
+
+    // Forget everything, e.g. at the start of a run
+    void clear();
+
+    size_t getIndexedDirectoryCount() const;
+
+private:
+    struct DirectoryNames {
+        std::unordered_set<std::string> names;
+        // next suffix to try for each colliding file name
+        std::unordered_map<std::string, size_t> nextSuffix;
+    };
+
+    // guards the map only; listing a directory and checking names on disk happen unlocked
+    mutable std::mutex mutex;
+    std::unordered_map<std::string, DirectoryNames> directories;
+
+    // Pick and reserve the next free suffixed name in the indexed directory key
+    std::filesystem::path reserveNextName(const std::string& key, const std::filesystem::path& targetPath);
+    static DirectoryNames listDirectory(const std::filesystem::path& directory);
+};
@@ -2,22 +2,59 @@
 #include "ConfigurationParser.h"
 #include "RuleFactory.h"
 #include "DirectoryOrganizer.h"
+#include "DirectoryWatcher.h"
+#include "MoveJournal.h"
 #include <iostream>
+#include <chrono>
 #include <filesystem>
+#include <format>
+#include <string_view>
+#include <csignal>
+
+namespace {
+
+// watcher to stop on SIGINT/SIGTERM; DirectoryWatcher::stop() is async-signal-safe
+DirectoryWatcher* activeWatcher = nullptr;
+
+void handleStopSignal(int) {
+    if (activeWatcher) {
+        activeWatcher->stop();
+    }
+}
+
+} // namespace
 
 int main(int argc, char* argv[]) {
     // default configuration file path
     std::string configFilePath = "sorter_config.txt";
+    bool watchRequested = false;
+    std::string undoRunId;
+    std::filesystem::path planFile;
+    std::filesystem::path executeFile;
     
     // parse command line arguments
-    if (argc > 1) {
-        configFilePath = argv[1];
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view argument(argv[i]);
+        if (argument == "--watch") {
+            watchRequested = true;
+        } else if (argument == "undo" && i + 1 < argc) {
+            undoRunId = argv[++i];
+        } else if (argument == "plan" && i + 1 < argc) {
+            planFile = argv[++i];
+        } else if (argument == "execute" && i + 1 < argc) {
+            executeFile = argv[++i];
+        } else {
+            configFilePath = argument;
+        }
     }
     
     // check if config file exists
     if (!std::filesystem::exists(configFilePath)) {
         std::cerr << "Configuration file not found: " << configFilePath << std::endl;
-        std::cerr << "Usage: " << argv[0] << " [config_file_path]" << std::endl;
+        std::cerr << "Usage: " << argv[0] << " [--watch] [config_file_path]" << std::endl;
+        std::cerr << "       " << argv[0] << " plan <plan_file> [config_file_path]" << std::endl;
+        std::cerr << "       " << argv[0] << " execute <plan_file> [config_file_path]" << std::endl;
+        std::cerr << "       " << argv[0] << " undo <run-id> [config_file_path]" << std::endl;
         return 1;
     }
     
@@ -32,13 +69,44 @@ int main(int argc, char* argv[]) {
             return 1;
         }
         
-        const auto&[sourceDir, targetBaseDir, dryRun, logLevel, logFile] = parser.getGlobalConfig();
+        const GlobalConfig& globalConfig = parser.getGlobalConfig();
         
         // initialize logger with configuration settings
-        Logger::instance().init(logLevel, logFile);
+        Logger::instance().init(globalConfig.logLevel, globalConfig.logFile);
+        if (globalConfig.logAsync) {
+            AsyncLogOptions logOptions;
+            logOptions.queueCapacity = globalConfig.logQueueSize;
+            logOptions.flushInterval = std::chrono::milliseconds(globalConfig.logFlushMs);
+            logOptions.overflow = globalConfig.logOverflow;
+            Logger::instance().startAsync(logOptions);
+        }
         Logger::instance().info("File Organizer starting...");
         Logger::instance().info("Configuration loaded from: " + configFilePath);
         
+        // settle the journals of runs that died before anything else touches the trees; dry runs
+        // and plans touch nothing, so they leave them alone
+        if (!globalConfig.dryRun && planFile.empty() && !globalConfig.journalDirectory.empty() &&
+            std::filesystem::is_directory(globalConfig.journalDirectory)) {
+            if (const size_t recovered = MoveJournal::recoverAll(globalConfig.journalDirectory); recovered > 0) {
+                Logger::instance().warning(std::format("Recovered {} interrupted runs", recovered));
+            }
+        }
+        
+        if (!undoRunId.empty()) {
+            if (globalConfig.journalDirectory.empty()) {
+                Logger::instance().error("Undo needs JOURNAL_DIR in the configuration");
+                return 1;
+            }
+            const auto result = MoveJournal::undo(globalConfig.journalDirectory, undoRunId, globalConfig.moveThreads);
+            if (!result) {
+                Logger::instance().error("Failed to undo run " + undoRunId);
+                return 1;
+            }
+            Logger::instance().info(std::format("Undo of run {}: {} items moved back, {} already undone, {} failed",
+                                                undoRunId, result->restored, result->skipped, result->failed));
+            return result->failed > 0 ? 1 : 0;
+        }
+        
         // create rules using factory
         RuleFactory factory;
         auto rules = factory.createRulesFromConfig(parser);
@@ -51,33 +119,95 @@ int main(int argc, char* argv[]) {
         Logger::instance().info("Loaded " + std::to_string(rules.size()) + " rules");
         
         // create and run directory organizer
+        OrganizerOptions options;
+        options.scanThreads = globalConfig.scanThreads;
+        options.moveThreads = globalConfig.moveThreads;
+        options.queueDepth = globalConfig.pipelineQueueDepth;
+        options.scanIndexFile = globalConfig.scanIndexFile;
+        options.copyThreads = globalConfig.copyThreads;
+        options.fsyncCopies = globalConfig.crossDeviceFsync;
+        options.journalDirectory = globalConfig.journalDirectory;
+        options.ioUringDepth = globalConfig.ioUringDepth;
+        
         DirectoryOrganizer organizer(
-            sourceDir,
-            targetBaseDir,
+            globalConfig.sourceDir,
+            globalConfig.targetBaseDir,
             std::move(rules),
-            dryRun
+            globalConfig.dryRun,
+            options
         );
         
+        if (!planFile.empty()) {
+            organizer.writePlan(planFile);
+            const auto& stats = organizer.getStatistics();
+            if (stats.errors == 0) {
+                Logger::instance().info(std::format("Plan written to {} (apply with: {} execute {} {})", planFile.string(),
+                                                    argv[0], planFile.string(), configFilePath));
+            }
+            return stats.errors > 0 ? 1 : 0;
+        }
+        
+        if (!executeFile.empty()) {
+            organizer.executePlan(executeFile);
+            const auto& stats = organizer.getStatistics();
+            if (!globalConfig.dryRun && !organizer.getRunId().empty()) {
+                Logger::instance().info(std::format("Run id: {} (revert with: {} undo {} {})", organizer.getRunId(),
+                                                    argv[0], organizer.getRunId(), configFilePath));
+            }
+            return stats.errors > 0 ? 1 : 0;
+        }
+        
+        if (watchRequested || globalConfig.watch) {
+            WatchOptions watchOptions;
+            watchOptions.debounce = std::chrono::milliseconds(globalConfig.watchDebounceMs);
+            watchOptions.rescanInterval = std::chrono::seconds(globalConfig.watchRescanSeconds);
+            
+            DirectoryWatcher watcher(organizer, watchOptions);
+            activeWatcher = &watcher;
+            std::signal(SIGINT, handleStopSignal);
+            std::signal(SIGTERM, handleStopSignal);
+            
+            Logger::instance().info("Watch mode: organizing changes until interrupted");
+            const bool watched = watcher.run();
+            
+            std::signal(SIGINT, SIG_DFL);
+            std::signal(SIGTERM, SIG_DFL);
+            activeWatcher = nullptr;
+            
+            Logger::instance().info("File Organizer stopped.");
+            return watched ? 0 : 1;
+        }
+        
         organizer.scanAndOrganize();
         
         // display final statistics
-        const auto&[filesProcessed, filesMovedOrWouldMove, filesSkipped, directoriesProcessed, directoriesMovedOrWouldMove, directoriesSkipped, errors] = organizer.getStatistics();
+        const auto& stats = organizer.getStatistics();
         Logger::instance().info("=== Final Statistics ===");
-        Logger::instance().info("Files processed: " + std::to_string(filesProcessed));
-        Logger::instance().info("Files moved: " + std::to_string(filesMovedOrWouldMove));
-        Logger::instance().info("Files skipped: " + std::to_string(filesSkipped));
-        Logger::instance().info("Directories processed: " + std::to_string(directoriesProcessed));
-        Logger::instance().info("Directories moved: " + std::to_string(directoriesMovedOrWouldMove));
-        Logger::instance().info("Directories skipped: " + std::to_string(directoriesSkipped));
-        Logger::instance().info("Errors: " + std::to_string(errors));
-        
-        if (dryRun) {
+        Logger::instance().info("Files processed: " + std::to_string(stats.filesProcessed));
+        Logger::instance().info("Files moved: " + std::to_string(stats.filesMovedOrWouldMove));
+        Logger::instance().info("Files skipped: " + std::to_string(stats.filesSkipped));
+        Logger::instance().info("Directories processed: " + std::to_string(stats.directoriesProcessed));
+        Logger::instance().info("Directories moved: " + std::to_string(stats.directoriesMovedOrWouldMove));
+        Logger::instance().info("Directories skipped: " + std::to_string(stats.directoriesSkipped));
+        Logger::instance().info("Errors: " + std::to_string(stats.errors));
+        Logger::instance().info(std::format("Scan throughput: {:.0f} entries/sec", stats.scanEntriesPerSecond));
+        Logger::instance().info(std::format("Move latency: {:.3f} ms average, {:.3f} ms max",
+                                            stats.moveLatencyAverageMs, stats.moveLatencyMaxMs));
+        if (stats.crossDeviceMoves > 0) {
+            Logger::instance().info(std::format("Cross-device moves: {} ({:.1f} MiB/sec)", stats.crossDeviceMoves,
+                                                stats.copyBytesPerSecond / (1024.0 * 1024.0)));
+        }
+        
+        if (globalConfig.dryRun) {
             Logger::instance().info("DRY RUN MODE: No files were actually moved");
+        } else if (!organizer.getRunId().empty()) {
+            Logger::instance().info(std::format("Run id: {} (revert with: {} undo {} {})", organizer.getRunId(),
+                                                argv[0], organizer.getRunId(), configFilePath));
         }
         
         Logger::instance().info("File Organizer completed successfully.");
         
-        return errors > 0 ? 1 : 0;
+        return stats.errors > 0 ? 1 : 0;
         
     } catch (const std::exception& e) {
         std::cerr << "Fatal error: " << e.what() << std::endl;
@@ -0,0 +1,102 @@
+#include "models/ExtensionIds.h"
+#include <string>
+#include <unordered_map>
+#include <shared_mutex>
+#include <mutex>
+#include <array>
+#include <atomic>
+
+namespace {
+
+struct ExtensionTable {
+    std::shared_mutex mutex;
+    std::unordered_map<std::string, std::uint32_t> ids;
+    std::atomic<std::uint32_t> count{0};  // ids.size(), readable without the lock
+};
+
+ExtensionTable& extensionTable() {
+    static ExtensionTable table;
+    return table;
+}
+
+char toLowerAscii(const char c) {
+    return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+// Ids each thread has looked up, for extensions of up to eight bytes packed lower-cased into
+// an integer. Ids never change once assigned, so a hit needs neither the lock nor a string.
+// A cached Unknown only holds while nothing new has been interned since.
+struct RecentIds {
+    static constexpr size_t slotCount = 256;
+    std::array<std::uint64_t, slotCount> keys{};  // 0: empty, no extension is cached
+    std::array<std::uint32_t, slotCount> ids{};
+    std::array<std::uint32_t, slotCount> counts{};  // the table's count when an Unknown was cached
+    
+    static size_t slotOf(const std::uint64_t key) {
+        return static_cast<size_t>((key * 0x9E3779B97F4A7C15ULL) >> 56);
+    }
+};
+
+thread_local RecentIds recentIds;
+
+std::uint32_t lookUp(const std::string_view extension, const bool assign) {
+    if (extension.empty()) {
+        return ExtensionIds::None;
+    }
+    
+    ExtensionTable& table = extensionTable();
+    std::uint64_t packed = 0;
+    if (extension.size() <= sizeof(packed)) {
+        for (size_t i = 0; i < extension.size(); ++i) {
+            packed |= std::uint64_t{static_cast<unsigned char>(toLowerAscii(extension[i]))} << (8 * i);
+        }
+        const size_t slot = RecentIds::slotOf(packed);
+        if (recentIds.keys[slot] == packed) {
+            const std::uint32_t id = recentIds.ids[slot];
+            if (id != ExtensionIds::Unknown) {
+                return id;
+            }
+            if (!assign && recentIds.counts[slot] == table.count.load(std::memory_order_acquire)) {
+                return id;
+            }
+        }
+    }
+    
+    std::string key(extension);
+    for (char& c : key) {
+        c = toLowerAscii(c);
+    }
+    std::uint32_t id = ExtensionIds::Unknown;
+    std::uint32_t count = 0;
+    {
+        std::shared_lock lock(table.mutex);
+        if (const auto it = table.ids.find(key); it != table.ids.end()) {
+            id = it->second;
+        }
+        count = table.count.load(std::memory_order_relaxed);
+    }
+    if (id == ExtensionIds::Unknown && assign) {
+        std::unique_lock lock(table.mutex);
+        const auto nextId = static_cast<std::uint32_t>(table.ids.size() + 1);
+        id = table.ids.try_emplace(std::move(key), nextId).first->second;
+        table.count.store(static_cast<std::uint32_t>(table.ids.size()), std::memory_order_release);
+    }
+    
+    if (packed != 0) {
+        const size_t slot = RecentIds::slotOf(packed);
+        recentIds.keys[slot] = packed;
+        recentIds.ids[slot] = id;
+        recentIds.counts[slot] = count;
+    }
+    return id;
+}
+
+} // namespace
+
+std::uint32_t ExtensionIds::intern(const std::string_view extension) {
+    return lookUp(extension, true);
+}
+
+std::uint32_t ExtensionIds::find(const std::string_view extension) {
+    return lookUp(extension, false);
+}
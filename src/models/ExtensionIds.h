@@ -0,0 +1,23 @@
+#pragma once
+
+#include <string_view>
+#include <cstdint>
+
+// Process-wide numbering of file extensions, so that extension checks compare integers
+// instead of strings. Case is ignored: ".PDF" and ".pdf" get the same id. Ids are never
+// reused. Only the extensions rules mention are interned, so the table stays as small as
+// the configuration; scanned items look theirs up with find().
+class ExtensionIds {
+public:
+    // id of "", the extension of directories and files without one
+    static constexpr std::uint32_t None = 0;
+    
+    // what find() returns for an extension that was never interned
+    static constexpr std::uint32_t Unknown = UINT32_MAX - 1;
+    
+    // The extension's id, assigning the next free one on first sight; safe from any thread
+    static std::uint32_t intern(std::string_view extension);
+    
+    // The extension's id if it was interned, Unknown otherwise; never grows the table
+    static std::uint32_t find(std::string_view extension);
+};
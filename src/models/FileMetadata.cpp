@@ -0,0 +1,153 @@
+#include "models/FileMetadata.h"
+#include <chrono>
+#include <atomic>
+#include <system_error>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <cerrno>
+#endif
+
+#if defined(__linux__)
+#include <sys/sysmacros.h>
+#endif
+
+namespace {
+
+#if defined(__unix__) || defined(__APPLE__)
+
+std::filesystem::file_time_type toFileTime(const std::int64_t seconds, const std::int64_t nanoseconds) {
+    const std::chrono::sys_time<std::chrono::nanoseconds> systemTime{
+        std::chrono::seconds(seconds) + std::chrono::nanoseconds(nanoseconds)};
+    return std::chrono::time_point_cast<std::filesystem::file_time_type::duration>(
+        std::chrono::clock_cast<std::chrono::file_clock>(systemTime));
+}
+
+ItemType toItemType(const unsigned mode) {
+    if (S_ISREG(mode)) {
+        return ItemType::File;
+    }
+    if (S_ISDIR(mode)) {
+        return ItemType::Directory;
+    }
+    return ItemType::Other;
+}
+
+// fstatat fallback for kernels or sandboxes without statx
+std::optional<FileMetadata> statAt(const int directoryFd, const char* name) {
+    struct stat st{};
+    if (::fstatat(directoryFd, name, &st, 0) != 0) {
+        return std::nullopt;
+    }
+
+    FileMetadata metadata;
+    metadata.type = toItemType(st.st_mode);
+    metadata.sizeInBytes = metadata.type == ItemType::File ? static_cast<std::uintmax_t>(st.st_size) : 0;
+#if defined(__APPLE__)
+    metadata.lastModified = toFileTime(st.st_mtimespec.tv_sec, st.st_mtimespec.tv_nsec);
+    metadata.lastStatusChange = toFileTime(st.st_ctimespec.tv_sec, st.st_ctimespec.tv_nsec);
+    metadata.birthTime = toFileTime(st.st_birthtimespec.tv_sec, st.st_birthtimespec.tv_nsec);
+#else
+    metadata.lastModified = toFileTime(st.st_mtim.tv_sec, st.st_mtim.tv_nsec);
+    metadata.lastStatusChange = toFileTime(st.st_ctim.tv_sec, st.st_ctim.tv_nsec);
+#endif
+    metadata.inode = st.st_ino;
+    metadata.device = st.st_dev;
+    metadata.linkCount = st.st_nlink;
+    return metadata;
+}
+
+#if defined(__linux__) && defined(STATX_BASIC_STATS)
+
+// set once statx turned out to be unsupported so later calls go straight to fstatat
+std::atomic<bool> statxUnavailable{false};
+
+std::optional<FileMetadata> statxAt(const int directoryFd, const char* name) {
+    if (statxUnavailable.load(std::memory_order_relaxed)) {
+        return statAt(directoryFd, name);
+    }
+
+    struct statx stx{};
+    if (::statx(directoryFd, name, AT_STATX_SYNC_AS_STAT, fileMetadataStatxMask(), &stx) != 0) {
+        if (errno == ENOSYS || errno == EPERM) {
+            statxUnavailable = true;
+            return statAt(directoryFd, name);
+        }
+        return std::nullopt;
+    }
+
+    return toFileMetadata(stx);
+}
+
+#endif
+
+#endif
+
+} // namespace
+
+#if defined(__linux__) && defined(STATX_BASIC_STATS)
+
+unsigned fileMetadataStatxMask() {
+    return STATX_TYPE | STATX_SIZE | STATX_MTIME | STATX_CTIME | STATX_BTIME | STATX_INO | STATX_NLINK;
+}
+
+FileMetadata toFileMetadata(const struct statx& stx) {
+    FileMetadata metadata;
+    metadata.type = toItemType(stx.stx_mode);
+    metadata.sizeInBytes = metadata.type == ItemType::File ? stx.stx_size : 0;
+    metadata.lastModified = toFileTime(stx.stx_mtime.tv_sec, stx.stx_mtime.tv_nsec);
+    metadata.lastStatusChange = toFileTime(stx.stx_ctime.tv_sec, stx.stx_ctime.tv_nsec);
+    if (stx.stx_mask & STATX_BTIME) {
+        metadata.birthTime = toFileTime(stx.stx_btime.tv_sec, stx.stx_btime.tv_nsec);
+    }
+    metadata.inode = stx.stx_ino;
+    // encoded like st_dev, so identities from the fstatat fallback compare equal
+    metadata.device = makedev(stx.stx_dev_major, stx.stx_dev_minor);
+    metadata.linkCount = stx.stx_nlink;
+    return metadata;
+}
+
+#endif
+
+std::optional<FileMetadata> readFileMetadataAt(const int directoryFd, const char* name) {
+#if defined(__linux__) && defined(STATX_BASIC_STATS)
+    return statxAt(directoryFd, name);
+#elif defined(__unix__) || defined(__APPLE__)
+    return statAt(directoryFd, name);
+#else
+    (void)directoryFd;
+    return readFileMetadata(name);
+#endif
+}
+
+std::optional<FileMetadata> readFileMetadata(const std::filesystem::path& path) {
+#if defined(__unix__) || defined(__APPLE__)
+    return readFileMetadataAt(AT_FDCWD, path.c_str());
+#else
+    // portable fallback: several queries, but the same result
+    std::error_code ec;
+    const auto status = std::filesystem::status(path, ec);
+    if (ec || !std::filesystem::exists(status)) {
+        return std::nullopt;
+    }
+
+    FileMetadata metadata;
+    if (std::filesystem::is_regular_file(status)) {
+        metadata.type = ItemType::File;
+        metadata.sizeInBytes = std::filesystem::file_size(path, ec);
+        if (ec) {
+            metadata.sizeInBytes = 0;
+        }
+    } else if (std::filesystem::is_directory(status)) {
+        metadata.type = ItemType::Directory;
+    }
+    metadata.lastModified = std::filesystem::last_write_time(path, ec);
+    if (ec) {
+        metadata.lastModified = std::filesystem::file_time_type::clock::now();
+    }
+    metadata.lastStatusChange = metadata.lastModified;  // not exposed by std::filesystem
+    metadata.linkCount = std::filesystem::hard_link_count(path, ec);
+    return metadata;
+#endif
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <filesystem>
+#include <optional>
+#include <cstdint>
+#include "models/ItemType.h"
+
+// Everything the organizer needs to know about an item, as returned by one statx() call
+struct FileMetadata {
+    ItemType type = ItemType::Other;
+    std::uintmax_t sizeInBytes = 0;
+    std::filesystem::file_time_type lastModified{};
+    std::filesystem::file_time_type lastStatusChange{};  // ctime
+    std::optional<std::filesystem::file_time_type> birthTime;  // empty if the filesystem does not report it
+    std::uint64_t inode = 0;
+    std::uint64_t device = 0;
+    std::uint64_t linkCount = 0;
+};
+
+// Query type, size, mtime, btime, inode, device and link count in a single syscall
+// (statx on Linux, stat elsewhere). Symlinks are followed, like std::filesystem::status.
+// Returns nullopt if the item does not exist or cannot be inspected.
+std::optional<FileMetadata> readFileMetadata(const std::filesystem::path& path);
+
+// Same as readFileMetadata, with name resolved relative to an open directory descriptor
+std::optional<FileMetadata> readFileMetadataAt(int directoryFd, const char* name);
+
+#if defined(__linux__)
+struct statx;
+
+// For callers issuing statx() themselves, e.g. batched through io_uring: the mask
+// readFileMetadata() requests, and the conversion of the result
+unsigned fileMetadataStatxMask();
+FileMetadata toFileMetadata(const struct statx& stx);
+#endif
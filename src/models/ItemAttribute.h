@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+
+// Item attributes a condition may look at. Name and extension come from the path and
+// are always available; everything else costs a metadata query.
+enum class ItemAttribute : std::uint8_t {
+    None = 0,
+    Type = 1 << 0,
+    Size = 1 << 1,
+    ModifiedTime = 1 << 2,
+    CreationTime = 1 << 3,
+    Identity = 1 << 4,  // inode, device and link count
+    All = Type | Size | ModifiedTime | CreationTime | Identity
+};
+
+constexpr ItemAttribute operator|(ItemAttribute a, ItemAttribute b) {
+    return static_cast<ItemAttribute>(static_cast<std::uint8_t>(a) | static_cast<std::uint8_t>(b));
+}
+
+constexpr ItemAttribute operator&(ItemAttribute a, ItemAttribute b) {
+    return static_cast<ItemAttribute>(static_cast<std::uint8_t>(a) & static_cast<std::uint8_t>(b));
+}
+
+constexpr ItemAttribute operator~(ItemAttribute a) {
+    return static_cast<ItemAttribute>(~static_cast<std::uint8_t>(a)) & ItemAttribute::All;
+}
+
+constexpr ItemAttribute& operator|=(ItemAttribute& a, ItemAttribute b) {
+    return a = a | b;
+}
+
+// True if every attribute in wanted is also set in mask
+constexpr bool hasAttributes(ItemAttribute mask, ItemAttribute wanted) {
+    return (mask & wanted) == wanted;
+}
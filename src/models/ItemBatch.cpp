@@ -0,0 +1,45 @@
+#include "models/ItemBatch.h"
+#include "models/ExtensionIds.h"
+#include <type_traits>
+
+// modification times are kept as raw ticks for the 64-bit kernels
+static_assert(std::is_signed_v<std::filesystem::file_time_type::rep> &&
+              sizeof(std::filesystem::file_time_type::rep) == sizeof(std::int64_t));
+
+void ItemBatch::add(const ItemRepresentation& item) {
+    const size_t index = items.size();
+    if (index % 64 == 0) {
+        fileMask.push_back(0);
+    }
+    items.push_back(&item);
+    
+    // the getters would fetch attributes the rules never read, so those columns stay zero
+    const bool hasType = hasAttributes(demand, ItemAttribute::Type);
+    const ItemType type = hasType ? item.getType() : ItemType::Other;
+    types.push_back(type);
+    extensionIds.push_back(hasType ? item.getExtensionId() : ExtensionIds::None);
+    sizes.push_back(hasAttributes(demand, ItemAttribute::Size) ? item.getSizeInBytes() : 0);
+    modifiedTimes.push_back(hasAttributes(demand, ItemAttribute::ModifiedTime)
+                            ? item.getLastModifiedDate().time_since_epoch().count()
+                            : 0);
+    if (type == ItemType::File) {
+        fileMask.back() |= std::uint64_t{1} << (index % 64);
+    }
+}
+
+void ItemBatch::clear() {
+    items.clear();
+    sizes.clear();
+    modifiedTimes.clear();
+    types.clear();
+    extensionIds.clear();
+    fileMask.clear();
+}
+
+std::vector<std::uint64_t> ItemBatch::makeFullMask() const {
+    std::vector<std::uint64_t> mask(getMaskWords(), ~std::uint64_t{0});
+    if (const size_t tail = items.size() % 64; tail != 0) {
+        mask.back() = (std::uint64_t{1} << tail) - 1;
+    }
+    return mask;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <vector>
+#include <span>
+#include <bit>
+#include <cstdint>
+#include <cstddef>
+#include "models/ItemRepresentation.h"
+#include "models/ItemAttribute.h"
+#include "models/ItemType.h"
+
+// Items laid out column by column: sizes, modification times, types and extension ids each
+// in their own contiguous array, so that a condition checks a whole batch in one pass over
+// the column it reads. Matches are bitmasks with bit i of word i / 64 standing for item i.
+// Only the demanded attributes are copied; the others are left zero and not fetched.
+// The batch points to its items, which must outlive it.
+class ItemBatch {
+public:
+    explicit ItemBatch(ItemAttribute demand = ItemAttribute::All) : demand(demand) {}
+    
+    void add(const ItemRepresentation& item);
+    void clear();
+    
+    size_t size() const { return items.size(); }
+    bool empty() const { return items.empty(); }
+    // 64-bit words in a mask covering the batch
+    size_t getMaskWords() const { return fileMask.size(); }
+    
+    const ItemRepresentation& getItem(const size_t index) const { return *items[index]; }
+    std::span<const std::uint64_t> getSizes() const { return sizes; }
+    // file_time_type ticks
+    std::span<const std::int64_t> getModifiedTimes() const { return modifiedTimes; }
+    std::span<const ItemType> getTypes() const { return types; }
+    std::span<const std::uint32_t> getExtensionIds() const { return extensionIds; }
+    // The regular files of the batch
+    std::span<const std::uint64_t> getFileMask() const { return fileMask; }
+    
+    // A mask with a bit set for every item of the batch
+    std::vector<std::uint64_t> makeFullMask() const;
+    
+private:
+    ItemAttribute demand;
+    std::vector<const ItemRepresentation*> items;
+    std::vector<std::uint64_t> sizes;
+    std::vector<std::int64_t> modifiedTimes;
+    std::vector<ItemType> types;
+    std::vector<std::uint32_t> extensionIds;
+    std::vector<std::uint64_t> fileMask;
+};
+
+// Whether any bit of the mask is set
+inline bool hasAnyBit(const std::span<const std::uint64_t> mask) {
+    for (const std::uint64_t word : mask) {
+        if (word != 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Clear the bits of mask whose item fails matches(index); only set bits are evaluated
+template<typename Predicate>
+void keepMatching(const std::span<std::uint64_t> mask, Predicate&& matches) {
+    for (size_t word = 0; word < mask.size(); ++word) {
+        for (std::uint64_t bits = mask[word]; bits != 0; bits &= bits - 1) {
+            const int bit = std::countr_zero(bits);
+            if (!matches(word * 64 + static_cast<size_t>(bit))) {
+                mask[word] &= ~(std::uint64_t{1} << bit);
+            }
+        }
+    }
+}
@@ -1,17 +1,40 @@
 #include "models/ItemRepresentation.h"
+#include "models/ExtensionIds.h"
 #include <filesystem>
 #include <utility>
 
 ItemRepresentation::ItemRepresentation(std::filesystem::path path)
+    : ItemRepresentation(std::move(path), ItemAttribute::All) {
+}
+
+ItemRepresentation::ItemRepresentation(std::filesystem::path path, const ItemAttribute demand)
+    : itemPath(std::move(path)), type(ItemType::Other), sizeInBytes(0) {
+    populatePathFields();
+    load(demand);
+}
+
+ItemRepresentation::ItemRepresentation(std::filesystem::path path, const ItemType knownType, const ItemAttribute demand)
+    : itemPath(std::move(path)), type(knownType), sizeInBytes(0) {
+    populatePathFields();
+    if (type == ItemType::Directory) {
+        extension = "";  // directories don't have extensions
+        extensionId = ExtensionIds::None;
+    }
+    loadedAttributes = ItemAttribute::Type;
+    load(demand);
+}
+
+ItemRepresentation::ItemRepresentation(std::filesystem::path path, const FileMetadata& metadata)
     : itemPath(std::move(path)), type(ItemType::Other), sizeInBytes(0) {
-    populateFields();
+    populatePathFields();
+    populateFromMetadata(metadata);
 }
 
 bool ItemRepresentation::exists() const {
     return std::filesystem::exists(itemPath);
 }
 
-void ItemRepresentation::populateFields() {
+void ItemRepresentation::populatePathFields() {
     // always set name and extension from path, regardless of file existence
     name = itemPath.filename().string();
     
@@ -21,40 +44,53 @@ void ItemRepresentation::populateFields() {
     } else {
         extension = "";
     }
-    
-    // if file doesn't exist, make reasonable assumptions based on extension
-    if (!exists()) {
-        // assume it's a file if it has an extension, directory otherwise
-        type = extension.empty() ? ItemType::Directory : ItemType::File;
-        sizeInBytes = 0;
-        lastModifiedDate = std::filesystem::file_time_type::clock::now();
+    extensionId = ExtensionIds::find(extension);
+}
+
+std::uint32_t ItemRepresentation::getExtensionId() const {
+    load(ItemAttribute::Type);
+    // rules built after the path was parsed may have interned the extension since
+    if (extensionId == ExtensionIds::Unknown) {
+        extensionId = ExtensionIds::find(extension);
+    }
+    return extensionId;
+}
+
+void ItemRepresentation::load(const ItemAttribute wanted) const {
+    if (hasAttributes(loadedAttributes, wanted)) {
         return;
     }
     
-    // determine type and populate type-specific fields for existing items
-    if (std::filesystem::is_regular_file(itemPath)) {
-        type = ItemType::File;
-        
-        // get file size
-        std::error_code ec;
-        sizeInBytes = std::filesystem::file_size(itemPath, ec);
-        if (ec) {
-            sizeInBytes = 0;  // set to 0 if unable to get size
-        }
-    } else if (std::filesystem::is_directory(itemPath)) {
-        type = ItemType::Directory;
-        extension = "";  // directories don't have extensions
-        sizeInBytes = 0;  // directories don't have size in this context
-    } else {
-        type = ItemType::Other;
-        sizeInBytes = 0;
+    // one statx() gives type, size, times and identity; nullopt means the item is not there
+    const auto metadata = readFileMetadata(itemPath);
+    if (!metadata) {
+        populateMissing();
+        return;
     }
     
-    // get last modified time
-    std::error_code ec;
-    lastModifiedDate = std::filesystem::last_write_time(itemPath, ec);
-    if (ec) {
-        // if we can't get the time, use current time as fallback
-        lastModifiedDate = std::filesystem::file_time_type::clock::now();
+    populateFromMetadata(*metadata);
+}
+
+void ItemRepresentation::populateFromMetadata(const FileMetadata& metadata) const {
+    type = metadata.type;
+    sizeInBytes = metadata.type == ItemType::File ? metadata.sizeInBytes : 0;  // directories don't have size in this context
+    if (type == ItemType::Directory) {
+        extension = "";  // directories don't have extensions
+        extensionId = ExtensionIds::None;
     }
-} 
\ No newline at end of file
+    lastModifiedDate = metadata.lastModified;
+    creationDate = metadata.birthTime;
+    inode = metadata.inode;
+    device = metadata.device;
+    linkCount = metadata.linkCount;
+    loadedAttributes = ItemAttribute::All;
+}
+
+void ItemRepresentation::populateMissing() const {
+    // if file doesn't exist, make reasonable assumptions based on extension:
+    // assume it's a file if it has an extension, directory otherwise
+    type = extension.empty() ? ItemType::Directory : ItemType::File;
+    sizeInBytes = 0;
+    lastModifiedDate = std::filesystem::file_time_type::clock::now();
+    loadedAttributes = ItemAttribute::All;
+}
@@ -2,36 +2,70 @@
 
 #include <filesystem>
 #include <string>
+#include <optional>
+#include <cstdint>
+#include "models/ItemType.h"
+#include "models/ItemAttribute.h"
+#include "models/FileMetadata.h"
 
-enum class ItemType {
-    File,
-    Directory,
-    Other
-};
-
+// A file system item as seen by the rules. Attributes outside the demand mask given at
+// construction are fetched lazily the first time a getter needs them, so an instance
+// must not be shared between threads without synchronization.
 class ItemRepresentation {
 public:
-    // Constructor to populate fields using std::filesystem
+    // Constructor to populate fields with a single metadata query on path
     explicit ItemRepresentation(std::filesystem::path  path);
     
+    // Constructor that fetches only the demanded attributes up front
+    ItemRepresentation(std::filesystem::path path, ItemAttribute demand);
+    
+    // Constructor for items whose type is already known, e.g. from the dirent d_type;
+    // with a demand of Type alone no syscall is made
+    ItemRepresentation(std::filesystem::path path, ItemType knownType, ItemAttribute demand);
+    
+    // Constructor for callers that already hold the item's metadata (no syscall)
+    ItemRepresentation(std::filesystem::path path, const FileMetadata& metadata);
+    
     // Getters
     const std::filesystem::path& getItemPath() const { return itemPath; }
-    ItemType getType() const { return type; }
+    ItemType getType() const { load(ItemAttribute::Type); return type; }
     const std::string& getName() const { return name; }
-    const std::string& getExtension() const { return extension; }
-    std::uintmax_t getSizeInBytes() const { return sizeInBytes; }
-    const std::filesystem::file_time_type& getLastModifiedDate() const { return lastModifiedDate; }
+    const std::string& getExtension() const { load(ItemAttribute::Type); return extension; }
+    // The extension's ExtensionIds id, case-insensitive; ExtensionIds::None for directories and
+    // ExtensionIds::Unknown for extensions no rule mentions
+    std::uint32_t getExtensionId() const;
+    std::uintmax_t getSizeInBytes() const { load(ItemAttribute::Size); return sizeInBytes; }
+    const std::filesystem::file_time_type& getLastModifiedDate() const { load(ItemAttribute::ModifiedTime); return lastModifiedDate; }
+    const std::optional<std::filesystem::file_time_type>& getCreationDate() const { load(ItemAttribute::CreationTime); return creationDate; }
+    std::uint64_t getInode() const { load(ItemAttribute::Identity); return inode; }
+    std::uint64_t getDevice() const { load(ItemAttribute::Identity); return device; }
+    std::uint64_t getLinkCount() const { load(ItemAttribute::Identity); return linkCount; }
+    
+    // Attributes fetched so far
+    ItemAttribute getLoadedAttributes() const { return loadedAttributes; }
     
     // Utility methods
     bool exists() const;
     
 private:
     std::filesystem::path itemPath;
-    ItemType type;
     std::string name;
-    std::string extension;  // empty for directories
-    std::uintmax_t sizeInBytes;  // 0 for directories
-    std::filesystem::file_time_type lastModifiedDate;
     
-    void populateFields();
-}; 
\ No newline at end of file
+    // lazily populated; see load()
+    mutable ItemType type;
+    mutable std::string extension;  // empty for directories
+    mutable std::uint32_t extensionId = 0;  // looked up again while it is Unknown, see getExtensionId()
+    mutable std::uintmax_t sizeInBytes;  // 0 for directories
+    mutable std::filesystem::file_time_type lastModifiedDate;
+    mutable std::optional<std::filesystem::file_time_type> creationDate;  // not every filesystem records it
+    mutable std::uint64_t inode = 0;
+    mutable std::uint64_t device = 0;
+    mutable std::uint64_t linkCount = 0;
+    mutable ItemAttribute loadedAttributes = ItemAttribute::None;
+    
+    void populatePathFields();
+    // Fetch whichever of the wanted attributes are not loaded yet
+    void load(ItemAttribute wanted) const;
+    void populateFromMetadata(const FileMetadata& metadata) const;
+    void populateMissing() const;
+};
@@ -0,0 +1,9 @@
+#pragma once
+
+#include <cstdint>
+
+enum class ItemType : std::uint8_t {
+    File,
+    Directory,
+    Other
+};
@@ -8,19 +8,35 @@ ConfigurableRule::ConfigurableRule(std::filesystem::path targetPath, const int p
 
 void ConfigurableRule::addCondition(std::unique_ptr<ICondition> condition) {
     if (condition) {
-        conditions.push_back(std::move(condition));
+        conditions.emplace_back(std::move(condition));
     }
 }
 
-bool ConfigurableRule::matches(const ItemRepresentation& item) const {
-    // if no conditions, the rule matches everything
-    if (conditions.empty()) {
-        return true;
+void ConfigurableRule::addCompiledCondition(CompiledCondition condition) {
+    if (const auto* custom = std::get_if<std::unique_ptr<ICondition>>(&condition); custom && !*custom) {
+        return;
     }
-    
-    // all conditions must be true (AND logic)
+    conditions.push_back(std::move(condition));
+}
+
+namespace {
+
+// Conditions requiredNamePatterns() reports and that test nothing but the name; custom
+// conditions may test more, so they are always evaluated
+bool isCheckedName(const CompiledCondition& condition) {
+    return std::holds_alternative<NameCondition>(condition);
+}
+
+} // namespace
+
+bool ConfigurableRule::matchConditions(const ItemRepresentation& item, const EvaluationContext& context,
+                                       const bool skipNames) const {
+    // all conditions must be true (AND logic); no conditions match everything
     for (const auto& condition : conditions) {
-        if (!condition->evaluate(item)) {
+        if (skipNames && isCheckedName(condition)) {
+            continue;
+        }
+        if (!evaluateCondition(condition, item, context)) {
             return false;
         }
     }
@@ -28,6 +44,38 @@ bool ConfigurableRule::matches(const ItemRepresentation& item) const {
     return true;
 }
 
+void ConfigurableRule::matchConditionBatches(const ItemBatch& batch, const EvaluationContext& context,
+                                             const std::span<std::uint64_t> mask, const bool skipNames) const {
+    // each condition narrows the mask; once it is empty the rest have nothing to check
+    for (const auto& condition : conditions) {
+        if (!hasAnyBit(mask)) {
+            return;
+        }
+        if (skipNames && isCheckedName(condition)) {
+            continue;
+        }
+        evaluateConditionBatch(condition, batch, context, mask);
+    }
+}
+
+bool ConfigurableRule::matches(const ItemRepresentation& item, const EvaluationContext& context) const {
+    return matchConditions(item, context, false);
+}
+
+void ConfigurableRule::matchBatch(const ItemBatch& batch, const EvaluationContext& context,
+                                  const std::span<std::uint64_t> mask) const {
+    matchConditionBatches(batch, context, mask, false);
+}
+
+bool ConfigurableRule::matchesCheckedName(const ItemRepresentation& item, const EvaluationContext& context) const {
+    return matchConditions(item, context, true);
+}
+
+void ConfigurableRule::matchBatchCheckedNames(const ItemBatch& batch, const EvaluationContext& context,
+                                              const std::span<std::uint64_t> mask) const {
+    matchConditionBatches(batch, context, mask, true);
+}
+
 std::filesystem::path ConfigurableRule::getTargetRelativePath() const {
     return targetRelativePath;
 }
@@ -36,6 +84,36 @@ int ConfigurableRule::getPriority() const {
     return rulePriority;
 }
 
+ItemAttribute ConfigurableRule::requiredAttributes() const {
+    // union of what the conditions read; a rule without conditions reads nothing
+    ItemAttribute required = ItemAttribute::None;
+    for (const auto& condition : conditions) {
+        required |= asCondition(condition).requiredAttributes();
+    }
+    return required;
+}
+
+std::optional<std::string> ConfigurableRule::requiredExtension() const {
+    // conditions are ANDed, so any one extension condition constrains the whole rule
+    for (const auto& condition : conditions) {
+        if (auto extension = asCondition(condition).requiredExtension()) {
+            return extension;
+        }
+    }
+    return std::nullopt;
+}
+
+std::vector<GlobPattern> ConfigurableRule::requiredNamePatterns() const {
+    // conditions are ANDed, so a name has to match the pattern of each
+    std::vector<GlobPattern> patterns;
+    for (const auto& condition : conditions) {
+        if (auto pattern = asCondition(condition).requiredNamePattern()) {
+            patterns.push_back(std::move(*pattern));
+        }
+    }
+    return patterns;
+}
+
 std::string ConfigurableRule::describe() const {
     std::ostringstream oss;
     oss << "Rule (priority=" << rulePriority << ", target='" << targetRelativePath.string() << "')";
@@ -46,7 +124,7 @@ std::string ConfigurableRule::describe() const {
             if (i > 0) {
                 oss << " AND ";
             }
-            oss << conditions[i]->describe();
+            oss << asCondition(conditions[i]).describe();
         }
     } else {
         oss << " with no conditions (matches all)";
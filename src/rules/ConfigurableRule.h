@@ -2,25 +2,47 @@
 
 #include "rules/ISortingRule.h"
 #include "conditions/ICondition.h"
+#include "conditions/CompiledCondition.h"
 #include <vector>
 #include <memory>
 #include <filesystem>
+#include <utility>
 
 class ConfigurableRule : public ISortingRule {
 public:
     ConfigurableRule(std::filesystem::path targetPath, int priority);
     
-    // Add a condition to this rule
+    // Add a condition to this rule; a custom condition is evaluated through ICondition
     void addCondition(std::unique_ptr<ICondition> condition);
+    // Built-in conditions are moved out of the pointer and stored by value
+    template<BuiltinCondition Condition>
+    void addCondition(std::unique_ptr<Condition> condition) {
+        if (condition) {
+            conditions.emplace_back(std::move(*condition));
+        }
+    }
+    void addCompiledCondition(CompiledCondition condition);
     
     // ISortingRule interface implementation
-    bool matches(const ItemRepresentation& item) const override;
+    bool matches(const ItemRepresentation& item, const EvaluationContext& context) const override;
+    void matchBatch(const ItemBatch& batch, const EvaluationContext& context, std::span<std::uint64_t> mask) const override;
+    bool matchesCheckedName(const ItemRepresentation& item, const EvaluationContext& context) const override;
+    void matchBatchCheckedNames(const ItemBatch& batch, const EvaluationContext& context,
+                                std::span<std::uint64_t> mask) const override;
     std::filesystem::path getTargetRelativePath() const override;
     int getPriority() const override;
     std::string describe() const override;
+    ItemAttribute requiredAttributes() const override;
+    std::optional<std::string> requiredExtension() const override;
+    std::vector<GlobPattern> requiredNamePatterns() const override;
     
 private:
     std::filesystem::path targetRelativePath;
     int rulePriority;
-    std::vector<std::unique_ptr<ICondition>> conditions;
+    std::vector<CompiledCondition> conditions;
+    
+    // skipNames leaves out the conditions requiredNamePatterns() covers
+    bool matchConditions(const ItemRepresentation& item, const EvaluationContext& context, bool skipNames) const;
+    void matchConditionBatches(const ItemBatch& batch, const EvaluationContext& context,
+                               std::span<std::uint64_t> mask, bool skipNames) const;
 }; 
\ No newline at end of file
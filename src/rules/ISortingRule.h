@@ -1,15 +1,29 @@
 #pragma once
 
 #include "models/ItemRepresentation.h"
+#include "models/ItemBatch.h"
+#include "models/ItemAttribute.h"
+#include "conditions/EvaluationContext.h"
+#include "conditions/GlobAutomaton.h"
 #include <filesystem>
 #include <string>
+#include <optional>
+#include <span>
+#include <vector>
+#include <cstdint>
 
 class ISortingRule {
 public:
     virtual ~ISortingRule() = default;
     
-    // Check if this rule matches the given item
-    virtual bool matches(const ItemRepresentation& item) const = 0;
+    // Check if this rule matches the given item, during the run described by context
+    virtual bool matches(const ItemRepresentation& item, const EvaluationContext& context) const = 0;
+    
+    // Clear the bits of mask (see ItemBatch) of the items matches() rejects
+    virtual void matchBatch(const ItemBatch& batch, const EvaluationContext& context,
+                            const std::span<std::uint64_t> mask) const {
+        keepMatching(mask, [&](const size_t index) { return matches(batch.getItem(index), context); });
+    }
     
     // Get the target relative path for items matching this rule
     virtual std::filesystem::path getTargetRelativePath() const = 0;
@@ -19,4 +33,26 @@ public:
     
     // Get a description of this rule for logging/debugging
     virtual std::string describe() const = 0;
+    
+    // Item attributes matches() reads (all of them unless a rule knows better)
+    virtual ItemAttribute requiredAttributes() const { return ItemAttribute::All; }
+    
+    // The lower-case extension every item matches() accepts has, if the rule only accepts
+    // files with one extension; see ICondition::requiredExtension()
+    virtual std::optional<std::string> requiredExtension() const { return std::nullopt; }
+    
+    // Globs the name of every item matches() accepts matches, all of them; see
+    // ICondition::requiredNamePattern()
+    virtual std::vector<GlobPattern> requiredNamePatterns() const { return {}; }
+    
+    // matches() and matchBatch() for items whose names are already known to match every
+    // requiredNamePatterns() glob, as RuleIndex finds out for all rules in one pass; rules
+    // may skip checking the names again
+    virtual bool matchesCheckedName(const ItemRepresentation& item, const EvaluationContext& context) const {
+        return matches(item, context);
+    }
+    virtual void matchBatchCheckedNames(const ItemBatch& batch, const EvaluationContext& context,
+                                        const std::span<std::uint64_t> mask) const {
+        matchBatch(batch, context, mask);
+    }
 }; 
\ No newline at end of file
@@ -0,0 +1,160 @@
+#include "rules/RuleIndex.h"
+#include "models/ExtensionIds.h"
+#include <unordered_map>
+#include <algorithm>
+#include <optional>
+#include <bit>
+#include <utility>
+
+RuleIndex::RuleIndex(const std::vector<std::unique_ptr<ISortingRule>>& rules) {
+    // positions remember the original order for the merge
+    std::unordered_map<std::uint32_t, std::vector<size_t>> positionsByExtension;
+    std::vector<size_t> unrestrictedPositions;
+    for (size_t i = 0; i < rules.size(); ++i) {
+        PatternRange patterns{nameAutomaton.getPatternCount()};
+        for (const GlobPattern& pattern : rules[i]->requiredNamePatterns()) {
+            nameAutomaton.addPattern(pattern.glob, pattern.ignoreCase);
+            ++patterns.count;
+        }
+        allRules.rules.push_back(rules[i].get());
+        allRules.namePatterns.push_back(patterns);
+        if (auto extension = rules[i]->requiredExtension()) {
+            const std::uint32_t extensionId = ExtensionIds::intern(*extension);
+            ruleExtensionIds.push_back(extensionId);
+            positionsByExtension[extensionId].push_back(i);
+        } else {
+            ruleExtensionIds.push_back(anyExtension);
+            unrestrictedPositions.push_back(i);
+            unrestricted.rules.push_back(allRules.rules[i]);
+            unrestricted.namePatterns.push_back(allRules.namePatterns[i]);
+        }
+    }
+    nameAutomaton.compile();
+    
+    indexedExtensionCount = positionsByExtension.size();
+    for (const auto& [extensionId, positions] : positionsByExtension) {
+        std::vector<size_t> merged;
+        merged.reserve(positions.size() + unrestrictedPositions.size());
+        std::ranges::merge(positions, unrestrictedPositions, std::back_inserter(merged));
+        
+        if (extensionId >= byExtensionId.size()) {
+            byExtensionId.resize(extensionId + 1);
+        }
+        Candidates& candidates = byExtensionId[extensionId];
+        candidates.rules.reserve(merged.size());
+        candidates.namePatterns.reserve(merged.size());
+        for (const size_t position : merged) {
+            candidates.rules.push_back(allRules.rules[position]);
+            candidates.namePatterns.push_back(allRules.namePatterns[position]);
+        }
+    }
+}
+
+bool RuleIndex::PatternRange::matchedBy(const GlobMatches& matches) const {
+    for (size_t pattern = first; pattern < first + count; ++pattern) {
+        if (!matches.contains(pattern)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+const RuleIndex::Candidates& RuleIndex::candidateListFor(const ItemRepresentation& item) const {
+    // extension rules only ever accept files
+    if (byExtensionId.empty() || item.getType() != ItemType::File) {
+        return unrestricted;
+    }
+    const std::uint32_t extensionId = item.getExtensionId();
+    if (extensionId < byExtensionId.size() && !byExtensionId[extensionId].rules.empty()) {
+        return byExtensionId[extensionId];
+    }
+    return unrestricted;
+}
+
+const std::vector<ISortingRule*>& RuleIndex::candidatesFor(const ItemRepresentation& item) const {
+    return candidateListFor(item).rules;
+}
+
+ISortingRule* RuleIndex::findMatchingRule(const ItemRepresentation& item, const EvaluationContext& context) const {
+    const Candidates& candidates = candidateListFor(item);
+    // matched against every pattern at once, when the first candidate with one comes up
+    std::optional<GlobMatches> nameMatches;
+    for (size_t i = 0; i < candidates.rules.size(); ++i) {
+        if (const PatternRange& patterns = candidates.namePatterns[i]; patterns.count > 0) {
+            if (!nameMatches) {
+                nameMatches = nameAutomaton.match(item.getName());
+            }
+            if (!patterns.matchedBy(*nameMatches)) {
+                continue;
+            }
+        }
+        if (candidates.rules[i]->matchesCheckedName(item, context)) {
+            return candidates.rules[i];
+        }
+    }
+    return nullptr;
+}
+
+void RuleIndex::findMatchingRules(const ItemBatch& batch, const EvaluationContext& context,
+                                  const std::span<ISortingRule*> matches) const {
+    std::ranges::fill(matches, nullptr);
+    std::vector<GlobMatches> nameMatches;
+    if (nameAutomaton.getPatternCount() > 0) {
+        nameMatches.reserve(batch.size());
+        for (size_t i = 0; i < batch.size(); ++i) {
+            nameMatches.push_back(nameAutomaton.match(batch.getItem(i).getName()));
+        }
+    }
+    
+    // the files of each extension some rule is restricted to; read from the type and
+    // extension id columns, which every extension rule demands
+    std::unordered_map<std::uint32_t, std::vector<std::uint64_t>> filesByExtension;
+    if (indexedExtensionCount > 0) {
+        const auto types = batch.getTypes();
+        const auto extensionIds = batch.getExtensionIds();
+        for (size_t i = 0; i < batch.size(); ++i) {
+            const std::uint32_t extensionId = extensionIds[i];
+            if (types[i] != ItemType::File || extensionId >= byExtensionId.size() || byExtensionId[extensionId].rules.empty()) {
+                continue;
+            }
+            auto& files = filesByExtension[extensionId];
+            files.resize(batch.getMaskWords(), 0);
+            files[i / 64] |= std::uint64_t{1} << (i % 64);
+        }
+    }
+    
+    std::vector<std::uint64_t> unmatched = batch.makeFullMask();
+    std::vector<std::uint64_t> ruleMatches;
+    for (size_t ruleIndex = 0; ruleIndex < allRules.rules.size(); ++ruleIndex) {
+        if (!hasAnyBit(unmatched)) {
+            return;
+        }
+        ruleMatches = unmatched;
+        if (const std::uint32_t extensionId = ruleExtensionIds[ruleIndex]; extensionId != anyExtension) {
+            const auto files = filesByExtension.find(extensionId);
+            if (files == filesByExtension.end()) {
+                continue;
+            }
+            for (size_t word = 0; word < ruleMatches.size(); ++word) {
+                ruleMatches[word] &= files->second[word];
+            }
+            if (!hasAnyBit(ruleMatches)) {
+                continue;
+            }
+        }
+        if (const PatternRange& patterns = allRules.namePatterns[ruleIndex]; patterns.count > 0) {
+            keepMatching(ruleMatches, [&](const size_t item) { return patterns.matchedBy(nameMatches[item]); });
+            if (!hasAnyBit(ruleMatches)) {
+                continue;
+            }
+        }
+        ISortingRule* rule = allRules.rules[ruleIndex];
+        rule->matchBatchCheckedNames(batch, context, ruleMatches);
+        for (size_t word = 0; word < ruleMatches.size(); ++word) {
+            for (std::uint64_t bits = ruleMatches[word]; bits != 0; bits &= bits - 1) {
+                matches[word * 64 + static_cast<size_t>(std::countr_zero(bits))] = rule;
+            }
+            unmatched[word] &= ~ruleMatches[word];
+        }
+    }
+}
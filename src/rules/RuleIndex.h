@@ -0,0 +1,65 @@
+#pragma once
+
+#include "rules/ISortingRule.h"
+#include "conditions/GlobAutomaton.h"
+#include <vector>
+#include <memory>
+#include <span>
+
+// Rule set compiled for dispatch by extension. Rules that only accept one extension are
+// filed under it; every other rule applies to all items. For each extension the index holds
+// its own rules merged with the unrestricted ones in the original order, so looking up an
+// item evaluates only rules that can match it and still returns the first match by priority.
+// The name patterns of all rules compile into one GlobAutomaton: a single pass over an
+// item's name tells which of them match, rules with a pattern that doesn't are skipped
+// without being evaluated and the others don't check the name again. Holds raw pointers:
+// the rules must outlive the index.
+class RuleIndex {
+public:
+    // rules in the order they are tried, highest priority first
+    explicit RuleIndex(const std::vector<std::unique_ptr<ISortingRule>>& rules);
+    
+    // Same result as trying every rule in order; nullptr when none matches
+    ISortingRule* findMatchingRule(const ItemRepresentation& item, const EvaluationContext& context) const;
+    
+    // findMatchingRule() for every item of the batch: each rule is evaluated once, over the
+    // items no earlier rule matched; a rule restricted to an extension only over the files
+    // with it, and not at all if the batch has none. matches must have an element per item.
+    void findMatchingRules(const ItemBatch& batch, const EvaluationContext& context,
+                           std::span<ISortingRule*> matches) const;
+    
+    // The rules findMatchingRule() evaluates for this item, in order
+    const std::vector<ISortingRule*>& candidatesFor(const ItemRepresentation& item) const;
+    
+    size_t getIndexedExtensionCount() const { return indexedExtensionCount; }
+    size_t getNamePatternCount() const { return nameAutomaton.getPatternCount(); }
+    
+private:
+    static constexpr std::uint32_t anyExtension = UINT32_MAX;
+    
+    // the nameAutomaton patterns of one rule, added one after another; empty for rules without
+    struct PatternRange {
+        size_t first = 0;
+        size_t count = 0;
+        
+        bool matchedBy(const GlobMatches& matches) const;
+    };
+    
+    // rules with the name patterns of each
+    struct Candidates {
+        std::vector<ISortingRule*> rules;
+        std::vector<PatternRange> namePatterns;
+    };
+    
+    // indexed by ExtensionIds id; empty for extensions no rule is restricted to
+    std::vector<Candidates> byExtensionId;
+    size_t indexedExtensionCount = 0;
+    // rules without an extension restriction; all an item with an unindexed extension can match
+    Candidates unrestricted;
+    Candidates allRules;
+    // the ExtensionIds id each of allRules is restricted to, or anyExtension
+    std::vector<std::uint32_t> ruleExtensionIds;
+    GlobAutomaton nameAutomaton;
+    
+    const Candidates& candidateListFor(const ItemRepresentation& item) const;
+};
@@ -0,0 +1,117 @@
+// Compares matching items one at a time with matching them in ItemBatches of the match
+// stage's size, on synthetic items so that only rule evaluation is measured.
+// Usage: item_batch_benchmark [item count]
+#include "rules/RuleIndex.h"
+#include "rules/ConfigurableRule.h"
+#include "conditions/BatchKernels.h"
+#include "models/ItemBatch.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <format>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr size_t batchSize = 256;
+
+std::vector<std::unique_ptr<ISortingRule>> makeRules() {
+    std::vector<std::unique_ptr<ISortingRule>> rules;
+    const auto addRule = [&](const std::string& target) {
+        rules.push_back(std::make_unique<ConfigurableRule>(target, static_cast<int>(rules.size())));
+        return static_cast<ConfigurableRule*>(rules.back().get());
+    };
+    // size and age rules first, so that every item goes through the threshold conditions
+    auto* hugeOld = addRule("archive/huge");
+    hugeOld->addCondition(std::make_unique<SizeCondition>(SizeComparison::GreaterThan, 900ULL << 20));
+    hugeOld->addCondition(std::make_unique<AgeCondition>(AgeComparison::OlderThan, std::chrono::hours(24 * 365)));
+    addRule("large")->addCondition(std::make_unique<SizeCondition>(SizeComparison::GreaterThan, 1000ULL << 20));
+    auto* recentSmall = addRule("inbox");
+    recentSmall->addCondition(std::make_unique<AgeCondition>(AgeComparison::NewerThan, std::chrono::hours(1)));
+    recentSmall->addCondition(std::make_unique<SizeCondition>(SizeComparison::LessThan, 1024));
+    addRule("stale")->addCondition(std::make_unique<AgeCondition>(AgeComparison::OlderThan, std::chrono::hours(24 * 3650)));
+    for (const char* extension : {".pdf", ".txt", ".jpg", ".png", ".mp4", ".zip"}) {
+        addRule(extension + 1)->addCondition(std::make_unique<ExtensionCondition>(extension));
+    }
+    return rules;
+}
+
+std::vector<ItemRepresentation> makeItems(const size_t count) {
+    std::mt19937_64 random(7);
+    const auto now = std::filesystem::file_time_type::clock::now();
+    const std::vector<std::string> extensions = {".pdf", ".txt", ".jpg", ".png", ".mp4", ".zip", ".c", ".h", ""};
+    std::vector<ItemRepresentation> items;
+    items.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        FileMetadata metadata;
+        metadata.type = ItemType::File;
+        metadata.sizeInBytes = random() % (2ULL << 30);
+        metadata.lastModified = now - std::chrono::hours(random() % (24 * 365 * 12));
+        items.emplace_back("file" + std::to_string(i) + extensions[random() % extensions.size()], metadata);
+    }
+    return items;
+}
+
+template<typename Function>
+double secondsFor(Function&& function) {
+    const auto start = std::chrono::steady_clock::now();
+    function();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+int main(const int argc, char* argv[]) {
+    const size_t itemCount = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1'000'000;
+    const auto rules = makeRules();
+    const RuleIndex index(rules);
+    const auto items = makeItems(itemCount);
+    const EvaluationContext context;
+
+    std::vector<const ISortingRule*> perItem(items.size());
+    const double perItemSeconds = secondsFor([&] {
+        for (size_t i = 0; i < items.size(); ++i) {
+            perItem[i] = index.findMatchingRule(items[i], context);
+        }
+    });
+
+    // one batch reused like the match stage does; filling the columns and evaluating them are timed apart
+    std::vector<ISortingRule*> batched(items.size());
+    ItemBatch batch;
+    double fillSeconds = 0.0;
+    double matchSeconds = 0.0;
+    for (size_t begin = 0; begin < items.size(); begin += batchSize) {
+        const size_t end = std::min(items.size(), begin + batchSize);
+        fillSeconds += secondsFor([&] {
+            batch.clear();
+            for (size_t i = begin; i < end; ++i) {
+                batch.add(items[i]);
+            }
+        });
+        matchSeconds += secondsFor([&] {
+            index.findMatchingRules(batch, context, std::span(batched).subspan(begin, end - begin));
+        });
+    }
+    const double batchedSeconds = fillSeconds + matchSeconds;
+
+    size_t differences = 0;
+    for (size_t i = 0; i < items.size(); ++i) {
+        differences += perItem[i] != batched[i];
+    }
+    std::cout << std::format("{} items, {} rules, batches of {}, {} kernels\n", items.size(), rules.size(), batchSize,
+                             batchKernelsUseAvx2() ? "AVX2" : "scalar");
+    std::cout << std::format("per item: {:.3f}s ({:.1f} ns/item)\n", perItemSeconds, perItemSeconds * 1e9 / items.size());
+    std::cout << std::format("batched:  {:.3f}s ({:.1f} ns/item), {:.2f}x\n", batchedSeconds,
+                             batchedSeconds * 1e9 / items.size(), perItemSeconds / batchedSeconds);
+    std::cout << std::format("  filling batches:  {:.3f}s ({:.1f} ns/item)\n", fillSeconds, fillSeconds * 1e9 / items.size());
+    std::cout << std::format("  matching batches: {:.3f}s ({:.1f} ns/item), {:.2f}x\n", matchSeconds,
+                             matchSeconds * 1e9 / items.size(), perItemSeconds / matchSeconds);
+    if (differences > 0) {
+        std::cerr << differences << " items matched a different rule" << std::endl;
+        return 1;
+    }
+    return 0;
+}
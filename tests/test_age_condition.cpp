@@ -31,6 +31,9 @@ protected:
             std::ofstream file(newFile);
             file << "new content";
         }
+        
+        // measure ages from after both files exist
+        context = EvaluationContext();
     }
     
     void TearDown() override {
@@ -41,6 +44,8 @@ protected:
     std::filesystem::path testDir;
     std::filesystem::path oldFile;
     std::filesystem::path newFile;
+    // ages are measured from the scan start it holds
+    EvaluationContext context;
 };
 
 TEST_F(AgeConditionTest, ConstructorAndGetters) {
@@ -60,7 +65,7 @@ TEST_F(AgeConditionTest, OlderThanCondition) {
     ItemRepresentation newItem(newFile);
     
     // both files should be older than 50ms given our sleep
-    EXPECT_TRUE(condition.evaluate(oldItem));
+    EXPECT_TRUE(condition.evaluate(oldItem, context));
     // new file might or might not be older than 50ms, but old file definitely should be
 }
 
@@ -73,8 +78,8 @@ TEST_F(AgeConditionTest, NewerThanCondition) {
     ItemRepresentation newItem(newFile);
     
     // both files should be newer than 24 hours
-    EXPECT_TRUE(condition.evaluate(oldItem));
-    EXPECT_TRUE(condition.evaluate(newItem));
+    EXPECT_TRUE(condition.evaluate(oldItem, context));
+    EXPECT_TRUE(condition.evaluate(newItem, context));
 }
 
 TEST_F(AgeConditionTest, DirectoryHandling) {
@@ -85,7 +90,7 @@ TEST_F(AgeConditionTest, DirectoryHandling) {
     
     // directories should be handled the same as files for age
     // just test that it doesn't crash
-    bool result = condition.evaluate(dirItem);
+    bool result = condition.evaluate(dirItem, context);
     // don't assert specific value since it depends on timing
     (void)result; // suppress unused variable warning
 }
@@ -147,10 +152,40 @@ TEST_F(AgeConditionTest, EdgeCases) {
     ItemRepresentation item(newFile);
     
     // file should be older than 0 duration
-    EXPECT_TRUE(zeroCondition.evaluate(item));
+    EXPECT_TRUE(zeroCondition.evaluate(item, context));
     
     // test with very large threshold
     auto largeDuration = std::chrono::hours(24 * 365 * 100); // 100 years
     AgeCondition largeCondition(AgeComparison::NewerThan, largeDuration);
-    EXPECT_TRUE(largeCondition.evaluate(item)); // file should be newer than 100 years
-} 
\ No newline at end of file
+    EXPECT_TRUE(largeCondition.evaluate(item, context)); // file should be newer than 100 years
+} 
+TEST_F(AgeConditionTest, AgeIsMeasuredFromTheScanStart) {
+    AgeCondition olderThanDay(AgeComparison::OlderThan, std::chrono::hours(24));
+    AgeCondition newerThanDay(AgeComparison::NewerThan, std::chrono::hours(24));
+    ItemRepresentation item(newFile);
+    
+    EXPECT_FALSE(olderThanDay.evaluate(item, context));
+    EXPECT_TRUE(newerThanDay.evaluate(item, context));
+    
+    // the same item seen from a scan two days later is two days old
+    EvaluationContext later(context.getScanStart() + std::chrono::hours(48));
+    EXPECT_TRUE(olderThanDay.evaluate(item, later));
+    EXPECT_FALSE(newerThanDay.evaluate(item, later));
+    
+    // the cutoff depends on the snapshot only, not on when the check runs
+    EXPECT_EQ(later.cutoffFor(std::chrono::hours(24)), context.getScanStartFileTime() + std::chrono::hours(24));
+}
+
+TEST_F(AgeConditionTest, CutoffsAreWorkedOutOncePerRun) {
+    const EvaluationContext before;
+    const std::uint32_t week = EvaluationContext::registerAge(std::chrono::hours(24 * 7));
+    EXPECT_EQ(EvaluationContext::registerAge(std::chrono::hours(24 * 7)), week);
+    const EvaluationContext after(before.getScanStart());
+    
+    // a context made after the threshold was registered holds its cutoff; one made before
+    // works it out from the age it is given
+    const auto expected = before.getScanStartFileTime() - std::chrono::hours(24 * 7);
+    EXPECT_EQ(after.cutoffFor(week, std::chrono::hours(24 * 7)), expected);
+    EXPECT_EQ(after.cutoffFor(week, std::chrono::hours(0)), expected);
+    EXPECT_EQ(before.cutoffFor(week, std::chrono::hours(24 * 7)), expected);
+}
@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+#include <string>
+#include "core/BoundedQueue.h"
+
+TEST(BoundedQueueTest, FifoOrder) {
+    BoundedQueue<int> queue(4);
+    EXPECT_TRUE(queue.push(1));
+    EXPECT_TRUE(queue.push(2));
+    EXPECT_TRUE(queue.push(3));
+    EXPECT_EQ(queue.size(), 3);
+    
+    EXPECT_EQ(queue.pop(), 1);
+    EXPECT_EQ(queue.pop(), 2);
+    EXPECT_EQ(queue.pop(), 3);
+    EXPECT_EQ(queue.getPeakSize(), 3);
+}
+
+TEST(BoundedQueueTest, CloseDrainsRemainingItems) {
+    BoundedQueue<std::string> queue(2);
+    queue.push("a");
+    queue.close();
+    
+    // pushing after close fails, popping still drains
+    EXPECT_FALSE(queue.push("b"));
+    EXPECT_EQ(queue.pop(), "a");
+    EXPECT_EQ(queue.pop(), std::nullopt);
+}
+
+TEST(BoundedQueueTest, TryPopNeverBlocks) {
+    BoundedQueue<int> queue(2);
+    EXPECT_EQ(queue.tryPop(), std::nullopt);
+    queue.push(1);
+    EXPECT_EQ(queue.tryPop(), 1);
+    EXPECT_EQ(queue.tryPop(), std::nullopt);
+}
+
+TEST(BoundedQueueTest, ZeroCapacityIsClampedToOne) {
+    BoundedQueue<int> queue(0);
+    EXPECT_EQ(queue.getCapacity(), 1);
+}
+
+TEST(BoundedQueueTest, ProducerIsBoundedByCapacity) {
+    constexpr int itemCount = 10000;
+    BoundedQueue<int> queue(8);
+    
+    std::jthread producer([&] {
+        for (int i = 0; i < itemCount; ++i) {
+            queue.push(i);
+        }
+        queue.close();
+    });
+    
+    std::vector<int> received;
+    while (auto item = queue.pop()) {
+        received.push_back(*item);
+    }
+    producer.join();
+    
+    ASSERT_EQ(received.size(), itemCount);
+    for (int i = 0; i < itemCount; ++i) {
+        EXPECT_EQ(received[i], i);
+    }
+    EXPECT_LE(queue.getPeakSize(), 8);
+}
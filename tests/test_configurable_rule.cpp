@@ -1,9 +1,28 @@
 #include <gtest/gtest.h>
 #include "rules/ConfigurableRule.h"
 #include "conditions/ExtensionCondition.h"
+#include "conditions/SizeCondition.h"
+#include "conditions/AgeCondition.h"
+#include "conditions/NameCondition.h"
 #include "models/ItemRepresentation.h"
 #include <filesystem>
 #include <fstream>
+#include <memory>
+
+// A condition the rule only knows through ICondition
+class NameStartsWithCondition : public ICondition {
+public:
+    explicit NameStartsWithCondition(std::string prefix) : prefix(std::move(prefix)) {}
+    
+    bool evaluate(const ItemRepresentation& item, const EvaluationContext&) const override {
+        return item.getName().starts_with(prefix);
+    }
+    std::string describe() const override { return "name starts with '" + prefix + "'"; }
+    ItemAttribute requiredAttributes() const override { return ItemAttribute::None; }
+    
+private:
+    std::string prefix;
+};
 
 class ConfigurableRuleTest : public testing::Test {
 protected:
@@ -32,6 +51,7 @@ protected:
     std::filesystem::path txtFile;
     std::filesystem::path pdfFile;
     std::filesystem::path testSubDir;
+    EvaluationContext context;
 };
 
 TEST_F(ConfigurableRuleTest, BasicRuleProperties) {
@@ -48,9 +68,9 @@ TEST_F(ConfigurableRuleTest, RuleWithoutConditions) {
     ItemRepresentation dirItem(testSubDir);
     
     // Rule without conditions should match everything
-    EXPECT_TRUE(rule.matches(txtItem));
-    EXPECT_TRUE(rule.matches(pdfItem));
-    EXPECT_TRUE(rule.matches(dirItem));
+    EXPECT_TRUE(rule.matches(txtItem, context));
+    EXPECT_TRUE(rule.matches(pdfItem, context));
+    EXPECT_TRUE(rule.matches(dirItem, context));
     
     std::string description = rule.describe();
     EXPECT_TRUE(description.find("no conditions") != std::string::npos);
@@ -63,8 +83,8 @@ TEST_F(ConfigurableRuleTest, RuleWithSingleCondition) {
     ItemRepresentation txtItem(txtFile);
     ItemRepresentation pdfItem(pdfFile);
     
-    EXPECT_TRUE(rule.matches(txtItem));   // Should match .txt file
-    EXPECT_FALSE(rule.matches(pdfItem));  // Should not match .pdf file
+    EXPECT_TRUE(rule.matches(txtItem, context));   // Should match .txt file
+    EXPECT_FALSE(rule.matches(pdfItem, context));  // Should not match .pdf file
 }
 
 TEST_F(ConfigurableRuleTest, RuleWithMultipleConditions) {
@@ -75,7 +95,7 @@ TEST_F(ConfigurableRuleTest, RuleWithMultipleConditions) {
     ItemRepresentation txtItem(txtFile);
     
     // With only one condition, should still match
-    EXPECT_TRUE(rule.matches(txtItem));
+    EXPECT_TRUE(rule.matches(txtItem, context));
 }
 
 TEST_F(ConfigurableRuleTest, AddNullCondition) {
@@ -85,7 +105,7 @@ TEST_F(ConfigurableRuleTest, AddNullCondition) {
     ItemRepresentation txtItem(txtFile);
     
     // Should still work (no conditions added)
-    EXPECT_TRUE(rule.matches(txtItem));
+    EXPECT_TRUE(rule.matches(txtItem, context));
 }
 
 TEST_F(ConfigurableRuleTest, DescribeMethod) {
@@ -111,4 +131,60 @@ TEST_F(ConfigurableRuleTest, ComplexTargetPath) {
     
     std::filesystem::path expectedPath = std::filesystem::path("documents") / "work" / "projects" / "2024";
     EXPECT_EQ(rule.getTargetRelativePath(), expectedPath);
-} 
\ No newline at end of file
+} 
+TEST_F(ConfigurableRuleTest, RequiredAttributesAreUnionOfConditions) {
+    ConfigurableRule emptyRule("all", 1000);
+    EXPECT_EQ(emptyRule.requiredAttributes(), ItemAttribute::None);
+    
+    ConfigurableRule extensionRule("docs", 10);
+    extensionRule.addCondition(std::make_unique<ExtensionCondition>(".pdf"));
+    EXPECT_EQ(extensionRule.requiredAttributes(), ItemAttribute::Type);
+    
+    ConfigurableRule mixedRule("old_large", 20);
+    mixedRule.addCondition(std::make_unique<SizeCondition>(SizeComparison::GreaterThan, 1024));
+    mixedRule.addCondition(std::make_unique<AgeCondition>(AgeComparison::OlderThan, std::chrono::hours(24)));
+    EXPECT_EQ(mixedRule.requiredAttributes(), ItemAttribute::Type | ItemAttribute::Size | ItemAttribute::ModifiedTime);
+}
+
+TEST_F(ConfigurableRuleTest, CustomConditionsMixWithBuiltinOnes) {
+    ConfigurableRule rule("reports", 10);
+    rule.addCondition(std::make_unique<ExtensionCondition>(".pdf"));
+    rule.addCondition(std::make_unique<NameStartsWithCondition>("doc"));
+    rule.addCompiledCondition(SizeCondition(SizeComparison::LessThan, 1024));
+    rule.addCompiledCondition(std::unique_ptr<ICondition>());  // ignored like a null pointer
+    
+    EXPECT_TRUE(rule.matches(ItemRepresentation(pdfFile), context));
+    EXPECT_FALSE(rule.matches(ItemRepresentation(txtFile), context));
+    
+    std::ofstream(testDir / "summary.pdf") << "PDF content";
+    EXPECT_FALSE(rule.matches(ItemRepresentation(testDir / "summary.pdf"), context));
+    
+    EXPECT_EQ(rule.describe(), "Rule (priority=10, target='reports') with conditions: Extension equals '.pdf' "
+                               "AND name starts with 'doc' AND size less than 1 KB");
+    EXPECT_EQ(rule.requiredAttributes(), ItemAttribute::Type | ItemAttribute::Size);
+    EXPECT_EQ(rule.requiredExtension(), ".pdf");
+}
+
+TEST_F(ConfigurableRuleTest, CheckedNamesSkipOnlyNameConditions) {
+    ConfigurableRule rule("reports", 1);
+    rule.addCondition(std::make_unique<NameCondition>("report-*"));
+    rule.addCondition(std::make_unique<NameCondition>("*.pdf"));
+    rule.addCondition(std::make_unique<NameStartsWithCondition>("doc"));
+    rule.addCondition(std::make_unique<SizeCondition>(SizeComparison::GreaterThan, 5));
+    ASSERT_EQ(rule.requiredNamePatterns().size(), 2);
+    EXPECT_EQ(rule.requiredNamePatterns()[1].glob, "*.pdf");
+    
+    // the name patterns are taken as matched, everything else is still checked
+    ItemRepresentation pdf(pdfFile);
+    ItemRepresentation txt(txtFile);
+    EXPECT_FALSE(rule.matches(pdf, context));
+    EXPECT_TRUE(rule.matchesCheckedName(pdf, context));
+    EXPECT_FALSE(rule.matchesCheckedName(txt, context));
+    
+    ItemBatch batch;
+    batch.add(pdf);
+    batch.add(txt);
+    auto mask = batch.makeFullMask();
+    rule.matchBatchCheckedNames(batch, context, mask);
+    EXPECT_EQ(mask[0], 0b01);
+}
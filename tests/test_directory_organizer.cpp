@@ -7,6 +7,7 @@
 #include "core/Logger.h"
 #include "rules/ConfigurableRule.h"
 #include "conditions/ExtensionCondition.h"
+#include "conditions/SizeCondition.h"
 
 class DirectoryOrganizerTest : public testing::Test {
 protected:
@@ -353,4 +354,275 @@ TEST_F(DirectoryOrganizerTest, SkipItemsInTargetDirectory) {
     // Both files should exist in target
     EXPECT_TRUE(std::filesystem::exists(targetDir / "documents/pdf/source_file.pdf"));
     EXPECT_TRUE(std::filesystem::exists(targetDir / "documents/pdf/existing_file.pdf"));
-} 
\ No newline at end of file
+} 
+TEST_F(DirectoryOrganizerTest, ScanStatisticsWithMultipleThreads) {
+    createTestFile(sourceDir / "a.pdf");
+    createTestFile(sourceDir / "b.txt");
+    createTestFile(sourceDir / "c.xyz");
+    
+    OrganizerOptions options;
+    options.scanThreads = 4;
+    DirectoryOrganizer organizer(sourceDir, targetDir, copyRules(), true, options);
+    organizer.scanAndOrganize();
+    
+    const auto& stats = organizer.getStatistics();
+    EXPECT_EQ(stats.entriesScanned, 3);
+    EXPECT_EQ(stats.filesMovedOrWouldMove, 3);
+    EXPECT_GE(stats.scanSeconds, 0.0);
+    EXPECT_GE(stats.scanEntriesPerSecond, 0.0);
+}
+
+TEST_F(DirectoryOrganizerTest, MinimalQueueDepthPipeline) {
+    for (int i = 0; i < 50; ++i) {
+        createTestFile(sourceDir / ("doc" + std::to_string(i) + ".pdf"));
+        createTestFile(sourceDir / ("note" + std::to_string(i) + ".txt"));
+    }
+    
+    // a queue depth of one forces every stage to wait on the next one
+    OrganizerOptions options;
+    options.scanThreads = 2;
+    options.queueDepth = 1;
+    DirectoryOrganizer organizer(sourceDir, targetDir, copyRules(), false, options);
+    organizer.scanAndOrganize();
+    
+    const auto& stats = organizer.getStatistics();
+    EXPECT_EQ(stats.filesProcessed, 100);
+    EXPECT_EQ(stats.filesMovedOrWouldMove, 100);
+    EXPECT_EQ(stats.errors, 0);
+    EXPECT_EQ(countFilesInDirectory(targetDir / "documents/pdf"), 50);
+    EXPECT_EQ(countFilesInDirectory(targetDir / "documents/text"), 50);
+}
+
+TEST_F(DirectoryOrganizerTest, AttributeDemandFollowsRules) {
+    // extension rules and a catch-all only need the item type
+    DirectoryOrganizer organizer(sourceDir, targetDir, copyRules(), true);
+    EXPECT_EQ(organizer.getAttributeDemand(), ItemAttribute::Type);
+}
+
+TEST_F(DirectoryOrganizerTest, TargetInsideSourceIsNotScanned) {
+    const std::filesystem::path nestedTarget = sourceDir / "organized";
+    createTestFile(sourceDir / "new.pdf");
+    createTestFile(nestedTarget / "documents/pdf/old.pdf");
+    
+    DirectoryOrganizer organizer(sourceDir, nestedTarget, copyRules(), false);
+    organizer.scanAndOrganize();
+    
+    // only new.pdf is seen; nothing below the target is even listed
+    const auto& stats = organizer.getStatistics();
+    EXPECT_EQ(stats.filesProcessed, 1);
+    EXPECT_EQ(stats.directoriesProcessed, 0);
+    EXPECT_EQ(stats.entriesScanned, 2);
+    EXPECT_TRUE(std::filesystem::exists(nestedTarget / "documents/pdf/new.pdf"));
+    EXPECT_TRUE(std::filesystem::exists(nestedTarget / "documents/pdf/old.pdf"));
+}
+
+TEST_F(DirectoryOrganizerTest, MatchedDirectoryIsNotDescended) {
+    for (int i = 0; i < 20; ++i) {
+        createTestFile(sourceDir / "project/src" / ("file" + std::to_string(i) + ".txt"));
+    }
+    
+    DirectoryOrganizer organizer(sourceDir, targetDir, copyRules(), true);
+    organizer.scanAndOrganize();
+    
+    // the catch-all claims "project", so its contents are never listed
+    const auto& stats = organizer.getStatistics();
+    EXPECT_EQ(stats.entriesScanned, 1);
+    EXPECT_EQ(stats.directoriesMovedOrWouldMove, 1);
+    EXPECT_EQ(stats.filesProcessed, 0);
+}
+
+TEST_F(DirectoryOrganizerTest, ScanIndexSkipsUnchangedDirectories) {
+    createTestFile(sourceDir / "keep/deep/data.bin");
+    createTestFile(sourceDir / "keep/notes.md");
+    createTestFile(sourceDir / "report.pdf");
+    
+    auto extensionRules = [] {
+        std::vector<std::unique_ptr<ISortingRule>> extensionOnly;
+        auto pdfRule = std::make_unique<ConfigurableRule>("documents/pdf", 10);
+        pdfRule->addCondition(std::make_unique<ExtensionCondition>(".pdf"));
+        extensionOnly.push_back(std::move(pdfRule));
+        return extensionOnly;
+    };
+    OrganizerOptions options;
+    options.scanIndexFile = testBaseDir / "scan.index";
+    
+    // first run lists everything; the source root had a match so only keep/ and keep/deep are recorded
+    DirectoryOrganizer first(sourceDir, targetDir, extensionRules(), false, options);
+    first.scanAndOrganize();
+    EXPECT_EQ(first.getStatistics().filesMovedOrWouldMove, 1);
+    EXPECT_EQ(first.getStatistics().directoriesReused, 0);
+    
+    // second run lists the root again but reuses both untouched subdirectories
+    DirectoryOrganizer second(sourceDir, targetDir, extensionRules(), false, options);
+    second.scanAndOrganize();
+    EXPECT_EQ(second.getStatistics().directoriesReused, 2);
+    EXPECT_EQ(second.getStatistics().entriesScanned, 1);
+    EXPECT_EQ(second.getStatistics().errors, 0);
+    
+    // a new file changes keep/deep's mtime, so that directory is listed again
+    createTestFile(sourceDir / "keep/deep/late.pdf");
+    DirectoryOrganizer third(sourceDir, targetDir, extensionRules(), false, options);
+    third.scanAndOrganize();
+    EXPECT_EQ(third.getStatistics().filesMovedOrWouldMove, 1);
+    EXPECT_TRUE(std::filesystem::exists(targetDir / "documents/pdf/late.pdf"));
+}
+
+TEST_F(DirectoryOrganizerTest, ScanIndexDisabledForTimeDependentRules) {
+    createTestFile(sourceDir / "keep/notes.md");
+    
+    auto sizeRule = std::make_unique<ConfigurableRule>("large", 10);
+    sizeRule->addCondition(std::make_unique<SizeCondition>(SizeComparison::GreaterThan, 1024 * 1024));
+    std::vector<std::unique_ptr<ISortingRule>> sizeRules;
+    sizeRules.push_back(std::move(sizeRule));
+    
+    OrganizerOptions options;
+    options.scanIndexFile = testBaseDir / "scan.index";
+    DirectoryOrganizer organizer(sourceDir, targetDir, std::move(sizeRules), false, options);
+    organizer.scanAndOrganize();
+    
+    // a file can grow without touching its directory, so no index is kept
+    EXPECT_FALSE(std::filesystem::exists(options.scanIndexFile));
+}
+
+TEST_F(DirectoryOrganizerTest, OrganizeItemsHandlesOnlyGivenPaths) {
+    createTestFile(sourceDir / "changed.pdf");
+    createTestFile(sourceDir / "untouched.txt");
+    createTestFile(sourceDir / "incoming/nested/new.txt");
+    
+    auto extensionRules = copyRules();
+    extensionRules.pop_back();  // drop the catch-all so "incoming" is scanned instead of moved
+    DirectoryOrganizer organizer(sourceDir, targetDir, std::move(extensionRules), false);
+    organizer.organizeItems({sourceDir / "changed.pdf", sourceDir / "incoming", sourceDir / "vanished.pdf"});
+    
+    const auto& stats = organizer.getStatistics();
+    EXPECT_EQ(stats.filesMovedOrWouldMove, 2);
+    EXPECT_EQ(stats.errors, 0);
+    EXPECT_TRUE(std::filesystem::exists(targetDir / "documents/pdf/changed.pdf"));
+    EXPECT_TRUE(std::filesystem::exists(targetDir / "documents/text/new.txt"));
+    EXPECT_TRUE(std::filesystem::exists(sourceDir / "untouched.txt"));
+}
+
+TEST_F(DirectoryOrganizerTest, ParallelMovesResolveCollisions) {
+    for (int i = 0; i < 10; ++i) {
+        createTestFile(sourceDir / ("camera" + std::to_string(i)) / "report.pdf");
+        createTestFile(sourceDir / ("camera" + std::to_string(i)) / "notes.txt");
+    }
+    
+    auto extensionRules = copyRules();
+    extensionRules.pop_back();
+    OrganizerOptions options;
+    options.moveThreads = 4;
+    DirectoryOrganizer organizer(sourceDir, targetDir, std::move(extensionRules), false, options);
+    organizer.scanAndOrganize();
+    
+    const auto& stats = organizer.getStatistics();
+    EXPECT_EQ(stats.filesMovedOrWouldMove, 20);
+    EXPECT_EQ(stats.errors, 0);
+    EXPECT_GE(stats.moveQueuePeak, 1);
+    EXPECT_EQ(countFilesInDirectory(targetDir / "documents/pdf"), 10);
+    EXPECT_EQ(countFilesInDirectory(targetDir / "documents/text"), 10);
+    EXPECT_TRUE(std::filesystem::exists(targetDir / "documents/pdf/report_009.pdf"));
+}
+
+TEST_F(DirectoryOrganizerTest, IoUringBatchesResolveCollisions) {
+    for (int i = 0; i < 10; ++i) {
+        createTestFile(sourceDir / ("camera" + std::to_string(i)) / "report.pdf");
+        createTestFile(sourceDir / ("camera" + std::to_string(i)) / "big.txt", std::string(2048, 'x'));
+    }
+    
+    // the size rule makes every item need a statx, batched through the ring too
+    std::vector<std::unique_ptr<ISortingRule>> sizeRules;
+    auto pdfRule = std::make_unique<ConfigurableRule>("documents/pdf", 10);
+    pdfRule->addCondition(std::make_unique<ExtensionCondition>(".pdf"));
+    sizeRules.push_back(std::move(pdfRule));
+    auto bigRule = std::make_unique<ConfigurableRule>("large/new", 20);
+    bigRule->addCondition(std::make_unique<SizeCondition>(SizeComparison::GreaterThan, 1024));
+    sizeRules.push_back(std::move(bigRule));
+    
+    OrganizerOptions options;
+    options.ioUringDepth = 4;
+    DirectoryOrganizer organizer(sourceDir, targetDir, std::move(sizeRules), false, options);
+    organizer.scanAndOrganize();
+    
+    const auto& stats = organizer.getStatistics();
+    EXPECT_EQ(stats.filesMovedOrWouldMove, 20);
+    EXPECT_EQ(stats.errors, 0);
+    EXPECT_EQ(countFilesInDirectory(targetDir / "documents/pdf"), 10);
+    EXPECT_EQ(countFilesInDirectory(targetDir / "large/new"), 10);
+    EXPECT_TRUE(std::filesystem::exists(targetDir / "documents/pdf/report_009.pdf"));
+    // without io_uring everything takes the blocking path, with the same result
+    if (IoUring(1).isAvailable()) {
+        EXPECT_GT(stats.movesBatched, 0);
+    }
+}
+
+TEST_F(DirectoryOrganizerTest, RuleDirectoriesAreCreatedUpFront) {
+    createTestFile(sourceDir / "notes.txt");
+    
+    DirectoryOrganizer dryRunOrganizer(sourceDir, targetDir, copyRules(), true);
+    dryRunOrganizer.scanAndOrganize();
+    EXPECT_FALSE(std::filesystem::exists(targetDir / "documents/pdf"));
+    
+    DirectoryOrganizer organizer(sourceDir, targetDir, copyRules(), false);
+    organizer.scanAndOrganize();
+    EXPECT_TRUE(std::filesystem::is_directory(targetDir / "documents/pdf"));
+    EXPECT_TRUE(std::filesystem::is_directory(targetDir / "others"));
+    EXPECT_TRUE(std::filesystem::exists(targetDir / "documents/text/notes.txt"));
+}
+
+TEST_F(DirectoryOrganizerTest, RemovedTargetDirectoryIsRecreated) {
+    DirectoryOrganizer organizer(sourceDir, targetDir, copyRules(), false);
+    organizer.scanAndOrganize();
+    ASSERT_TRUE(std::filesystem::is_directory(targetDir / "documents/pdf"));
+    
+    // the organizer still believes the directory exists
+    std::filesystem::remove_all(targetDir / "documents/pdf");
+    createTestFile(sourceDir / "late.pdf");
+    organizer.organizeItems({sourceDir / "late.pdf"});
+    
+    EXPECT_EQ(organizer.getStatistics().errors, 0);
+    EXPECT_TRUE(std::filesystem::exists(targetDir / "documents/pdf/late.pdf"));
+}
+
+TEST_F(DirectoryOrganizerTest, MovedDirectoryNeverReplacesExistingOne) {
+    createTestFile(sourceDir / "photos/a.jpg");
+    std::filesystem::create_directories(targetDir / "others/photos");
+    
+    DirectoryOrganizer organizer(sourceDir, targetDir, copyRules(), false);
+    organizer.scanAndOrganize();
+    
+    // the empty directory already in the target stays, the new one gets a suffix
+    EXPECT_EQ(organizer.getStatistics().directoriesMovedOrWouldMove, 1);
+    EXPECT_TRUE(std::filesystem::is_empty(targetDir / "others/photos"));
+    EXPECT_TRUE(std::filesystem::exists(targetDir / "others/photos_001/a.jpg"));
+}
+
+TEST_F(DirectoryOrganizerTest, MovesAcrossFilesystems) {
+    // shared memory is a separate filesystem on most Linux systems
+    const std::filesystem::path otherFilesystem = "/dev/shm";
+    std::error_code ec;
+    if (!std::filesystem::is_directory(otherFilesystem, ec) ||
+        std::filesystem::space(otherFilesystem, ec).capacity == std::filesystem::space(testBaseDir, ec).capacity) {
+        GTEST_SKIP() << "no second filesystem available";
+    }
+    const std::filesystem::path remoteTarget = otherFilesystem / ("dir_organizer_test_" + testId);
+    createTestFile(sourceDir / "report.pdf", "pdf content");
+    createTestFile(sourceDir / "album/photo.jpg", "jpg");
+    
+    DirectoryOrganizer organizer(sourceDir, remoteTarget, copyRules(), false);
+    organizer.scanAndOrganize();
+    const auto stats = organizer.getStatistics();
+    const bool moved = std::filesystem::exists(remoteTarget / "documents/pdf/report.pdf") &&
+                       std::filesystem::exists(remoteTarget / "others/album/photo.jpg");
+    std::filesystem::remove_all(remoteTarget, ec);
+    
+    if (!stats.crossDeviceMoves) {
+        GTEST_SKIP() << "target turned out to be on the same filesystem";
+    }
+    EXPECT_TRUE(moved);
+    EXPECT_EQ(stats.errors, 0);
+    EXPECT_EQ(stats.crossDeviceMoves, 2);
+    EXPECT_EQ(stats.bytesCopied, 14);
+    EXPECT_GT(stats.copyBytesPerSecond, 0.0);
+    EXPECT_TRUE(std::filesystem::is_empty(sourceDir));
+}
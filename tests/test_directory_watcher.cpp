@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <chrono>
+#include "core/DirectoryWatcher.h"
+#include "core/Logger.h"
+#include "rules/ConfigurableRule.h"
+#include "conditions/ExtensionCondition.h"
+
+#ifdef __linux__
+
+class DirectoryWatcherTest : public testing::Test {
+protected:
+    void SetUp() override {
+        testId = std::to_string(std::chrono::high_resolution_clock::now().time_since_epoch().count());
+        testBaseDir = std::filesystem::temp_directory_path() / ("dir_watcher_test_" + testId);
+        sourceDir = testBaseDir / "source";
+        targetDir = testBaseDir / "target";
+        std::filesystem::create_directories(sourceDir / "existing");
+        Logger::instance().init(LogLevel::ERROR);
+        
+        std::vector<std::unique_ptr<ISortingRule>> rules;
+        auto pdfRule = std::make_unique<ConfigurableRule>("documents/pdf", 10);
+        pdfRule->addCondition(std::make_unique<ExtensionCondition>(".pdf"));
+        rules.push_back(std::move(pdfRule));
+        organizer = std::make_unique<DirectoryOrganizer>(sourceDir, targetDir, std::move(rules), false);
+    }
+    
+    void TearDown() override {
+        // the watcher must be stopped before the directories and organizer go away
+        if (watcher) {
+            watcher->stop();
+        }
+        if (watcherThread.joinable()) {
+            watcherThread.join();
+        }
+        watcher.reset();
+        std::filesystem::remove_all(testBaseDir);
+        Logger::instance().reset();
+    }
+    
+    static void createTestFile(const std::filesystem::path& path) {
+        std::filesystem::create_directories(path.parent_path());
+        std::ofstream(path) << "test content";
+    }
+    
+    static bool waitFor(const std::filesystem::path& path) {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (std::chrono::steady_clock::now() < deadline) {
+            if (std::filesystem::exists(path)) {
+                return true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return false;
+    }
+    
+    // run() first organizes the existing tree; a marker file tells when that pass is done
+    void startWatching() {
+        watcher = std::make_unique<DirectoryWatcher>(*organizer, WatchOptions{std::chrono::milliseconds(20), std::chrono::seconds(60)});
+        createTestFile(sourceDir / "marker.pdf");
+        watcherThread = std::jthread([this] { EXPECT_TRUE(watcher->run()); });
+        ASSERT_TRUE(waitFor(targetDir / "documents/pdf/marker.pdf"));
+    }
+    
+    void stopWatching() {
+        watcher->stop();
+        watcherThread.join();
+    }
+    
+    std::string testId;
+    std::filesystem::path testBaseDir;
+    std::filesystem::path sourceDir;
+    std::filesystem::path targetDir;
+    std::unique_ptr<DirectoryOrganizer> organizer;
+    std::unique_ptr<DirectoryWatcher> watcher;
+    std::jthread watcherThread;
+};
+
+TEST_F(DirectoryWatcherTest, OrganizesNewFiles) {
+    startWatching();
+    
+    createTestFile(sourceDir / "existing/report.pdf");
+    createTestFile(sourceDir / "notes.txt");
+    EXPECT_TRUE(waitFor(targetDir / "documents/pdf/report.pdf"));
+    
+    stopWatching();
+    
+    EXPECT_TRUE(std::filesystem::exists(sourceDir / "notes.txt"));
+    EXPECT_GE(watcher->getStatistics().batchesProcessed, 1);
+    EXPECT_EQ(watcher->getStatistics().overflows, 0);
+}
+
+TEST_F(DirectoryWatcherTest, WatchesNewDirectories) {
+    startWatching();
+    const size_t initialWatches = watcher->getWatchCount();
+    
+    // a directory moved in with contents already inside, then a file written into it later
+    createTestFile(testBaseDir / "staging/batch/first.pdf");
+    std::filesystem::rename(testBaseDir / "staging/batch", sourceDir / "batch");
+    EXPECT_TRUE(waitFor(targetDir / "documents/pdf/first.pdf"));
+    
+    createTestFile(sourceDir / "batch/second.pdf");
+    EXPECT_TRUE(waitFor(targetDir / "documents/pdf/second.pdf"));
+    EXPECT_EQ(watcher->getWatchCount(), initialWatches + 1);
+    stopWatching();
+}
+
+TEST_F(DirectoryWatcherTest, StopBeforeRunReturnsImmediately) {
+    DirectoryWatcher idleWatcher(*organizer);
+    idleWatcher.stop();
+    EXPECT_TRUE(idleWatcher.run());
+    EXPECT_EQ(idleWatcher.getStatistics().batchesProcessed, 0);
+}
+
+#endif
@@ -34,13 +34,14 @@ protected:
     std::filesystem::path pdfFile;
     std::filesystem::path noExtFile;
     std::filesystem::path testSubDir;
+    EvaluationContext context;
 };
 
 TEST_F(ExtensionConditionTest, MatchingExtensionWithDot) {
     ExtensionCondition condition(".txt");
     ItemRepresentation item(txtFile);
     
-    EXPECT_TRUE(condition.evaluate(item));
+    EXPECT_TRUE(condition.evaluate(item, context));
     EXPECT_EQ(condition.describe(), "Extension equals '.txt'");
 }
 
@@ -48,7 +49,7 @@ TEST_F(ExtensionConditionTest, MatchingExtensionWithoutDot) {
     ExtensionCondition condition("txt");  // Should automatically add dot
     ItemRepresentation item(txtFile);
     
-    EXPECT_TRUE(condition.evaluate(item));
+    EXPECT_TRUE(condition.evaluate(item, context));
     EXPECT_EQ(condition.describe(), "Extension equals '.txt'");
 }
 
@@ -56,35 +57,35 @@ TEST_F(ExtensionConditionTest, CaseInsensitiveMatching) {
     ExtensionCondition condition(".pdf");
     ItemRepresentation item(pdfFile);  // File has .PDF extension
     
-    EXPECT_TRUE(condition.evaluate(item));
+    EXPECT_TRUE(condition.evaluate(item, context));
 }
 
 TEST_F(ExtensionConditionTest, NonMatchingExtension) {
     ExtensionCondition condition(".pdf");
     ItemRepresentation item(txtFile);
     
-    EXPECT_FALSE(condition.evaluate(item));
+    EXPECT_FALSE(condition.evaluate(item, context));
 }
 
 TEST_F(ExtensionConditionTest, FileWithoutExtension) {
     ExtensionCondition condition(".txt");
     ItemRepresentation item(noExtFile);
     
-    EXPECT_FALSE(condition.evaluate(item));
+    EXPECT_FALSE(condition.evaluate(item, context));
 }
 
 TEST_F(ExtensionConditionTest, DirectoryDoesNotMatch) {
     ExtensionCondition condition(".txt");
     ItemRepresentation item(testSubDir);
     
-    EXPECT_FALSE(condition.evaluate(item));  // Directories don't have extensions
+    EXPECT_FALSE(condition.evaluate(item, context));  // Directories don't have extensions
 }
 
 TEST_F(ExtensionConditionTest, EmptyExtension) {
     ExtensionCondition condition("");
     ItemRepresentation item(noExtFile);
     
-    EXPECT_TRUE(condition.evaluate(item));  // Empty extension should match files without extension
+    EXPECT_TRUE(condition.evaluate(item, context));  // Empty extension should match files without extension
 }
 
 TEST_F(ExtensionConditionTest, DescribeMethod) {
@@ -100,7 +101,7 @@ TEST_F(ExtensionConditionTest, TemplateSetExtension) {
     ItemRepresentation item(txtFile);
     
     // initial check
-    EXPECT_TRUE(condition.evaluate(item));
+    EXPECT_TRUE(condition.evaluate(item, context));
     EXPECT_EQ(condition.getExtension(), ".txt");
     
     // test template member function with different string types
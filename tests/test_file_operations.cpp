@@ -0,0 +1,188 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <chrono>
+#include <utility>
+#include <vector>
+#include <sys/stat.h>
+#include "core/FileOperations.h"
+
+class FileOperationsTest : public testing::Test {
+protected:
+    void SetUp() override {
+        testId = std::to_string(std::chrono::high_resolution_clock::now().time_since_epoch().count());
+        testDir = std::filesystem::temp_directory_path() / ("file_operations_test_" + testId);
+        std::filesystem::create_directories(testDir / "target");
+    }
+    
+    void TearDown() override {
+        std::filesystem::remove_all(testDir);
+    }
+    
+    void writeFile(const std::filesystem::path& path, const std::string& content) {
+        std::ofstream(path) << content;
+    }
+    
+    static std::string readFile(const std::filesystem::path& path) {
+        std::ifstream file(path);
+        return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    }
+    
+    std::string testId;
+    std::filesystem::path testDir;
+};
+
+TEST_F(FileOperationsTest, DirectoryHandleOpensExistingDirectory) {
+    const DirectoryHandle handle(testDir / "target");
+    const DirectoryHandle missing(testDir / "missing");
+#if defined(__unix__) || defined(__APPLE__)
+    EXPECT_TRUE(handle.isValid());
+#endif
+    EXPECT_FALSE(missing.isValid());
+    EXPECT_EQ(handle.getPath(), testDir / "target");
+}
+
+TEST_F(FileOperationsTest, RenameNoReplaceMovesFile) {
+    writeFile(testDir / "a.txt", "a");
+    const DirectoryHandle target(testDir / "target");
+    
+    const std::error_code ec = renameNoReplace(testDir / "a.txt", target, "b.txt");
+    if (ec == std::errc::operation_not_supported) {
+        GTEST_SKIP() << "RENAME_NOREPLACE not supported here";
+    }
+    ASSERT_FALSE(ec) << ec.message();
+    EXPECT_FALSE(std::filesystem::exists(testDir / "a.txt"));
+    EXPECT_EQ(readFile(testDir / "target/b.txt"), "a");
+}
+
+TEST_F(FileOperationsTest, RenameNoReplaceNeverClobbers) {
+    writeFile(testDir / "a.txt", "new");
+    writeFile(testDir / "target/a.txt", "old");
+    const DirectoryHandle target(testDir / "target");
+    
+    const std::error_code ec = renameNoReplace(testDir / "a.txt", target, "a.txt");
+    if (ec == std::errc::operation_not_supported) {
+        GTEST_SKIP() << "RENAME_NOREPLACE not supported here";
+    }
+    EXPECT_EQ(ec, std::errc::file_exists);
+    EXPECT_EQ(readFile(testDir / "target/a.txt"), "old");
+    EXPECT_TRUE(std::filesystem::exists(testDir / "a.txt"));
+}
+
+TEST_F(FileOperationsTest, RenameNoReplaceRelativeToSourceDirectory) {
+    std::filesystem::create_directories(testDir / "source/nested");
+    writeFile(testDir / "source/nested/a.txt", "a");
+    const DirectoryHandle source(testDir / "source");
+    const DirectoryHandle nested(source, "nested", DirectoryHandle::Access::List);
+    const DirectoryHandle target(testDir / "target");
+    EXPECT_EQ(nested.getPath(), testDir / "source/nested");
+    
+    const std::error_code ec = renameNoReplace(nested, "a.txt", target, "b.txt");
+    if (ec == std::errc::operation_not_supported) {
+        GTEST_SKIP() << "RENAME_NOREPLACE not supported here";
+    }
+    ASSERT_FALSE(ec) << ec.message();
+    EXPECT_FALSE(std::filesystem::exists(testDir / "source/nested/a.txt"));
+    EXPECT_EQ(readFile(testDir / "target/b.txt"), "a");
+}
+
+TEST_F(FileOperationsTest, MoveAcrossDevicesKeepsContentModeAndTime) {
+    writeFile(testDir / "a.txt", "content");
+    std::filesystem::permissions(testDir / "a.txt", std::filesystem::perms::owner_read | std::filesystem::perms::group_read);
+    const auto modified = std::filesystem::file_time_type::clock::now() - std::chrono::hours(48);
+    std::filesystem::last_write_time(testDir / "a.txt", modified);
+    
+    const CrossDeviceResult result = moveAcrossDevices(testDir / "a.txt", testDir / "target/a.txt", {});
+    ASSERT_FALSE(result.error) << result.error.message();
+    EXPECT_EQ(result.bytesCopied, 7);
+    EXPECT_FALSE(std::filesystem::exists(testDir / "a.txt"));
+    EXPECT_EQ(readFile(testDir / "target/a.txt"), "content");
+    EXPECT_EQ(std::filesystem::status(testDir / "target/a.txt").permissions(),
+              std::filesystem::perms::owner_read | std::filesystem::perms::group_read);
+    EXPECT_EQ(std::filesystem::last_write_time(testDir / "target/a.txt"), modified);
+}
+
+TEST_F(FileOperationsTest, MoveAcrossDevicesSplitsLargeFilesIntoChunks) {
+    std::string content;
+    for (size_t i = 0; content.size() < (5u << 20); ++i) {
+        content += std::to_string(i) + '\n';
+    }
+    writeFile(testDir / "big.bin", content);
+    
+    CrossDeviceOptions options;
+    options.threads = 3;
+    options.parallelThreshold = 1;
+    options.chunkSize = 1 << 20;
+    const CrossDeviceResult result = moveAcrossDevices(testDir / "big.bin", testDir / "target/big.bin", options);
+    ASSERT_FALSE(result.error) << result.error.message();
+    EXPECT_EQ(result.bytesCopied, content.size());
+    EXPECT_TRUE(readFile(testDir / "target/big.bin") == content);
+}
+
+TEST_F(FileOperationsTest, MoveAcrossDevicesKeepsHoles) {
+    const std::filesystem::path sparse = testDir / "sparse.img";
+    {
+        std::ofstream file(sparse, std::ios::binary);
+        file.seekp((8 << 20) - 4);
+        file << "tail";
+    }
+    const std::uintmax_t size = std::filesystem::file_size(sparse);
+    
+    const CrossDeviceResult result = moveAcrossDevices(sparse, testDir / "target/sparse.img", {});
+    ASSERT_FALSE(result.error) << result.error.message();
+    EXPECT_EQ(std::filesystem::file_size(testDir / "target/sparse.img"), size);
+    // only the data at the end is copied when the filesystem reports holes
+    EXPECT_LT(result.bytesCopied, size);
+    const std::string copied = readFile(testDir / "target/sparse.img");
+    EXPECT_EQ(copied.substr(copied.size() - 4), "tail");
+    EXPECT_EQ(copied.find_first_not_of('\0'), copied.size() - 4);
+}
+
+TEST_F(FileOperationsTest, MoveAcrossDevicesNeverClobbers) {
+    writeFile(testDir / "a.txt", "new");
+    writeFile(testDir / "target/a.txt", "old");
+    
+    const CrossDeviceResult result = moveAcrossDevices(testDir / "a.txt", testDir / "target/a.txt", {});
+    EXPECT_EQ(result.error, std::errc::file_exists);
+    EXPECT_EQ(readFile(testDir / "target/a.txt"), "old");
+    EXPECT_EQ(readFile(testDir / "a.txt"), "new");
+}
+
+TEST_F(FileOperationsTest, MoveAcrossDevicesCopiesDirectoryTree) {
+    std::filesystem::create_directories(testDir / "album/nested");
+    writeFile(testDir / "album/a.jpg", "a");
+    writeFile(testDir / "album/nested/b.jpg", "bb");
+    std::filesystem::create_symlink("a.jpg", testDir / "album/cover.jpg");
+    
+    const CrossDeviceResult result = moveAcrossDevices(testDir / "album", testDir / "target/album", {});
+    ASSERT_FALSE(result.error) << result.error.message();
+    EXPECT_EQ(result.bytesCopied, 3);
+    EXPECT_FALSE(std::filesystem::exists(testDir / "album"));
+    EXPECT_EQ(readFile(testDir / "target/album/nested/b.jpg"), "bb");
+    EXPECT_EQ(std::filesystem::read_symlink(testDir / "target/album/cover.jpg"), "a.jpg");
+}
+
+TEST_F(FileOperationsTest, MoveAcrossDevicesReportsTheEntryItCreates) {
+    std::filesystem::create_directories(testDir / "album");
+    writeFile(testDir / "album/a.jpg", "a");
+    writeFile(testDir / "b.txt", "b");
+    
+    // once per move, for the top-level entry only
+    std::vector<std::pair<std::uint64_t, std::uint64_t>> reported;
+    const CopyCreated record = [&](const std::uint64_t device, const std::uint64_t inode) {
+        reported.emplace_back(device, inode);
+        return true;
+    };
+    ASSERT_FALSE(moveAcrossDevices(testDir / "album", testDir / "target/album", {}, record).error);
+    ASSERT_EQ(reported.size(), 1);
+    struct stat created {};
+    ASSERT_EQ(::lstat((testDir / "target/album").c_str(), &created), 0);
+    EXPECT_EQ(reported[0], std::make_pair(static_cast<std::uint64_t>(created.st_dev), static_cast<std::uint64_t>(created.st_ino)));
+    
+    // refusing abandons the move before anything is copied
+    const CrossDeviceResult refused = moveAcrossDevices(testDir / "b.txt", testDir / "target/b.txt", {},
+                                                        [](std::uint64_t, std::uint64_t) { return false; });
+    EXPECT_EQ(refused.error, std::errc::operation_canceled);
+    EXPECT_FALSE(std::filesystem::exists(testDir / "target/b.txt"));
+    EXPECT_EQ(readFile(testDir / "b.txt"), "b");
+}
@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <chrono>
+#include <string>
+#include "core/IoUring.h"
+#include "core/Logger.h"
+#include "models/FileMetadata.h"
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <linux/fs.h>
+#include <cerrno>
+
+class IoUringTest : public testing::Test {
+protected:
+    void SetUp() override {
+        testDir = std::filesystem::temp_directory_path() /
+                  ("io_uring_test_" + std::to_string(std::chrono::high_resolution_clock::now().time_since_epoch().count()));
+        std::filesystem::create_directories(testDir);
+        Logger::instance().init(LogLevel::ERROR);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(testDir);
+        Logger::instance().reset();
+    }
+
+    void writeFile(const std::filesystem::path& path, const std::string& content = "content") {
+        std::ofstream(path) << content;
+    }
+
+    std::filesystem::path testDir;
+};
+
+TEST_F(IoUringTest, BatchesStatxMkdirAndRename) {
+    IoUring ring(8);
+    if (!ring.isAvailable()) {
+        GTEST_SKIP() << "io_uring not available";
+    }
+    writeFile(testDir / "a.txt", "12345");
+    const std::string source = (testDir / "a.txt").string();
+    const std::string missing = (testDir / "missing.txt").string();
+    const std::string directory = (testDir / "sorted").string();
+
+    struct statx found{};
+    struct statx notFound{};
+    ASSERT_TRUE(ring.queueStatx(AT_FDCWD, source.c_str(), fileMetadataStatxMask(), &found));
+    ASSERT_TRUE(ring.queueStatx(AT_FDCWD, missing.c_str(), fileMetadataStatxMask(), &notFound));
+    ASSERT_TRUE(ring.queueMkdirat(AT_FDCWD, directory.c_str(), 0777));
+    EXPECT_EQ(ring.getQueuedCount(), 3);
+
+    const auto results = ring.submitAndWait();
+    ASSERT_EQ(results.size(), 3);
+    EXPECT_EQ(results[0], 0);
+    EXPECT_EQ(results[1], -ENOENT);
+    EXPECT_EQ(results[2], 0);
+    EXPECT_EQ(toFileMetadata(found).sizeInBytes, 5);
+    EXPECT_TRUE(std::filesystem::is_directory(directory));
+    EXPECT_EQ(ring.getQueuedCount(), 0);
+
+    writeFile(testDir / "sorted/taken.txt");
+    const std::string target = (testDir / "sorted/a.txt").string();
+    const std::string taken = (testDir / "sorted/taken.txt").string();
+    ASSERT_TRUE(ring.queueRenameat(AT_FDCWD, source.c_str(), AT_FDCWD, target.c_str(), RENAME_NOREPLACE));
+    const auto renamed = ring.submitAndWait();
+    ASSERT_EQ(renamed.size(), 1);
+    EXPECT_EQ(renamed[0], 0);
+    EXPECT_TRUE(std::filesystem::exists(target));
+
+    // never replaces an existing entry
+    ASSERT_TRUE(ring.queueRenameat(AT_FDCWD, target.c_str(), AT_FDCWD, taken.c_str(), RENAME_NOREPLACE));
+    EXPECT_EQ(ring.submitAndWait()[0], -EEXIST);
+    EXPECT_TRUE(std::filesystem::exists(target));
+}
+
+TEST_F(IoUringTest, FullBatchRefusesMore) {
+    IoUring ring(2);
+    if (!ring.isAvailable()) {
+        GTEST_SKIP() << "io_uring not available";
+    }
+    const std::string path = testDir.string();
+    std::vector<struct statx> results(ring.getQueueDepth() + 1);
+    for (unsigned i = 0; i < ring.getQueueDepth(); ++i) {
+        ASSERT_TRUE(ring.queueStatx(AT_FDCWD, path.c_str(), fileMetadataStatxMask(), &results[i]));
+    }
+    EXPECT_FALSE(ring.queueStatx(AT_FDCWD, path.c_str(), fileMetadataStatxMask(), &results.back()));
+    EXPECT_EQ(ring.submitAndWait().size(), ring.getQueueDepth());
+}
+
+#endif
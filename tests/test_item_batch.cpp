@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+#include "models/ItemBatch.h"
+#include "models/ExtensionIds.h"
+#include "conditions/BatchKernels.h"
+#include "conditions/SizeCondition.h"
+#include "conditions/AgeCondition.h"
+#include "conditions/ExtensionCondition.h"
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+class ItemBatchTest : public testing::Test {
+protected:
+    // a batch over more than one mask word with files of every size class, directories and
+    // modification times spread over two days
+    void SetUp() override {
+        // as the rules of a real run would, before anything is scanned
+        for (const char* extension : {".pdf", ".txt", ".gz"}) {
+            ExtensionIds::intern(extension);
+        }
+        const auto now = std::filesystem::file_time_type::clock::now();
+        const std::vector<std::string> names = {"a.pdf", "b.PDF", "c.txt", "d", "e.tar.gz"};
+        for (size_t i = 0; i < 130; ++i) {
+            FileMetadata metadata;
+            metadata.type = i % 7 == 3 ? ItemType::Directory : ItemType::File;
+            metadata.sizeInBytes = i * 100;
+            metadata.lastModified = now - std::chrono::minutes(i * 20);
+            items.emplace_back(std::filesystem::path("batch") / names[i % names.size()], metadata);
+        }
+        for (const auto& item : items) {
+            batch.add(item);
+        }
+    }
+
+    // The mask the condition evaluated item by item gives
+    std::vector<std::uint64_t> expectedMask(const ICondition& condition) const {
+        std::vector<std::uint64_t> mask(batch.getMaskWords(), 0);
+        for (size_t i = 0; i < items.size(); ++i) {
+            if (condition.evaluate(items[i], context)) {
+                mask[i / 64] |= std::uint64_t{1} << (i % 64);
+            }
+        }
+        return mask;
+    }
+
+    std::vector<std::uint64_t> batchMask(const ICondition& condition) const {
+        auto mask = batch.makeFullMask();
+        condition.evaluateBatch(batch, context, mask);
+        return mask;
+    }
+
+    std::vector<ItemRepresentation> items;
+    ItemBatch batch;
+    EvaluationContext context;
+};
+
+TEST_F(ItemBatchTest, ColumnsFollowTheItems) {
+    ASSERT_EQ(batch.size(), 130);
+    EXPECT_EQ(batch.getMaskWords(), 3);
+    EXPECT_EQ(batch.getSizes()[5], 500);
+    EXPECT_EQ(batch.getTypes()[3], ItemType::Directory);
+    EXPECT_EQ(batch.getFileMask()[0] & 0b1000, 0);
+    EXPECT_EQ(batch.getModifiedTimes()[2], items[2].getLastModifiedDate().time_since_epoch().count());
+
+    // case-insensitive ids, none for directories and files without an extension
+    EXPECT_EQ(batch.getExtensionIds()[0], batch.getExtensionIds()[1]);
+    EXPECT_EQ(batch.getExtensionIds()[0], ExtensionIds::intern(".pdf"));
+    EXPECT_NE(batch.getExtensionIds()[0], batch.getExtensionIds()[2]);
+    EXPECT_EQ(batch.getExtensionIds()[3], ExtensionIds::None);
+    EXPECT_EQ(batch.getExtensionIds()[4], ExtensionIds::intern(".GZ"));
+
+    const auto full = batch.makeFullMask();
+    EXPECT_EQ(full[1], ~std::uint64_t{0});
+    EXPECT_EQ(full[2], 0b11);
+}
+
+TEST_F(ItemBatchTest, ConditionsGiveTheSameMatchesAsItemByItem) {
+    const SizeCondition larger(SizeComparison::GreaterThan, 6400);
+    const SizeCondition smaller(SizeComparison::LessThan, 6400);
+    const AgeCondition older(AgeComparison::OlderThan, std::chrono::hours(24));
+    const AgeCondition newer(AgeComparison::NewerThan, std::chrono::hours(24));
+    const ExtensionCondition pdf(".pdf");
+    const ExtensionCondition bare(".");
+    for (const ICondition* condition : std::initializer_list<const ICondition*>{&larger, &smaller, &older, &newer, &pdf, &bare}) {
+        EXPECT_EQ(batchMask(*condition), expectedMask(*condition)) << condition->describe();
+    }
+}
+
+TEST(BatchKernelsTest, MatchScalarComparisons) {
+    // a partial last word, unsigned values above INT64_MAX and negative signed ones
+    std::mt19937_64 random(42);
+    std::vector<std::uint64_t> unsignedValues(203);
+    std::vector<std::int64_t> signedValues(unsignedValues.size());
+    for (size_t i = 0; i < unsignedValues.size(); ++i) {
+        unsignedValues[i] = random() >> (i % 3 == 0 ? 0 : 40);
+        signedValues[i] = static_cast<std::int64_t>(random() >> 40) - (std::int64_t{1} << 23);
+    }
+    const std::uint64_t unsignedThreshold = std::uint64_t{1} << 63;
+    const std::int64_t signedThreshold = -12345;
+    // some items already excluded
+    const std::vector<std::uint64_t> initial = {0xF0F0F0F0F0F0F0F0, ~std::uint64_t{0}, 0, 0x7FF};
+
+    const auto expected = [&](auto values, auto compare) {
+        std::vector<std::uint64_t> mask = initial;
+        for (size_t i = 0; i < values.size(); ++i) {
+            if (!compare(values[i])) {
+                mask[i / 64] &= ~(std::uint64_t{1} << (i % 64));
+            }
+        }
+        return mask;
+    };
+
+    std::vector<std::uint64_t> mask = initial;
+    keepGreaterThan(std::span<const std::uint64_t>(unsignedValues), unsignedThreshold, mask);
+    EXPECT_EQ(mask, expected(unsignedValues, [&](const std::uint64_t value) { return value > unsignedThreshold; }));
+    mask = initial;
+    keepLessThan(std::span<const std::uint64_t>(unsignedValues), unsignedThreshold, mask);
+    EXPECT_EQ(mask, expected(unsignedValues, [&](const std::uint64_t value) { return value < unsignedThreshold; }));
+    mask = initial;
+    keepGreaterThan(std::span<const std::int64_t>(signedValues), signedThreshold, mask);
+    EXPECT_EQ(mask, expected(signedValues, [&](const std::int64_t value) { return value > signedThreshold; }));
+    mask = initial;
+    keepLessThan(std::span<const std::int64_t>(signedValues), signedThreshold, mask);
+    EXPECT_EQ(mask, expected(signedValues, [&](const std::int64_t value) { return value < signedThreshold; }));
+}
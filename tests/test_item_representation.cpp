@@ -1,7 +1,9 @@
 #include <gtest/gtest.h>
 #include "models/ItemRepresentation.h"
+#include "models/ExtensionIds.h"
 #include <filesystem>
 #include <fstream>
+#include <sys/stat.h>
 
 class ItemRepresentationTest : public testing::Test {
 protected:
@@ -85,4 +87,113 @@ TEST_F(ItemRepresentationTest, LastModifiedTime) {
     
     // Should be modified within the last 60 seconds (generous for test environment)
     EXPECT_LT(diff.count(), 60);
-} 
\ No newline at end of file
+} 
+TEST_F(ItemRepresentationTest, IdentityFieldsMatchFilesystem) {
+    ItemRepresentation item(testFile);
+    
+    EXPECT_NE(item.getInode(), 0);
+    EXPECT_EQ(item.getLinkCount(), std::filesystem::hard_link_count(testFile));
+    EXPECT_EQ(item.getSizeInBytes(), std::filesystem::file_size(testFile));
+    EXPECT_EQ(item.getLastModifiedDate(), std::filesystem::last_write_time(testFile));
+}
+
+TEST_F(ItemRepresentationTest, HardLinksShareInodeAndDevice) {
+    const std::filesystem::path linkPath = testDir / "hard_link.txt";
+    std::filesystem::create_hard_link(testFile, linkPath);
+    
+    ItemRepresentation original(testFile);
+    ItemRepresentation link(linkPath);
+    
+    EXPECT_EQ(original.getInode(), link.getInode());
+    EXPECT_EQ(original.getDevice(), link.getDevice());
+    EXPECT_EQ(link.getLinkCount(), 2);
+}
+
+TEST_F(ItemRepresentationTest, ConstructFromMetadata) {
+    const auto metadata = readFileMetadata(testFile);
+    ASSERT_TRUE(metadata.has_value());
+    EXPECT_EQ(metadata->type, ItemType::File);
+    
+    ItemRepresentation item(testFile, *metadata);
+    EXPECT_EQ(item.getType(), ItemType::File);
+    EXPECT_EQ(item.getName(), "test_file.txt");
+    EXPECT_EQ(item.getExtension(), ".txt");
+    EXPECT_EQ(item.getSizeInBytes(), metadata->sizeInBytes);
+    EXPECT_EQ(item.getCreationDate(), metadata->birthTime);
+}
+
+TEST_F(ItemRepresentationTest, MetadataIdentityMatchesStat) {
+    // identities are compared across runs that may have used the fstatat fallback
+    struct stat st{};
+    ASSERT_EQ(::stat(testFile.c_str(), &st), 0);
+    const auto metadata = readFileMetadata(testFile);
+    ASSERT_TRUE(metadata.has_value());
+    EXPECT_EQ(metadata->device, static_cast<std::uint64_t>(st.st_dev));
+    EXPECT_EQ(metadata->inode, static_cast<std::uint64_t>(st.st_ino));
+}
+
+TEST_F(ItemRepresentationTest, MetadataForMissingItem) {
+    EXPECT_FALSE(readFileMetadata(testDir / "missing.txt").has_value());
+}
+
+TEST_F(ItemRepresentationTest, LazyAttributeLoading) {
+    ItemRepresentation item(testFile, ItemAttribute::None);
+    
+    // only path-derived fields are available without a metadata query
+    EXPECT_EQ(item.getLoadedAttributes(), ItemAttribute::None);
+    EXPECT_EQ(item.getName(), "test_file.txt");
+    EXPECT_EQ(item.getLoadedAttributes(), ItemAttribute::None);
+    
+    // the first getter that needs metadata fetches it
+    EXPECT_GT(item.getSizeInBytes(), 0);
+    EXPECT_TRUE(hasAttributes(item.getLoadedAttributes(), ItemAttribute::Size));
+    EXPECT_EQ(item.getType(), ItemType::File);
+}
+
+TEST_F(ItemRepresentationTest, DemandedAttributesLoadedUpFront) {
+    ItemRepresentation item(testSubDir, ItemAttribute::Type);
+    
+    EXPECT_TRUE(hasAttributes(item.getLoadedAttributes(), ItemAttribute::Type));
+    EXPECT_EQ(item.getType(), ItemType::Directory);
+    EXPECT_EQ(item.getExtension(), "");
+}
+
+TEST_F(ItemRepresentationTest, KnownTypeNeedsNoMetadataQuery) {
+    ItemRepresentation file(testFile, ItemType::File, ItemAttribute::Type);
+    EXPECT_EQ(file.getLoadedAttributes(), ItemAttribute::Type);
+    EXPECT_EQ(file.getType(), ItemType::File);
+    EXPECT_EQ(file.getExtension(), ".txt");
+    
+    ItemRepresentation directory(testDir / "dir.with.dots", ItemType::Directory, ItemAttribute::Type);
+    EXPECT_EQ(directory.getExtension(), "");
+    
+    // attributes outside the demand are still fetched when asked for
+    EXPECT_GT(file.getSizeInBytes(), 0);
+}
+
+TEST_F(ItemRepresentationTest, ExtensionIdIgnoresCase) {
+    std::ofstream(testDir / "UPPER.TXT") << "Upper case";
+    const std::uint32_t txt = ExtensionIds::intern(".tXt");
+    ItemRepresentation lower(testFile);
+    ItemRepresentation upper(testDir / "UPPER.TXT");
+    
+    EXPECT_EQ(upper.getExtension(), ".TXT");  // the name is kept as it is
+    EXPECT_EQ(lower.getExtensionId(), upper.getExtensionId());
+    EXPECT_EQ(lower.getExtensionId(), txt);
+    EXPECT_NE(lower.getExtensionId(), ExtensionIds::intern(".pdf"));
+    EXPECT_EQ(ItemRepresentation(testFileNoExt).getExtensionId(), ExtensionIds::None);
+    EXPECT_EQ(ItemRepresentation(testDir / "dir.with.dots", ItemType::Directory, ItemAttribute::Type).getExtensionId(),
+              ExtensionIds::None);
+}
+
+TEST_F(ItemRepresentationTest, ExtensionsNoRuleMentionsAreNotInterned) {
+    const ItemRepresentation item(testDir / "scan.unmentioned");
+    EXPECT_EQ(item.getExtensionId(), ExtensionIds::Unknown);
+    EXPECT_EQ(ExtensionIds::find(".UNMENTIONED"), ExtensionIds::Unknown);
+    
+    // once a rule interns it, items already parsed pick the id up as well
+    const std::uint32_t id = ExtensionIds::intern(".Unmentioned");
+    EXPECT_NE(id, ExtensionIds::Unknown);
+    EXPECT_EQ(ExtensionIds::find(".unmentioned"), id);
+    EXPECT_EQ(item.getExtensionId(), id);
+}
@@ -3,6 +3,9 @@
 #include <filesystem>
 #include <fstream>
 #include <sstream>
+#include <thread>
+#include <vector>
+#include <format>
 
 class LoggerTest : public testing::Test {
 protected:
@@ -132,3 +135,91 @@ TEST_F(LoggerTest, TimestampFormat) {
     EXPECT_TRUE(logContent.find("] [INFO]") != std::string::npos);  // Proper format
 }
 
+
+TEST_F(LoggerTest, AsyncMessagesAreWrittenInOrder) {
+    Logger::instance().init(LogLevel::INFO, logFilePath.string());
+    Logger::instance().startAsync();
+    EXPECT_TRUE(Logger::instance().isAsync());
+
+    for (int i = 0; i < 100; ++i) {
+        Logger::instance().info("Async message " + std::to_string(i));
+    }
+    Logger::instance().debug("Async debug - should not appear");
+    Logger::instance().flush();
+
+    const std::string logContent = readLogFile();
+    EXPECT_NE(logContent.find("[INFO] Async message 0\n"), std::string::npos);
+    EXPECT_LT(logContent.find("Async message 42\n"), logContent.find("Async message 43\n"));
+    EXPECT_NE(logContent.find("Async message 99\n"), std::string::npos);
+    EXPECT_EQ(logContent.find("Async debug"), std::string::npos);
+}
+
+TEST_F(LoggerTest, AsyncBlockingLosesNothingFromManyThreads) {
+    Logger::instance().init(LogLevel::INFO, logFilePath.string());
+    AsyncLogOptions options;
+    options.queueCapacity = 4;
+    options.overflow = LogOverflow::Block;
+    Logger::instance().startAsync(options);
+
+    {
+        std::vector<std::jthread> threads;
+        for (int thread = 0; thread < 4; ++thread) {
+            threads.emplace_back([thread] {
+                for (int i = 0; i < 250; ++i) {
+                    Logger::instance().warning(std::format("thread {} message {}", thread, i));
+                }
+            });
+        }
+    }
+    Logger::instance().stopAsync();
+    EXPECT_FALSE(Logger::instance().isAsync());
+
+    const std::string logContent = readLogFile();
+    size_t lines = 0;
+    for (size_t position = logContent.find("[WARNING] thread"); position != std::string::npos;
+         position = logContent.find("[WARNING] thread", position + 1)) {
+        ++lines;
+    }
+    EXPECT_EQ(lines, 1000);
+}
+
+TEST_F(LoggerTest, AsyncDropReportsLostMessages) {
+    Logger::instance().init(LogLevel::INFO, logFilePath.string());
+    AsyncLogOptions options;
+    options.queueCapacity = 2;
+    options.overflow = LogOverflow::Drop;
+    Logger::instance().startAsync(options);
+
+    for (int i = 0; i < 5000; ++i) {
+        Logger::instance().info("Flood " + std::to_string(i));
+    }
+    Logger::instance().stopAsync();
+
+    const size_t dropped = Logger::instance().getDroppedCount();
+    const std::string logContent = readLogFile();
+    if (dropped > 0) {
+        EXPECT_NE(logContent.find("log messages dropped"), std::string::npos);
+    }
+    // whatever was not dropped was written
+    size_t lines = 0;
+    for (size_t position = logContent.find("] Flood "); position != std::string::npos;
+         position = logContent.find("] Flood ", position + 1)) {
+        ++lines;
+    }
+    EXPECT_EQ(lines + dropped, 5000);
+}
+
+TEST_F(LoggerTest, FormattedMessagesRespectTheLevel) {
+    Logger::instance().init(LogLevel::INFO, logFilePath.string());
+    EXPECT_FALSE(Logger::instance().isEnabled(LogLevel::DEBUG));
+    EXPECT_TRUE(Logger::instance().isEnabled(LogLevel::WARNING));
+
+    Logger::instance().info("Moved {} items to '{}'", 3, std::string("archive"));
+    Logger::instance().debug("Skipped {} - should not appear", 7);
+    Logger::instance().error("{:.1f} MiB copied", 1.5);
+
+    const std::string logContent = readLogFile();
+    EXPECT_NE(logContent.find("[INFO] Moved 3 items to 'archive'"), std::string::npos);
+    EXPECT_EQ(logContent.find("Skipped 7"), std::string::npos);
+    EXPECT_NE(logContent.find("[ERROR] 1.5 MiB copied"), std::string::npos);
+}
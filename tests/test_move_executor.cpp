@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <thread>
+#include <stdexcept>
+#include "core/MoveExecutor.h"
+
+TEST(MoveExecutorTest, RunsEveryTask) {
+    std::atomic<int> counter{0};
+    MoveExecutor executor(4, 16);
+    for (int i = 0; i < 1000; ++i) {
+        executor.submit("dir" + std::to_string(i % 7), [&] { ++counter; });
+    }
+    executor.wait();
+    
+    EXPECT_EQ(counter, 1000);
+    const auto stats = executor.getStatistics();
+    EXPECT_EQ(stats.tasksCompleted, 1000);
+    EXPECT_LE(stats.peakQueueDepth, 16);
+    EXPECT_EQ(executor.getQueueDepth(), 0);
+}
+
+TEST(MoveExecutorTest, StrandKeepsSubmissionOrder) {
+    std::mutex mutex;
+    std::map<std::string, std::vector<int>> order;
+    
+    MoveExecutor executor(4);
+    for (int i = 0; i < 500; ++i) {
+        const std::string strand = "dir" + std::to_string(i % 3);
+        executor.submit(strand, [&, strand, i] {
+            std::lock_guard lock(mutex);
+            order[strand].push_back(i);
+        });
+    }
+    executor.wait();
+    
+    ASSERT_EQ(order.size(), 3);
+    for (const auto& [strand, sequence] : order) {
+        EXPECT_TRUE(std::ranges::is_sorted(sequence)) << strand;
+    }
+}
+
+TEST(MoveExecutorTest, StrandNeverRunsConcurrently) {
+    std::atomic<int> active{0};
+    std::atomic<bool> overlapped{false};
+    
+    MoveExecutor executor(8);
+    for (int i = 0; i < 200; ++i) {
+        executor.submit("same", [&] {
+            if (++active > 1) {
+                overlapped = true;
+            }
+            std::this_thread::yield();
+            --active;
+        });
+    }
+    executor.wait();
+    
+    EXPECT_FALSE(overlapped);
+}
+
+TEST(MoveExecutorTest, WaitForStrandOnlyWaitsForThatStrand) {
+    std::atomic<int> finished{0};
+    std::atomic<bool> release{false};
+    
+    MoveExecutor executor(4);
+    executor.submit("blocked", [&] {
+        while (!release) {
+            std::this_thread::yield();
+        }
+    });
+    for (int i = 0; i < 20; ++i) {
+        executor.submit("busy", [&] {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+            ++finished;
+        });
+    }
+    executor.waitForStrand("busy");
+    EXPECT_EQ(finished, 20);
+    executor.waitForStrand("idle");
+    
+    release = true;
+    executor.wait();
+}
+
+TEST(MoveExecutorTest, FailingTaskDoesNotStopWorkers) {
+    std::atomic<int> counter{0};
+    MoveExecutor executor(2);
+    executor.submit("a", [] { throw std::runtime_error("boom"); });
+    executor.submit("a", [&] { ++counter; });
+    executor.wait();
+    EXPECT_EQ(counter, 1);
+}
+
+TEST(MoveExecutorTest, DestructorFinishesPendingTasks) {
+    std::atomic<int> counter{0};
+    {
+        MoveExecutor executor(1);
+        for (int i = 0; i < 100; ++i) {
+            executor.submit("a", [&] { ++counter; });
+        }
+    }
+    EXPECT_EQ(counter, 100);
+}
@@ -0,0 +1,406 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "core/MoveJournal.h"
+#include "core/DirectoryOrganizer.h"
+#include "core/Logger.h"
+#include "rules/ConfigurableRule.h"
+#include "conditions/ExtensionCondition.h"
+
+class MoveJournalTest : public testing::Test {
+protected:
+    void SetUp() override {
+        testId = std::to_string(std::chrono::high_resolution_clock::now().time_since_epoch().count());
+        testDir = std::filesystem::temp_directory_path() / ("move_journal_test_" + testId);
+        journalDir = testDir / "journals";
+        std::filesystem::create_directories(journalDir);
+        std::filesystem::create_directories(testDir / "source");
+        std::filesystem::create_directories(testDir / "target");
+        Logger::instance().init(LogLevel::ERROR);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(testDir);
+        Logger::instance().reset();
+    }
+
+    void writeFile(const std::filesystem::path& path, const std::string& content = "content") {
+        std::filesystem::create_directories(path.parent_path());
+        std::ofstream(path) << content;
+    }
+
+    // Remove the closing record the journal's destructor wrote, as if the run had crashed:
+    // length, checksum, type and id
+    static void cutClosingRecord(const std::filesystem::path& file) {
+        std::filesystem::resize_file(file, std::filesystem::file_size(file) - 21);
+    }
+
+    static FileMetadata identityOf(const std::filesystem::path& path) {
+        return readFileMetadata(path).value_or(FileMetadata{});
+    }
+
+    // Record the item at copy as the entry's copy, as a move to another filesystem does
+    // right after creating it
+    static bool recordCopy(MoveJournal& journal, const std::uint64_t id, const std::filesystem::path& copy) {
+        const FileMetadata identity = identityOf(copy);
+        return journal.recordCopy(id, copy, identity.device, identity.inode);
+    }
+
+    std::vector<std::unique_ptr<ISortingRule>> textRules() {
+        std::vector<std::unique_ptr<ISortingRule>> rules;
+        auto rule = std::make_unique<ConfigurableRule>("text", 10);
+        rule->addCondition(std::make_unique<ExtensionCondition>(".txt"));
+        rules.push_back(std::move(rule));
+        return rules;
+    }
+
+    std::string testId;
+    std::filesystem::path testDir;
+    std::filesystem::path journalDir;
+};
+
+TEST_F(MoveJournalTest, RecordsAreReadBack) {
+    const std::filesystem::path file = MoveJournal::journalPath(journalDir, "run");
+    {
+        MoveJournal journal(file);
+        ASSERT_TRUE(journal.create());
+        const auto first = journal.plan("/src/a.txt", "/dst/a.txt", FileMetadata{});
+        const auto second = journal.plan("/src/b.txt", "/dst/b.txt", FileMetadata{});
+        journal.complete(first, "/dst/a_001.txt");
+        journal.fail(second);
+    }
+
+    const auto contents = MoveJournal::read(file);
+    ASSERT_TRUE(contents);
+    EXPECT_TRUE(contents->closed);
+    ASSERT_EQ(contents->entries.size(), 2);
+    EXPECT_EQ(contents->entries[0].source, "/src/a.txt");
+    EXPECT_EQ(contents->entries[0].finalTarget, "/dst/a_001.txt");
+    EXPECT_EQ(contents->entries[0].state, MoveJournal::Entry::State::Completed);
+    EXPECT_EQ(contents->entries[1].state, MoveJournal::Entry::State::Failed);
+}
+
+TEST_F(MoveJournalTest, CreateRefusesExistingJournal) {
+    const std::filesystem::path file = MoveJournal::journalPath(journalDir, "run");
+    MoveJournal first(file);
+    ASSERT_TRUE(first.create());
+    MoveJournal second(file);
+    EXPECT_FALSE(second.create());
+}
+
+TEST_F(MoveJournalTest, PlannedMovesShareOneCommit) {
+    MoveJournal journal(MoveJournal::journalPath(journalDir, "run"));
+    ASSERT_TRUE(journal.create());
+    std::vector<std::uint64_t> ids;
+    for (int i = 0; i < 50; ++i) {
+        ids.push_back(journal.plan("/src/" + std::to_string(i), "/dst/" + std::to_string(i), FileMetadata{}));
+    }
+    const size_t commitsBefore = journal.getStatistics().commits;
+
+    std::vector<std::jthread> movers;
+    for (int t = 0; t < 4; ++t) {
+        movers.emplace_back([&, t] {
+            for (size_t i = t; i < ids.size(); i += 4) {
+                EXPECT_TRUE(journal.commitThrough(ids[i]));
+            }
+        });
+    }
+    movers.clear();
+
+    // whoever commits first writes every planned record
+    EXPECT_EQ(journal.getStatistics().commits - commitsBefore, 1);
+}
+
+TEST_F(MoveJournalTest, TornRecordIsIgnored) {
+    const std::filesystem::path file = MoveJournal::journalPath(journalDir, "run");
+    {
+        MoveJournal journal(file);
+        ASSERT_TRUE(journal.create());
+        journal.plan("/src/a.txt", "/dst/a.txt", FileMetadata{});
+    }
+    cutClosingRecord(file);
+    const std::string garbage("\x30\x00\x00\x00garbage", 11);
+    std::ofstream(file, std::ios::binary | std::ios::app) << garbage;
+
+    const auto contents = MoveJournal::read(file);
+    ASSERT_TRUE(contents);
+    ASSERT_EQ(contents->entries.size(), 1);
+    EXPECT_FALSE(contents->closed);
+    EXPECT_LT(contents->validBytes, std::filesystem::file_size(file));
+}
+
+TEST_F(MoveJournalTest, RecoverySettlesInterruptedMoves) {
+    const std::filesystem::path file = MoveJournal::journalPath(journalDir, "crashed");
+    writeFile(testDir / "source/stayed.txt");
+    writeFile(testDir / "source/moved.txt");
+    writeFile(testDir / "target/moved.txt", "someone else's");
+    {
+        MoveJournal journal(file);
+        ASSERT_TRUE(journal.create());
+        journal.plan(testDir / "source/stayed.txt", testDir / "target/stayed.txt", identityOf(testDir / "source/stayed.txt"));
+        const auto moved = journal.plan(testDir / "source/moved.txt", testDir / "target/moved.txt",
+                                        identityOf(testDir / "source/moved.txt"));
+        ASSERT_TRUE(journal.commitThrough(moved));
+        // the rename happens, with a collision suffix, and the process dies before recording it
+        std::filesystem::rename(testDir / "source/moved.txt", testDir / "target/moved_001.txt");
+    }
+    cutClosingRecord(file);
+    ASSERT_FALSE(MoveJournal::read(file)->closed);
+
+    EXPECT_EQ(MoveJournal::recoverAll(journalDir), 1);
+
+    const auto contents = MoveJournal::read(file);
+    ASSERT_TRUE(contents);
+    EXPECT_TRUE(contents->closed);
+    ASSERT_EQ(contents->entries.size(), 2);
+    EXPECT_EQ(contents->entries[0].state, MoveJournal::Entry::State::Failed);
+    EXPECT_EQ(contents->entries[1].state, MoveJournal::Entry::State::Completed);
+    EXPECT_EQ(contents->entries[1].finalTarget, testDir / "target/moved_001.txt");
+    EXPECT_EQ(MoveJournal::recoverAll(journalDir), 0);
+}
+
+TEST_F(MoveJournalTest, RecoveryLeavesJournalsOfLiveRunsAlone) {
+    const std::filesystem::path file = MoveJournal::journalPath(journalDir, "running");
+    writeFile(testDir / "source/moving.txt");
+    {
+        MoveJournal journal(file);
+        ASSERT_TRUE(journal.create());
+        const auto id = journal.plan(testDir / "source/moving.txt", testDir / "target/moving.txt",
+                                     identityOf(testDir / "source/moving.txt"));
+        ASSERT_TRUE(journal.commitThrough(id));
+        const auto size = std::filesystem::file_size(file);
+
+        // the run is mid-move: neither a recovery nor an undo may settle it under its feet
+        EXPECT_EQ(MoveJournal::recoverAll(journalDir), 0);
+        EXPECT_FALSE(MoveJournal::undo(journalDir, "running", 1));
+        EXPECT_EQ(std::filesystem::file_size(file), size);
+
+        std::filesystem::rename(testDir / "source/moving.txt", testDir / "target/moving.txt");
+        journal.complete(id, testDir / "target/moving.txt");
+    }
+    // the run dies before closing its journal: its lock goes with it
+    cutClosingRecord(file);
+    EXPECT_EQ(MoveJournal::recoverAll(journalDir), 1);
+    EXPECT_TRUE(MoveJournal::read(file)->closed);
+}
+
+TEST_F(MoveJournalTest, UndoMovesRunBack) {
+    writeFile(testDir / "source/a.txt", "a");
+    writeFile(testDir / "source/nested/b.txt", "b");
+    writeFile(testDir / "target/text/a.txt", "already there");
+
+    OrganizerOptions options;
+    options.journalDirectory = journalDir;
+    std::string runId;
+    {
+        DirectoryOrganizer organizer(testDir / "source", testDir / "target", textRules(), false, options);
+        organizer.scanAndOrganize();
+        EXPECT_EQ(organizer.getStatistics().filesMovedOrWouldMove, 2);
+        runId = organizer.getRunId();
+    }
+    ASSERT_FALSE(runId.empty());
+    ASSERT_TRUE(std::filesystem::exists(testDir / "target/text/a_001.txt"));
+    ASSERT_FALSE(std::filesystem::exists(testDir / "source/a.txt"));
+
+    const auto result = MoveJournal::undo(journalDir, runId, 2);
+    ASSERT_TRUE(result);
+    EXPECT_EQ(result->restored, 2);
+    EXPECT_EQ(result->failed, 0);
+    std::ifstream restored(testDir / "source/a.txt");
+    EXPECT_EQ(std::string(std::istreambuf_iterator<char>(restored), {}), "a");
+    EXPECT_TRUE(std::filesystem::exists(testDir / "source/nested/b.txt"));
+    EXPECT_TRUE(std::filesystem::exists(testDir / "target/text/a.txt"));
+
+    // a second undo finds nothing left to do
+    const auto again = MoveJournal::undo(journalDir, runId, 2);
+    ASSERT_TRUE(again);
+    EXPECT_EQ(again->restored, 0);
+    EXPECT_EQ(again->skipped, 2);
+}
+
+TEST_F(MoveJournalTest, UndoNeverReplacesNewItems) {
+    writeFile(testDir / "source/a.txt", "old");
+    OrganizerOptions options;
+    options.journalDirectory = journalDir;
+    std::string runId;
+    {
+        DirectoryOrganizer organizer(testDir / "source", testDir / "target", textRules(), false, options);
+        organizer.scanAndOrganize();
+        runId = organizer.getRunId();
+    }
+    writeFile(testDir / "source/a.txt", "new");
+
+    const auto result = MoveJournal::undo(journalDir, runId, 1);
+    ASSERT_TRUE(result);
+    EXPECT_EQ(result->failed, 1);
+    EXPECT_TRUE(std::filesystem::exists(testDir / "target/text/a.txt"));
+    std::ifstream kept(testDir / "source/a.txt");
+    EXPECT_EQ(std::string(std::istreambuf_iterator<char>(kept), {}), "new");
+}
+
+TEST_F(MoveJournalTest, RecoveryRemovesPartialCrossDeviceCopies) {
+    const std::filesystem::path file = MoveJournal::journalPath(journalDir, "crashed");
+    writeFile(testDir / "source/big.txt", "0123456789");
+    writeFile(testDir / "target/big.txt", "someone else's");
+    writeFile(testDir / "source/empty.txt", "0123456789");
+    {
+        MoveJournal journal(file);
+        ASSERT_TRUE(journal.create());
+        // the copy took a collision suffix and was cut short after being sized
+        const auto big = journal.plan(testDir / "source/big.txt", testDir / "target/big.txt",
+                                      identityOf(testDir / "source/big.txt"));
+        ASSERT_TRUE(journal.commitThrough(big));
+        writeFile(testDir / "target/big_001.txt", "0123\0\0\0\0\0\0");
+        std::filesystem::resize_file(testDir / "target/big_001.txt", 10);
+        ASSERT_TRUE(recordCopy(journal, big, testDir / "target/big_001.txt"));
+        // the copy was cut short right after the target was created
+        const auto empty = journal.plan(testDir / "source/empty.txt", testDir / "target/empty.txt",
+                                        identityOf(testDir / "source/empty.txt"));
+        ASSERT_TRUE(journal.commitThrough(empty));
+        writeFile(testDir / "target/empty.txt", "");
+        ASSERT_TRUE(recordCopy(journal, empty, testDir / "target/empty.txt"));
+    }
+    cutClosingRecord(file);
+
+    EXPECT_EQ(MoveJournal::recoverAll(journalDir), 1);
+
+    const auto contents = MoveJournal::read(file);
+    ASSERT_TRUE(contents);
+    ASSERT_EQ(contents->entries.size(), 2);
+    EXPECT_EQ(contents->entries[0].state, MoveJournal::Entry::State::RolledBack);
+    EXPECT_EQ(contents->entries[1].state, MoveJournal::Entry::State::RolledBack);
+    EXPECT_FALSE(std::filesystem::exists(testDir / "target/big_001.txt"));
+    EXPECT_FALSE(std::filesystem::exists(testDir / "target/empty.txt"));
+    EXPECT_TRUE(std::filesystem::exists(testDir / "source/big.txt"));
+    EXPECT_TRUE(std::filesystem::exists(testDir / "source/empty.txt"));
+    // the planned name held someone else's item, which the journal never recorded
+    std::ifstream kept(testDir / "target/big.txt");
+    EXPECT_EQ(std::string(std::istreambuf_iterator<char>(kept), {}), "someone else's");
+}
+
+TEST_F(MoveJournalTest, RecoverySettlesInterruptedDirectoryCopies) {
+    const std::filesystem::path file = MoveJournal::journalPath(journalDir, "crashed");
+    for (const std::string album : {"copied", "partial", "finished"}) {
+        writeFile(testDir / "source" / album / "a.txt", "a");
+        writeFile(testDir / "source" / album / "b.txt", "b");
+    }
+    {
+        MoveJournal journal(file);
+        ASSERT_TRUE(journal.create());
+        // copied completely, times last, then the crash came while the source was removed
+        const auto copiedIdentity = identityOf(testDir / "source/copied");
+        const auto copied = journal.plan(testDir / "source/copied", testDir / "target/copied", copiedIdentity);
+        ASSERT_TRUE(journal.commitThrough(copied));
+        std::filesystem::create_directory(testDir / "target/copied");
+        ASSERT_TRUE(recordCopy(journal, copied, testDir / "target/copied"));
+        writeFile(testDir / "target/copied/a.txt", "a");
+        writeFile(testDir / "target/copied/b.txt", "b");
+        std::filesystem::last_write_time(testDir / "target/copied", copiedIdentity.lastModified);
+        std::filesystem::remove(testDir / "source/copied/a.txt");
+        // cut short while copying the children
+        const auto partial = journal.plan(testDir / "source/partial", testDir / "target/partial",
+                                          identityOf(testDir / "source/partial"));
+        ASSERT_TRUE(journal.commitThrough(partial));
+        std::filesystem::create_directory(testDir / "target/partial");
+        ASSERT_TRUE(recordCopy(journal, partial, testDir / "target/partial"));
+        writeFile(testDir / "target/partial/a.txt", "a");
+        // the source was gone before the outcome was recorded
+        const auto finished = journal.plan(testDir / "source/finished", testDir / "target/finished",
+                                           identityOf(testDir / "source/finished"));
+        ASSERT_TRUE(journal.commitThrough(finished));
+        std::filesystem::create_directory(testDir / "target/finished");
+        ASSERT_TRUE(recordCopy(journal, finished, testDir / "target/finished"));
+        std::filesystem::remove_all(testDir / "source/finished");
+    }
+    cutClosingRecord(file);
+
+    EXPECT_EQ(MoveJournal::recoverAll(journalDir), 1);
+
+    const auto contents = MoveJournal::read(file);
+    ASSERT_TRUE(contents);
+    ASSERT_EQ(contents->entries.size(), 3);
+    EXPECT_EQ(contents->entries[0].state, MoveJournal::Entry::State::Completed);
+    EXPECT_EQ(contents->entries[0].finalTarget, testDir / "target/copied");
+    EXPECT_FALSE(std::filesystem::exists(testDir / "source/copied"));
+    EXPECT_TRUE(std::filesystem::exists(testDir / "target/copied/a.txt"));
+    EXPECT_EQ(contents->entries[1].state, MoveJournal::Entry::State::RolledBack);
+    EXPECT_FALSE(std::filesystem::exists(testDir / "target/partial"));
+    EXPECT_TRUE(std::filesystem::exists(testDir / "source/partial/b.txt"));
+    EXPECT_EQ(contents->entries[2].state, MoveJournal::Entry::State::Completed);
+    EXPECT_EQ(contents->entries[2].finalTarget, testDir / "target/finished");
+}
+
+TEST_F(MoveJournalTest, RecoveryNeverRemovesItemsItCantProveAreCopies) {
+    const std::filesystem::path file = MoveJournal::journalPath(journalDir, "crashed");
+    writeFile(testDir / "source/a/photos/1.jpg", "1");
+    writeFile(testDir / "source/b/photos/2.jpg", "2");
+    writeFile(testDir / "source/c.txt", "c");
+    {
+        MoveJournal journal(file);
+        ASSERT_TRUE(journal.create());
+        // two same-named directories for one target: the first was copied over and completed,
+        // the second was still waiting at the crash
+        const auto first = journal.plan(testDir / "source/a/photos", testDir / "target/photos",
+                                        identityOf(testDir / "source/a/photos"));
+        const auto second = journal.plan(testDir / "source/b/photos", testDir / "target/photos",
+                                         identityOf(testDir / "source/b/photos"));
+        ASSERT_TRUE(journal.commitThrough(second));
+        std::filesystem::create_directory(testDir / "target/photos");
+        ASSERT_TRUE(recordCopy(journal, first, testDir / "target/photos"));
+        std::filesystem::rename(testDir / "source/a/photos/1.jpg", testDir / "target/photos/1.jpg");
+        std::filesystem::remove(testDir / "source/a/photos");
+        journal.complete(first, testDir / "target/photos");
+        // a copy was recorded, but the item now at its name is another one
+        const auto replaced = journal.plan(testDir / "source/c.txt", testDir / "target/c.txt",
+                                           identityOf(testDir / "source/c.txt"));
+        ASSERT_TRUE(journal.commitThrough(replaced));
+        writeFile(testDir / "target/c.txt", "");
+        ASSERT_TRUE(recordCopy(journal, replaced, testDir / "target/c.txt"));
+        std::filesystem::rename(testDir / "target/c.txt", testDir / "target/moved-away.txt");
+        writeFile(testDir / "target/c.txt", "someone else's");
+        ASSERT_TRUE(journal.flush());
+    }
+    cutClosingRecord(file);
+
+    EXPECT_EQ(MoveJournal::recoverAll(journalDir), 1);
+
+    const auto contents = MoveJournal::read(file);
+    ASSERT_TRUE(contents);
+    ASSERT_EQ(contents->entries.size(), 3);
+    EXPECT_EQ(contents->entries[0].state, MoveJournal::Entry::State::Completed);
+    EXPECT_EQ(contents->entries[1].state, MoveJournal::Entry::State::Failed);
+    EXPECT_EQ(contents->entries[2].state, MoveJournal::Entry::State::Failed);
+    EXPECT_TRUE(std::filesystem::exists(testDir / "target/photos/1.jpg"));
+    EXPECT_TRUE(std::filesystem::exists(testDir / "source/b/photos/2.jpg"));
+    EXPECT_TRUE(std::filesystem::exists(testDir / "source/c.txt"));
+    std::ifstream kept(testDir / "target/c.txt");
+    EXPECT_EQ(std::string(std::istreambuf_iterator<char>(kept), {}), "someone else's");
+}
+
+TEST_F(MoveJournalTest, UndoRestoresEnclosingDirectoriesFirst) {
+    // a file moved out of a directory, then the directory itself, as watch mode can do
+    writeFile(testDir / "source/x/f.txt", "f");
+    writeFile(testDir / "source/x/g.txt", "g");
+    const std::filesystem::path file = MoveJournal::journalPath(journalDir, "run");
+    {
+        MoveJournal journal(file);
+        ASSERT_TRUE(journal.create());
+        const auto fileMove = journal.plan(testDir / "source/x/f.txt", testDir / "target/f.txt", FileMetadata{});
+        std::filesystem::rename(testDir / "source/x/f.txt", testDir / "target/f.txt");
+        journal.complete(fileMove, testDir / "target/f.txt");
+        const auto directoryMove = journal.plan(testDir / "source/x", testDir / "target/x", FileMetadata{});
+        std::filesystem::rename(testDir / "source/x", testDir / "target/x");
+        journal.complete(directoryMove, testDir / "target/x");
+    }
+
+    const auto result = MoveJournal::undo(journalDir, "run", 4);
+    ASSERT_TRUE(result);
+    EXPECT_EQ(result->restored, 2);
+    EXPECT_EQ(result->failed, 0);
+    EXPECT_TRUE(std::filesystem::exists(testDir / "source/x/f.txt"));
+    EXPECT_TRUE(std::filesystem::exists(testDir / "source/x/g.txt"));
+    EXPECT_FALSE(std::filesystem::exists(testDir / "target/x"));
+}
@@ -0,0 +1,205 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "core/MovePlan.h"
+#include "core/DirectoryOrganizer.h"
+#include "core/Logger.h"
+#include "rules/ConfigurableRule.h"
+#include "conditions/ExtensionCondition.h"
+
+class MovePlanTest : public testing::Test {
+protected:
+    void SetUp() override {
+        testId = std::to_string(std::chrono::high_resolution_clock::now().time_since_epoch().count());
+        testDir = std::filesystem::temp_directory_path() / ("move_plan_test_" + testId);
+        sourceDir = testDir / "source";
+        targetDir = testDir / "target";
+        planFile = testDir / "moves.plan";
+        std::filesystem::create_directories(sourceDir);
+        std::filesystem::create_directories(targetDir);
+        Logger::instance().init(LogLevel::ERROR);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(testDir);
+        Logger::instance().reset();
+    }
+
+    void writeFile(const std::filesystem::path& path, const std::string& content = "content") {
+        std::filesystem::create_directories(path.parent_path());
+        std::ofstream(path) << content;
+    }
+
+    std::vector<std::unique_ptr<ISortingRule>> textRules(const std::string& target = "text") {
+        std::vector<std::unique_ptr<ISortingRule>> rules;
+        auto rule = std::make_unique<ConfigurableRule>(target, 10);
+        rule->addCondition(std::make_unique<ExtensionCondition>(".txt"));
+        rules.push_back(std::move(rule));
+        return rules;
+    }
+
+    std::string testId;
+    std::filesystem::path testDir;
+    std::filesystem::path sourceDir;
+    std::filesystem::path targetDir;
+    std::filesystem::path planFile;
+};
+
+TEST_F(MovePlanTest, EntriesAreReadBack) {
+    FileMetadata metadata;
+    metadata.sizeInBytes = 42;
+    {
+        MovePlan::Writer writer(planFile, 7, "/src", "/dst");
+        ASSERT_TRUE(writer.open());
+        writer.add("/src/a/b.txt", "/dst/text/b.txt", ItemType::File, 3, metadata);
+        writer.add("/src/photos", "/dst/albums/photos", ItemType::Directory, 1, FileMetadata{});
+        ASSERT_TRUE(writer.finish());
+    }
+    EXPECT_FALSE(std::filesystem::exists(planFile.string() + ".tmp"));
+
+    MovePlan plan(planFile);
+    ASSERT_TRUE(plan.open());
+    EXPECT_EQ(plan.getFingerprint(), 7);
+    EXPECT_EQ(plan.getSourceRoot(), "/src");
+    EXPECT_EQ(plan.getTargetRoot(), "/dst");
+    ASSERT_EQ(plan.size(), 2);
+
+    std::vector<std::pair<std::string, std::string>> moves;
+    plan.forEachEntry([&](const MovePlan::Entry& entry) {
+        moves.emplace_back(entry.source, entry.target);
+        if (entry.type == ItemType::File) {
+            EXPECT_EQ(entry.ruleId, 3);
+            EXPECT_EQ(entry.size, 42);
+        }
+    });
+    ASSERT_EQ(moves.size(), 2);
+    EXPECT_EQ(moves[0], std::make_pair(std::string("a/b.txt"), std::string("text/b.txt")));
+    EXPECT_EQ(moves[1], std::make_pair(std::string("photos"), std::string("albums/photos")));
+}
+
+TEST_F(MovePlanTest, UnfinishedPlanIsDiscarded) {
+    {
+        MovePlan::Writer writer(planFile, 7, "/src", "/dst");
+        ASSERT_TRUE(writer.open());
+        writer.add("/src/a.txt", "/dst/a.txt", ItemType::File, 0, FileMetadata{});
+    }
+    EXPECT_FALSE(std::filesystem::exists(planFile));
+    EXPECT_FALSE(std::filesystem::exists(planFile.string() + ".tmp"));
+}
+
+TEST_F(MovePlanTest, CorruptPlanIsRejected) {
+    {
+        MovePlan::Writer writer(planFile, 7, "/src", "/dst");
+        ASSERT_TRUE(writer.open());
+        writer.add("/src/a.txt", "/dst/a.txt", ItemType::File, 0, FileMetadata{});
+        ASSERT_TRUE(writer.finish());
+    }
+    {
+        std::fstream file(planFile, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(-1, std::ios::end);
+        file.put('x');
+    }
+    MovePlan plan(planFile);
+    EXPECT_FALSE(plan.open());
+
+    std::filesystem::resize_file(planFile, 10);
+    MovePlan truncated(planFile);
+    EXPECT_FALSE(truncated.open());
+}
+
+TEST_F(MovePlanTest, PlanIsExecutedWithoutScanning) {
+    writeFile(sourceDir / "a.txt");
+    writeFile(sourceDir / "nested/b.txt");
+    writeFile(sourceDir / "c.pdf");
+
+    DirectoryOrganizer planner(sourceDir, targetDir, textRules());
+    planner.writePlan(planFile);
+    EXPECT_EQ(planner.getStatistics().errors, 0);
+    EXPECT_EQ(planner.getStatistics().filesMovedOrWouldMove, 2);
+    // planning moves nothing
+    EXPECT_TRUE(std::filesystem::exists(sourceDir / "a.txt"));
+    EXPECT_FALSE(std::filesystem::exists(targetDir / "text"));
+
+    // appears after planning, so it stays put
+    writeFile(sourceDir / "late.txt");
+
+    DirectoryOrganizer executor(sourceDir, targetDir, textRules());
+    executor.executePlan(planFile);
+    EXPECT_EQ(executor.getStatistics().errors, 0);
+    EXPECT_EQ(executor.getStatistics().filesMovedOrWouldMove, 2);
+    EXPECT_TRUE(std::filesystem::exists(targetDir / "text/a.txt"));
+    EXPECT_TRUE(std::filesystem::exists(targetDir / "text/b.txt"));
+    EXPECT_TRUE(std::filesystem::exists(sourceDir / "c.pdf"));
+    EXPECT_TRUE(std::filesystem::exists(sourceDir / "late.txt"));
+}
+
+TEST_F(MovePlanTest, ChangedItemsAreNotMoved) {
+    writeFile(sourceDir / "kept.txt");
+    writeFile(sourceDir / "grown.txt");
+    writeFile(sourceDir / "gone.txt");
+
+    DirectoryOrganizer organizer(sourceDir, targetDir, textRules());
+    organizer.writePlan(planFile);
+
+    writeFile(sourceDir / "grown.txt", "content that is longer now");
+    std::filesystem::remove(sourceDir / "gone.txt");
+
+    organizer.executePlan(planFile);
+    EXPECT_EQ(organizer.getStatistics().filesMovedOrWouldMove, 1);
+    EXPECT_EQ(organizer.getStatistics().itemsChangedSincePlan, 2);
+    EXPECT_TRUE(std::filesystem::exists(targetDir / "text/kept.txt"));
+    EXPECT_TRUE(std::filesystem::exists(sourceDir / "grown.txt"));
+}
+
+TEST_F(MovePlanTest, PlanForOtherRulesIsRefused) {
+    writeFile(sourceDir / "a.txt");
+    DirectoryOrganizer planner(sourceDir, targetDir, textRules());
+    planner.writePlan(planFile);
+
+    DirectoryOrganizer executor(sourceDir, targetDir, textRules("notes"));
+    executor.executePlan(planFile);
+    EXPECT_EQ(executor.getStatistics().errors, 1);
+    EXPECT_TRUE(std::filesystem::exists(sourceDir / "a.txt"));
+}
+
+TEST_F(MovePlanTest, PathsLeavingTheRootsAreRejected) {
+    for (const auto& [source, target] : std::vector<std::pair<std::filesystem::path, std::filesystem::path>>{
+             {"/src/../etc/passwd", "/dst/a.txt"}, {"/src/a.txt", "/elsewhere/a.txt"}, {"/src", "/dst/a.txt"}}) {
+        std::filesystem::remove(planFile);
+        {
+            MovePlan::Writer writer(planFile, 7, "/src", "/dst");
+            ASSERT_TRUE(writer.open());
+            writer.add("/src/ok.txt", "/dst/ok.txt", ItemType::File, 0, FileMetadata{});
+            writer.add(source, target, ItemType::File, 0, FileMetadata{});
+            ASSERT_TRUE(writer.finish());
+        }
+        MovePlan plan(planFile);
+        EXPECT_FALSE(plan.open()) << source << " -> " << target;
+    }
+}
+
+TEST_F(MovePlanTest, UnknownRuleIdIsRejected) {
+    writeFile(sourceDir / "a.txt");
+    DirectoryOrganizer planner(sourceDir, targetDir, textRules());
+    planner.writePlan(planFile);
+    MovePlan made(planFile);
+    ASSERT_TRUE(made.open());
+    EXPECT_EQ(made.getRuleCount(), 1);
+    const std::uint64_t fingerprint = made.getFingerprint();
+
+    // the plan of the same rule set, but naming a rule it doesn't have
+    const std::filesystem::path forged = testDir / "forged.plan";
+    {
+        MovePlan::Writer writer(forged, fingerprint, sourceDir, targetDir);
+        ASSERT_TRUE(writer.open());
+        writer.add(sourceDir / "a.txt", targetDir / "text/a.txt", ItemType::File, 3, *readFileMetadata(sourceDir / "a.txt"));
+        ASSERT_TRUE(writer.finish());
+    }
+    DirectoryOrganizer executor(sourceDir, targetDir, textRules());
+    executor.executePlan(forged);
+    EXPECT_EQ(executor.getStatistics().errors, 1);
+    EXPECT_TRUE(std::filesystem::exists(sourceDir / "a.txt"));
+}
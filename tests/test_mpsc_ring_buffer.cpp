@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+#include <string>
+#include "core/MpscRingBuffer.h"
+
+TEST(MpscRingBufferTest, FifoOrder) {
+    MpscRingBuffer<int> ring(4);
+    EXPECT_TRUE(ring.tryPush(1));
+    EXPECT_TRUE(ring.tryPush(2));
+    EXPECT_TRUE(ring.tryPush(3));
+    
+    EXPECT_EQ(ring.tryPop(), 1);
+    EXPECT_EQ(ring.tryPop(), 2);
+    EXPECT_EQ(ring.tryPop(), 3);
+    EXPECT_EQ(ring.tryPop(), std::nullopt);
+}
+
+TEST(MpscRingBufferTest, FullRingRejectsWithoutTakingTheItem) {
+    MpscRingBuffer<std::string> ring(3);
+    EXPECT_EQ(ring.getCapacity(), 4);
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(ring.tryPush(std::to_string(i)));
+    }
+    
+    std::string rejected = "kept";
+    EXPECT_FALSE(ring.tryPush(std::move(rejected)));
+    EXPECT_EQ(rejected, "kept");
+    
+    // a popped slot is free again
+    EXPECT_EQ(ring.tryPop(), "0");
+    EXPECT_TRUE(ring.tryPush(std::move(rejected)));
+}
+
+TEST(MpscRingBufferTest, ConcurrentProducersLoseNothing) {
+    constexpr int producerCount = 4;
+    constexpr int itemsPerProducer = 20000;
+    MpscRingBuffer<int> ring(64);
+    
+    std::vector<std::jthread> producers;
+    for (int producer = 0; producer < producerCount; ++producer) {
+        producers.emplace_back([&, producer] {
+            for (int i = 0; i < itemsPerProducer; ++i) {
+                int item = producer * itemsPerProducer + i;
+                while (!ring.tryPush(std::move(item))) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    
+    // every item arrives once, and each producer's items arrive in the order pushed
+    std::vector<int> lastSeen(producerCount, -1);
+    int received = 0;
+    while (received < producerCount * itemsPerProducer) {
+        const auto item = ring.tryPop();
+        if (!item) {
+            std::this_thread::yield();
+            continue;
+        }
+        const int producer = *item / itemsPerProducer;
+        EXPECT_GT(*item % itemsPerProducer, lastSeen[producer]);
+        lastSeen[producer] = *item % itemsPerProducer;
+        ++received;
+    }
+    EXPECT_EQ(ring.tryPop(), std::nullopt);
+}
@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+#include "conditions/NameCondition.h"
+#include "conditions/GlobAutomaton.h"
+#include "models/ItemRepresentation.h"
+#include <filesystem>
+#include <string>
+#include <vector>
+
+class NameConditionTest : public testing::Test {
+protected:
+    bool matches(const std::string& pattern, const std::string& name, const bool ignoreCase = false) const {
+        return NameCondition(pattern, ignoreCase).evaluate(ItemRepresentation(std::filesystem::path("dir") / name), context);
+    }
+
+    EvaluationContext context;
+};
+
+TEST_F(NameConditionTest, StarsAndQuestionMarks) {
+    EXPECT_TRUE(matches("*.pdf", "report.pdf"));
+    EXPECT_TRUE(matches("*.pdf", ".pdf"));
+    EXPECT_FALSE(matches("*.pdf", "report.pdf.bak"));
+    EXPECT_TRUE(matches("IMG_????.jpg", "IMG_0042.jpg"));
+    EXPECT_FALSE(matches("IMG_????.jpg", "IMG_042.jpg"));
+    EXPECT_TRUE(matches("*a*b*", "xaybz"));
+    EXPECT_FALSE(matches("*a*b*", "xbya"));
+    EXPECT_TRUE(matches("**", ""));
+    EXPECT_TRUE(matches("", ""));
+    EXPECT_FALSE(matches("", "a"));
+    // the whole name has to match, not just a part of it
+    EXPECT_FALSE(matches("report", "report.pdf"));
+}
+
+TEST_F(NameConditionTest, BracketExpressions) {
+    EXPECT_TRUE(matches("[abc].txt", "b.txt"));
+    EXPECT_FALSE(matches("[abc].txt", "d.txt"));
+    EXPECT_TRUE(matches("v[0-9]*", "v2.1"));
+    EXPECT_FALSE(matches("v[0-9]*", "vx"));
+    EXPECT_TRUE(matches("[!.]*", "visible"));
+    EXPECT_FALSE(matches("[!.]*", ".hidden"));
+    EXPECT_FALSE(matches("[^.]*", ".hidden"));
+    EXPECT_TRUE(matches("[]]", "]"));
+    EXPECT_TRUE(matches("[a-]", "-"));
+    // an unterminated bracket and escaped characters are literal
+    EXPECT_TRUE(matches("[abc", "[abc"));
+    EXPECT_TRUE(matches("\\*\\?", "*?"));
+    EXPECT_FALSE(matches("\\*", "x"));
+}
+
+TEST_F(NameConditionTest, IgnoringCase) {
+    EXPECT_FALSE(matches("*.JPG", "photo.jpg"));
+    EXPECT_TRUE(matches("*.JPG", "photo.jpg", true));
+    EXPECT_TRUE(matches("[a-c]*", "Banana", true));
+    // negation excludes both cases
+    EXPECT_FALSE(matches("[!a]*", "Apple", true));
+    EXPECT_TRUE(matches("[!a]*", "Apple"));
+}
+
+TEST_F(NameConditionTest, MatchesDirectoriesAndDescribesItself) {
+    FileMetadata metadata;
+    metadata.type = ItemType::Directory;
+    const NameCondition condition("2024-*", true);
+    EXPECT_TRUE(condition.evaluate(ItemRepresentation(std::filesystem::path("2024-trip"), metadata), context));
+    EXPECT_EQ(condition.requiredAttributes(), ItemAttribute::None);
+    EXPECT_EQ(condition.requiredNamePattern()->glob, "2024-*");
+    EXPECT_TRUE(condition.requiredNamePattern()->ignoreCase);
+    EXPECT_EQ(condition.describe(), "Name matches '2024-*' (ignoring case)");
+}
+
+TEST_F(NameConditionTest, BatchesMatchLikeSingleItems) {
+    const NameCondition condition("*.[ch]", true);
+    const std::vector<std::string> names = {"main.c", "util.H", "notes.txt", "c", "lib.cc"};
+    std::vector<ItemRepresentation> items;
+    for (size_t i = 0; i < 70; ++i) {
+        items.emplace_back(std::filesystem::path("dir") / names[i % names.size()]);
+    }
+    ItemBatch batch;
+    for (const auto& item : items) {
+        batch.add(item);
+    }
+    
+    auto mask = batch.makeFullMask();
+    mask[0] &= ~std::uint64_t{1};  // items already ruled out stay out
+    condition.evaluateBatch(batch, context, mask);
+    for (size_t i = 0; i < items.size(); ++i) {
+        EXPECT_EQ((mask[i / 64] >> (i % 64)) & 1, i != 0 && condition.evaluate(items[i], context)) << i;
+    }
+}
+
+TEST(GlobAutomatonTest, OnePassFindsEveryMatchingPattern) {
+    const std::vector<std::string> patterns = {"*.txt", "notes*", "*", "n?tes.*", "[!n]*", "*.TXT"};
+    GlobAutomaton automaton;
+    for (const auto& pattern : patterns) {
+        automaton.addPattern(pattern);
+    }
+    automaton.compile();
+
+    const auto matches = automaton.match("notes.txt");
+    EXPECT_TRUE(matches.contains(0));
+    EXPECT_TRUE(matches.contains(1));
+    EXPECT_TRUE(matches.contains(2));
+    EXPECT_TRUE(matches.contains(3));
+    EXPECT_FALSE(matches.contains(4));
+    EXPECT_FALSE(matches.contains(5));
+}
+
+TEST(GlobAutomatonTest, SameMatchesPastTheStateLimit) {
+    // starred patterns whose combinations need many states, more than 64 patterns so that
+    // the matches take several words
+    std::vector<std::string> patterns;
+    for (char c = 'a'; c <= 'z'; ++c) {
+        patterns.push_back(std::string("*") + c + "*");
+        patterns.push_back(std::string("*") + c + "?" + c + "*");
+        patterns.push_back(std::string("[") + c + "-z]*");
+    }
+    GlobAutomaton full;
+    GlobAutomaton limited(8);
+    for (size_t i = 0; i < patterns.size(); ++i) {
+        // mixed case sensitivity
+        EXPECT_EQ(full.addPattern(patterns[i], i % 2 == 1), i);
+        limited.addPattern(patterns[i], i % 2 == 1);
+    }
+    full.compile();
+    limited.compile();
+    EXPECT_EQ(limited.getStateCount(), 8);
+    EXPECT_GT(full.getStateCount(), limited.getStateCount());
+
+    for (const std::string name : {"", "abacus", "Zebra.TXT", "mississippi", "xyzzy", "q"}) {
+        const auto expected = full.match(name);
+        const auto actual = limited.match(name);
+        for (size_t i = 0; i < patterns.size(); ++i) {
+            // each pattern on its own agrees with the combined automata
+            GlobAutomaton single;
+            single.addPattern(patterns[i], i % 2 == 1);
+            single.compile();
+            EXPECT_EQ(expected.contains(i), single.matches(name, 0)) << patterns[i] << " " << name;
+            EXPECT_EQ(actual.contains(i), expected.contains(i)) << patterns[i] << " " << name;
+        }
+    }
+}
@@ -0,0 +1,183 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <map>
+#include "core/ParallelDirectoryWalker.h"
+#include "core/Logger.h"
+#include "models/FileMetadata.h"
+
+class ParallelDirectoryWalkerTest : public testing::Test {
+protected:
+    void SetUp() override {
+        testId = std::to_string(std::chrono::high_resolution_clock::now().time_since_epoch().count());
+        testDir = std::filesystem::temp_directory_path() / ("walker_test_" + testId);
+        std::filesystem::create_directories(testDir);
+        
+        // Initialize logger to quiet mode for tests
+        Logger::instance().init(LogLevel::ERROR);
+    }
+    
+    void TearDown() override {
+        std::filesystem::remove_all(testDir);
+        Logger::instance().reset();
+    }
+    
+    void createTestFile(const std::filesystem::path& path) {
+        std::filesystem::create_directories(path.parent_path());
+        std::ofstream(path) << "test content";
+    }
+    
+    std::set<std::filesystem::path> walkAll(ParallelDirectoryWalker& walker) {
+        std::set<std::filesystem::path> visited;
+        std::mutex visitedMutex;
+        walker.walk(testDir, [&](const ScanEntry& entry) {
+            std::lock_guard lock(visitedMutex);
+            visited.insert(entry.path());
+            return WalkAction::Continue;
+        });
+        return visited;
+    }
+    
+    std::string testId;
+    std::filesystem::path testDir;
+};
+
+TEST_F(ParallelDirectoryWalkerTest, VisitsSameEntriesAsRecursiveIterator) {
+    for (int dir = 0; dir < 8; ++dir) {
+        for (int file = 0; file < 5; ++file) {
+            createTestFile(testDir / ("dir" + std::to_string(dir)) / "nested" / ("file" + std::to_string(file) + ".txt"));
+        }
+    }
+    createTestFile(testDir / "top.pdf");
+    std::filesystem::create_directories(testDir / "empty");
+    
+    std::set<std::filesystem::path> expected;
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(testDir)) {
+        expected.insert(entry.path());
+    }
+    
+    ParallelDirectoryWalker walker(4);
+    EXPECT_EQ(walker.getWorkerCount(), 4);
+    EXPECT_EQ(walkAll(walker), expected);
+    
+    const auto& stats = walker.getStatistics();
+    EXPECT_EQ(stats.entriesVisited, expected.size());
+    EXPECT_EQ(stats.directoriesScanned, 18);  // root + empty + 8 * (dirN + nested)
+    EXPECT_EQ(stats.errors, 0);
+}
+
+TEST_F(ParallelDirectoryWalkerTest, SingleWorker) {
+    createTestFile(testDir / "a/b/c/deep.txt");
+    
+    ParallelDirectoryWalker walker(1);
+    const auto visited = walkAll(walker);
+    
+    EXPECT_EQ(visited.size(), 4);
+    EXPECT_TRUE(visited.contains(testDir / "a/b/c/deep.txt"));
+    EXPECT_EQ(walker.getStatistics().steals, 0);
+}
+
+TEST_F(ParallelDirectoryWalkerTest, DoesNotFollowDirectorySymlinks) {
+    createTestFile(testDir / "real/file.txt");
+    std::filesystem::create_directory_symlink(testDir / "real", testDir / "link");
+    
+    ParallelDirectoryWalker walker(2);
+    const auto visited = walkAll(walker);
+    
+    // the link itself is reported, its contents are not
+    EXPECT_TRUE(visited.contains(testDir / "link"));
+    EXPECT_FALSE(visited.contains(testDir / "link/file.txt"));
+    EXPECT_TRUE(visited.contains(testDir / "real/file.txt"));
+}
+
+TEST_F(ParallelDirectoryWalkerTest, MissingRootIsNotAnError) {
+    ParallelDirectoryWalker walker(2);
+    std::size_t count = 0;
+    walker.walk(testDir / "missing", [&](const ScanEntry&) {
+        ++count;
+        return WalkAction::Continue;
+    });
+    
+    EXPECT_EQ(count, 0);
+    EXPECT_EQ(walker.getStatistics().directoriesScanned, 0);
+    EXPECT_EQ(walker.getStatistics().errors, 0);
+}
+
+TEST_F(ParallelDirectoryWalkerTest, ReusableAcrossWalks) {
+    createTestFile(testDir / "one.txt");
+    ParallelDirectoryWalker walker(3);
+    EXPECT_EQ(walkAll(walker).size(), 1);
+    
+    createTestFile(testDir / "two.txt");
+    EXPECT_EQ(walkAll(walker).size(), 2);
+    EXPECT_EQ(walker.getStatistics().entriesVisited, 2);
+}
+
+TEST_F(ParallelDirectoryWalkerTest, ReportsDirentTypes) {
+    createTestFile(testDir / "file.txt");
+    std::filesystem::create_directories(testDir / "subdir");
+    std::filesystem::create_symlink(testDir / "file.txt", testDir / "link.txt");
+    
+    std::map<std::string, std::optional<ItemType>> types;
+    std::mutex typesMutex;
+    ParallelDirectoryWalker walker(2);
+    walker.walk(testDir, [&](const ScanEntry& entry) {
+        std::lock_guard lock(typesMutex);
+        types[entry.name] = entry.type;
+        return WalkAction::Continue;
+    });
+    
+    ASSERT_EQ(types.size(), 3);
+    EXPECT_EQ(types["file.txt"], ItemType::File);
+    EXPECT_EQ(types["subdir"], ItemType::Directory);
+    // symlinks are resolved later with a stat
+    EXPECT_EQ(types["link.txt"], std::nullopt);
+}
+
+TEST_F(ParallelDirectoryWalkerTest, SkipSubtreePrunesDirectory) {
+    createTestFile(testDir / "keep/file.txt");
+    createTestFile(testDir / "prune/file.txt");
+    createTestFile(testDir / "prune/deeper/file.txt");
+    
+    std::set<std::filesystem::path> visited;
+    std::mutex visitedMutex;
+    ParallelDirectoryWalker walker(2);
+    walker.walk(testDir, [&](const ScanEntry& entry) {
+        std::lock_guard lock(visitedMutex);
+        visited.insert(entry.path());
+        return entry.name == "prune" ? WalkAction::SkipSubtree : WalkAction::Continue;
+    });
+    
+    // the pruned directory itself is still reported
+    EXPECT_TRUE(visited.contains(testDir / "prune"));
+    EXPECT_FALSE(visited.contains(testDir / "prune/file.txt"));
+    EXPECT_TRUE(visited.contains(testDir / "keep/file.txt"));
+    EXPECT_EQ(walker.getStatistics().subtreesSkipped, 1);
+    EXPECT_EQ(walker.getStatistics().directoriesScanned, 2);
+}
+
+TEST_F(ParallelDirectoryWalkerTest, EntriesAreNamedRelativeToTheirOpenDirectory) {
+    createTestFile(testDir / "a/b/file.txt");
+    
+    std::map<std::string, std::filesystem::path> directories;
+    std::mutex directoriesMutex;
+    ParallelDirectoryWalker walker(2);
+    walker.walk(testDir, [&](const ScanEntry& entry) {
+        std::lock_guard lock(directoriesMutex);
+        EXPECT_TRUE(entry.directory);
+#if defined(__unix__) || defined(__APPLE__)
+        // the handle is still open while the visitor runs, so *at() calls work on the name
+        EXPECT_TRUE(readFileMetadataAt(entry.directory->getFd(), entry.name.c_str()));
+#endif
+        directories[entry.name] = entry.directory->getPath();
+        return WalkAction::Continue;
+    });
+    
+    ASSERT_EQ(directories.size(), 3);
+    EXPECT_EQ(directories["a"], testDir);
+    EXPECT_EQ(directories["b"], testDir / "a");
+    EXPECT_EQ(directories["file.txt"], testDir / "a/b");
+}
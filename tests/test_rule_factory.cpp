@@ -14,6 +14,7 @@ protected:
     }
     
     std::unique_ptr<RuleFactory> factory;
+    EvaluationContext context;
 };
 
 TEST_F(RuleFactoryTest, RegisterAndCreateExtensionCondition) {
@@ -25,8 +26,8 @@ TEST_F(RuleFactoryTest, RegisterAndCreateExtensionCondition) {
     ItemRepresentation pdfItem(std::filesystem::path("test.pdf"));
     ItemRepresentation txtItem(std::filesystem::path("test.txt"));
     
-    EXPECT_TRUE(condition->evaluate(pdfItem));
-    EXPECT_FALSE(condition->evaluate(txtItem));
+    EXPECT_TRUE(condition->evaluate(pdfItem, context));
+    EXPECT_FALSE(condition->evaluate(txtItem, context));
 }
 
 TEST_F(RuleFactoryTest, ExtensionNormalization) {
@@ -43,12 +44,12 @@ TEST_F(RuleFactoryTest, ExtensionNormalization) {
     ItemRepresentation PDFItem(std::filesystem::path("test.PDF"));
     
     // All should match regardless of case or dot prefix
-    EXPECT_TRUE(condition1->evaluate(pdfItem));
-    EXPECT_TRUE(condition1->evaluate(PDFItem));
-    EXPECT_TRUE(condition2->evaluate(pdfItem));
-    EXPECT_TRUE(condition2->evaluate(PDFItem));
-    EXPECT_TRUE(condition3->evaluate(pdfItem));
-    EXPECT_TRUE(condition3->evaluate(PDFItem));
+    EXPECT_TRUE(condition1->evaluate(pdfItem, context));
+    EXPECT_TRUE(condition1->evaluate(PDFItem, context));
+    EXPECT_TRUE(condition2->evaluate(pdfItem, context));
+    EXPECT_TRUE(condition2->evaluate(PDFItem, context));
+    EXPECT_TRUE(condition3->evaluate(pdfItem, context));
+    EXPECT_TRUE(condition3->evaluate(PDFItem, context));
 }
 
 TEST_F(RuleFactoryTest, UnknownConditionType) {
@@ -76,8 +77,8 @@ TEST_F(RuleFactoryTest, CreateRuleFromConfig) {
     ItemRepresentation pdfItem(std::filesystem::path("test.pdf"));
     ItemRepresentation txtItem(std::filesystem::path("test.txt"));
     
-    EXPECT_TRUE(rule->matches(pdfItem));
-    EXPECT_FALSE(rule->matches(txtItem));
+    EXPECT_TRUE(rule->matches(pdfItem, context));
+    EXPECT_FALSE(rule->matches(txtItem, context));
 }
 
 TEST_F(RuleFactoryTest, CreateRuleWithMultipleConditions) {
@@ -111,7 +112,7 @@ TEST_F(RuleFactoryTest, CreateRuleWithInvalidCondition) {
     
     // Rule should be created but only with valid conditions
     ItemRepresentation txtItem(std::filesystem::path("test.txt"));
-    EXPECT_TRUE(rule->matches(txtItem));
+    EXPECT_TRUE(rule->matches(txtItem, context));
 }
 
 TEST_F(RuleFactoryTest, CreateRulesFromConfigurationParser) {
@@ -183,9 +184,11 @@ TEST_F(RuleFactoryTest, GetRegisteredConditionTypes) {
     EXPECT_TRUE(std::ranges::find(types, "SIZE_LESS_THAN") != types.end());
     EXPECT_TRUE(std::ranges::find(types, "AGE_OLDER_THAN") != types.end());
     EXPECT_TRUE(std::ranges::find(types, "AGE_NEWER_THAN") != types.end());
+    EXPECT_TRUE(std::ranges::find(types, "NAME_MATCHES") != types.end());
+    EXPECT_TRUE(std::ranges::find(types, "NAME_MATCHES_NOCASE") != types.end());
     
     // Should have all default registered conditions
-    EXPECT_EQ(types.size(), 5);
+    EXPECT_EQ(types.size(), 7);
 }
 
 TEST_F(RuleFactoryTest, CustomConditionRegistration) {
@@ -221,5 +224,22 @@ TEST_F(RuleFactoryTest, EmptyConditionsRule) {
     
     // Should match any file since there are no conditions
     ItemRepresentation anyItem(std::filesystem::path("anything.xyz"));
-    EXPECT_TRUE(rule->matches(anyItem));
-} 
\ No newline at end of file
+    EXPECT_TRUE(rule->matches(anyItem, context));
+}
+
+TEST_F(RuleFactoryTest, CustomConditionTypeReplacesBuiltinOne) {
+    // only accept ".txt", whatever the configured extension is
+    factory->registerConditionType("EXTENSION", [](const std::string&) -> std::unique_ptr<ICondition> {
+        return std::make_unique<ExtensionCondition>(".txt");
+    });
+    EXPECT_EQ(factory->getRegisteredConditionTypes().size(), 7);
+    
+    RuleConfig config;
+    config.targetPath = "docs";
+    config.priority = 1;
+    config.conditions = {{"EXTENSION", ".pdf"}};
+    auto rule = factory->createRule(config);
+    
+    EXPECT_TRUE(rule->matches(ItemRepresentation(std::filesystem::path("notes.txt")), context));
+    EXPECT_FALSE(rule->matches(ItemRepresentation(std::filesystem::path("notes.pdf")), context));
+}
@@ -0,0 +1,274 @@
+#include <gtest/gtest.h>
+#include "rules/RuleIndex.h"
+#include "rules/ConfigurableRule.h"
+#include "conditions/ExtensionCondition.h"
+#include "conditions/SizeCondition.h"
+#include "conditions/AgeCondition.h"
+#include "conditions/NameCondition.h"
+#include "models/ItemRepresentation.h"
+#include "models/ItemBatch.h"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <vector>
+
+// Accepts the files with one extension and counts the batches it is asked about
+class CountingExtensionRule : public ISortingRule {
+public:
+    explicit CountingExtensionRule(const std::string& extension) : condition(extension) {}
+    
+    bool matches(const ItemRepresentation& item, const EvaluationContext& context) const override {
+        return condition.evaluate(item, context);
+    }
+    void matchBatch(const ItemBatch& batch, const EvaluationContext& context, std::span<std::uint64_t> mask) const override {
+        ++batchCalls;
+        condition.evaluateBatch(batch, context, mask);
+    }
+    std::filesystem::path getTargetRelativePath() const override { return condition.getExtension().substr(1); }
+    int getPriority() const override { return 0; }
+    std::string describe() const override { return "Counting " + condition.describe(); }
+    ItemAttribute requiredAttributes() const override { return condition.requiredAttributes(); }
+    std::optional<std::string> requiredExtension() const override { return condition.requiredExtension(); }
+    
+    mutable size_t batchCalls = 0;
+    
+private:
+    ExtensionCondition condition;
+};
+
+// Accepts the names matching one glob and counts the calls that check the name itself
+class CountingNameRule : public ISortingRule {
+public:
+    explicit CountingNameRule(const std::string& glob) : condition(glob) {}
+    
+    bool matches(const ItemRepresentation& item, const EvaluationContext& context) const override {
+        ++nameChecks;
+        return condition.evaluate(item, context);
+    }
+    void matchBatch(const ItemBatch& batch, const EvaluationContext& context, std::span<std::uint64_t> mask) const override {
+        ++nameChecks;
+        condition.evaluateBatch(batch, context, mask);
+    }
+    bool matchesCheckedName(const ItemRepresentation&, const EvaluationContext&) const override { return true; }
+    void matchBatchCheckedNames(const ItemBatch&, const EvaluationContext&, std::span<std::uint64_t>) const override {}
+    std::filesystem::path getTargetRelativePath() const override { return "named"; }
+    int getPriority() const override { return 0; }
+    std::string describe() const override { return "Counting " + condition.describe(); }
+    ItemAttribute requiredAttributes() const override { return condition.requiredAttributes(); }
+    std::vector<GlobPattern> requiredNamePatterns() const override { return {*condition.requiredNamePattern()}; }
+    
+    mutable size_t nameChecks = 0;
+    
+private:
+    NameCondition condition;
+};
+
+class RuleIndexTest : public testing::Test {
+protected:
+    void SetUp() override {
+        testDir = std::filesystem::temp_directory_path() / "rule_index_test";
+        std::filesystem::create_directories(testDir / "folder.d");
+    }
+    
+    void TearDown() override {
+        std::filesystem::remove_all(testDir);
+    }
+    
+    ItemRepresentation makeFile(const std::string& name, const size_t size) {
+        std::ofstream(testDir / name) << std::string(size, 'x');
+        return ItemRepresentation(testDir / name);
+    }
+    
+    ConfigurableRule* addRule(const std::string& target, const int priority) {
+        rules.push_back(std::make_unique<ConfigurableRule>(target, priority));
+        return static_cast<ConfigurableRule*>(rules.back().get());
+    }
+    
+    static ISortingRule* linearMatch(const std::vector<std::unique_ptr<ISortingRule>>& rules,
+                                     const ItemRepresentation& item, const EvaluationContext& context) {
+        for (const auto& rule : rules) {
+            if (rule->matches(item, context)) {
+                return rule.get();
+            }
+        }
+        return nullptr;
+    }
+    
+    std::filesystem::path testDir;
+    std::vector<std::unique_ptr<ISortingRule>> rules;
+    EvaluationContext context;
+};
+
+TEST_F(RuleIndexTest, ExtensionRulesAreFiledUnderTheirExtension) {
+    addRule("text", 1)->addCondition(std::make_unique<ExtensionCondition>("TXT"));
+    addRule("bare", 2)->addCondition(std::make_unique<ExtensionCondition>("."));
+    addRule("large", 3)->addCondition(std::make_unique<SizeCondition>(SizeComparison::GreaterThan, 100));
+    
+    EXPECT_EQ(rules[0]->requiredExtension(), ".txt");
+    EXPECT_EQ(rules[1]->requiredExtension(), "");
+    EXPECT_EQ(rules[2]->requiredExtension(), std::nullopt);
+    
+    const RuleIndex index(rules);
+    EXPECT_EQ(index.getIndexedExtensionCount(), 2);
+    
+    // a .pdf can only match the size rule; a .txt gets its own rule before it
+    const auto pdf = makeFile("a.pdf", 1);
+    ASSERT_EQ(index.candidatesFor(pdf).size(), 1);
+    EXPECT_EQ(index.candidatesFor(pdf)[0], rules[2].get());
+    const auto txt = makeFile("a.Txt", 1);
+    ASSERT_EQ(index.candidatesFor(txt).size(), 2);
+    EXPECT_EQ(index.candidatesFor(txt)[0], rules[0].get());
+}
+
+TEST_F(RuleIndexTest, SameResultAsTryingEveryRuleInOrder) {
+    // extension and unrestricted rules interleaved by priority
+    addRule("large", 1)->addCondition(std::make_unique<SizeCondition>(SizeComparison::GreaterThan, 1000));
+    addRule("pdf", 2)->addCondition(std::make_unique<ExtensionCondition>(".pdf"));
+    auto* smallText = addRule("small-text", 3);
+    smallText->addCondition(std::make_unique<SizeCondition>(SizeComparison::LessThan, 10));
+    smallText->addCondition(std::make_unique<ExtensionCondition>(".txt"));
+    addRule("text", 4)->addCondition(std::make_unique<ExtensionCondition>(".txt"));
+    addRule("catch-all", 5);
+    
+    const RuleIndex index(rules);
+    const std::vector<ItemRepresentation> items = {
+        makeFile("big.pdf", 2000), makeFile("doc.PDF", 5), makeFile("tiny.txt", 1),
+        makeFile("notes.txt", 50), makeFile("huge.txt", 5000), makeFile("image.png", 5),
+        makeFile("README", 5), ItemRepresentation(testDir / "folder.d"),
+    };
+    for (const auto& item : items) {
+        EXPECT_EQ(index.findMatchingRule(item, context), linearMatch(rules, item, context)) << item.getName();
+    }
+    EXPECT_EQ(index.findMatchingRule(items[3], context)->getTargetRelativePath(), "text");
+    // directories never match an extension rule
+    EXPECT_EQ(index.findMatchingRule(items.back(), context)->getTargetRelativePath(), "catch-all");
+}
+
+TEST_F(RuleIndexTest, NoRulesMatchNothing) {
+    const RuleIndex index(rules);
+    EXPECT_EQ(index.findMatchingRule(makeFile("a.txt", 1), context), nullptr);
+}
+
+TEST_F(RuleIndexTest, BatchMatchingPicksTheSameRules) {
+    addRule("large", 1)->addCondition(std::make_unique<SizeCondition>(SizeComparison::GreaterThan, 1000));
+    addRule("pdf", 2)->addCondition(std::make_unique<ExtensionCondition>(".pdf"));
+    auto* smallText = addRule("small-text", 3);
+    smallText->addCondition(std::make_unique<SizeCondition>(SizeComparison::LessThan, 10));
+    smallText->addCondition(std::make_unique<ExtensionCondition>(".txt"));
+    addRule("old", 4)->addCondition(std::make_unique<AgeCondition>(AgeComparison::OlderThan, std::chrono::hours(24)));
+    
+    // more than one mask word, with items no rule matches
+    const auto now = std::filesystem::file_time_type::clock::now();
+    const std::vector<std::string> names = {"a.pdf", "b.TXT", "c.txt", "d.png", "e", "f.d"};
+    std::vector<ItemRepresentation> items;
+    for (size_t i = 0; i < 150; ++i) {
+        FileMetadata metadata;
+        metadata.type = i % 6 == 5 ? ItemType::Directory : ItemType::File;
+        metadata.sizeInBytes = (i * 37) % 1500;
+        metadata.lastModified = now - std::chrono::hours(i % 48);
+        items.emplace_back(testDir / names[i % names.size()], metadata);
+    }
+    ItemBatch batch;
+    for (const auto& item : items) {
+        batch.add(item);
+    }
+    
+    const RuleIndex index(rules);
+    std::vector<ISortingRule*> matches(items.size());
+    index.findMatchingRules(batch, context, matches);
+    for (size_t i = 0; i < items.size(); ++i) {
+        EXPECT_EQ(matches[i], linearMatch(rules, items[i], context)) << i;
+    }
+    EXPECT_TRUE(std::ranges::find(matches, nullptr) != matches.end());
+}
+
+TEST_F(RuleIndexTest, NamePatternRulesMatchLikeTryingEveryRule) {
+    addRule("reports", 1)->addCondition(std::make_unique<NameCondition>("report-*.pdf"));
+    auto* largeLogs = addRule("large-logs", 2);
+    largeLogs->addCondition(std::make_unique<NameCondition>("*.log", true));
+    largeLogs->addCondition(std::make_unique<SizeCondition>(SizeComparison::GreaterThan, 100));
+    addRule("pdf", 3)->addCondition(std::make_unique<ExtensionCondition>(".pdf"));
+    addRule("dotfiles", 4)->addCondition(std::make_unique<NameCondition>(".*"));
+    // a name has to match both patterns of the rule
+    auto* numberedText = addRule("numbered-text", 5);
+    numberedText->addCondition(std::make_unique<NameCondition>("[0-9]*"));
+    numberedText->addCondition(std::make_unique<NameCondition>("*.txt"));
+    addRule("numbered", 6)->addCondition(std::make_unique<NameCondition>("[0-9]?*"));
+    
+    const RuleIndex index(rules);
+    EXPECT_EQ(index.getNamePatternCount(), 6);
+    EXPECT_TRUE(rules[2]->requiredNamePatterns().empty());
+    EXPECT_EQ(rules[4]->requiredNamePatterns().size(), 2);
+    
+    const std::vector<ItemRepresentation> items = {
+        makeFile("report-2024.pdf", 5), makeFile("Report-2024.pdf", 5), makeFile("app.LOG", 500),
+        makeFile("small.log", 5), makeFile(".profile", 5), makeFile("1st.txt", 5), makeFile("7", 5),
+        ItemRepresentation(testDir / "folder.d"),
+    };
+    ItemBatch batch;
+    for (const auto& item : items) {
+        EXPECT_EQ(index.findMatchingRule(item, context), linearMatch(rules, item, context)) << item.getName();
+        batch.add(item);
+    }
+    std::vector<ISortingRule*> matches(items.size());
+    index.findMatchingRules(batch, context, matches);
+    for (size_t i = 0; i < items.size(); ++i) {
+        EXPECT_EQ(matches[i], linearMatch(rules, items[i], context)) << items[i].getName();
+    }
+    EXPECT_EQ(index.findMatchingRule(items[1], context)->getTargetRelativePath(), "pdf");
+    EXPECT_EQ(index.findMatchingRule(items[2], context)->getTargetRelativePath(), "large-logs");
+    EXPECT_EQ(index.findMatchingRule(items[3], context), nullptr);
+    EXPECT_EQ(index.findMatchingRule(items[5], context)->getTargetRelativePath(), "numbered-text");
+    EXPECT_EQ(index.findMatchingRule(items[6], context), nullptr);  // only one of the two patterns
+}
+
+TEST_F(RuleIndexTest, NamesAreOnlyMatchedByTheIndex) {
+    rules.push_back(std::make_unique<CountingNameRule>("*.log"));
+    const auto& rule = static_cast<const CountingNameRule&>(*rules.back());
+    const std::vector<ItemRepresentation> items = {makeFile("app.log", 5), makeFile("notes.txt", 5)};
+    ItemBatch batch;
+    for (const auto& item : items) {
+        batch.add(item);
+    }
+    
+    const RuleIndex index(rules);
+    EXPECT_EQ(index.findMatchingRule(items[0], context), &rule);
+    EXPECT_EQ(index.findMatchingRule(items[1], context), nullptr);
+    std::vector<ISortingRule*> matches(items.size());
+    index.findMatchingRules(batch, context, matches);
+    EXPECT_EQ(matches[0], &rule);
+    EXPECT_EQ(matches[1], nullptr);
+    EXPECT_EQ(rule.nameChecks, 0);
+}
+
+TEST_F(RuleIndexTest, BatchMatchingOnlyRunsRulesForExtensionsInTheBatch) {
+    for (int i = 0; i < 20; ++i) {
+        rules.push_back(std::make_unique<CountingExtensionRule>(".e" + std::to_string(i)));
+    }
+    addRule("large", 30)->addCondition(std::make_unique<SizeCondition>(SizeComparison::GreaterThan, 100));
+    
+    const std::vector<std::string> names = {"a.e3", "b.E3", "c.txt", "d.e30"};
+    std::vector<ItemRepresentation> items;
+    for (size_t i = 0; i < 100; ++i) {
+        FileMetadata metadata;
+        metadata.type = ItemType::File;
+        metadata.sizeInBytes = i * 3;
+        items.emplace_back(testDir / names[i % names.size()], metadata);
+    }
+    ItemBatch batch;
+    for (const auto& item : items) {
+        batch.add(item);
+    }
+    
+    const RuleIndex index(rules);
+    std::vector<ISortingRule*> matches(items.size());
+    index.findMatchingRules(batch, context, matches);
+    for (size_t i = 0; i < items.size(); ++i) {
+        EXPECT_EQ(matches[i], linearMatch(rules, items[i], context)) << i;
+    }
+    for (size_t i = 0; i < 20; ++i) {
+        EXPECT_EQ(static_cast<const CountingExtensionRule&>(*rules[i]).batchCalls, i == 3 ? 1 : 0) << i;
+    }
+}
@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <chrono>
+#include "core/ScanIndex.h"
+#include "core/Logger.h"
+
+class ScanIndexTest : public testing::Test {
+protected:
+    void SetUp() override {
+        testId = std::to_string(std::chrono::high_resolution_clock::now().time_since_epoch().count());
+        testDir = std::filesystem::temp_directory_path() / ("scan_index_test_" + testId);
+        std::filesystem::create_directories(testDir / "tree/sub");
+        indexFile = testDir / "scan.index";
+        Logger::instance().init(LogLevel::ERROR);
+    }
+    
+    void TearDown() override {
+        std::filesystem::remove_all(testDir);
+        Logger::instance().reset();
+    }
+    
+    FileMetadata metadataOf(const std::filesystem::path& path) {
+        auto metadata = readFileMetadata(path);
+        EXPECT_TRUE(metadata.has_value());
+        return metadata.value_or(FileMetadata{});
+    }
+    
+    std::string testId;
+    std::filesystem::path testDir;
+    std::filesystem::path indexFile;
+};
+
+TEST_F(ScanIndexTest, MissingIndexLoadsNothing) {
+    ScanIndex index(indexFile, 1);
+    EXPECT_FALSE(index.load());
+    EXPECT_EQ(index.getPreviousSize(), 0);
+    EXPECT_FALSE(index.beginDirectory(".", metadataOf(testDir / "tree")).has_value());
+}
+
+TEST_F(ScanIndexTest, UnchangedDirectoryIsReusedAfterSave) {
+    {
+        ScanIndex index(indexFile, 42);
+        index.beginDirectory(".", metadataOf(testDir / "tree"));
+        index.completeDirectory(".", {"sub"});
+        EXPECT_EQ(index.getRecordedSize(), 1);
+        EXPECT_TRUE(index.save());
+    }
+    
+    ScanIndex index(indexFile, 42);
+    ASSERT_TRUE(index.load());
+    const auto subdirectories = index.beginDirectory(".", metadataOf(testDir / "tree"));
+    ASSERT_TRUE(subdirectories.has_value());
+    EXPECT_EQ(*subdirectories, std::vector<std::string>{"sub"});
+    
+    // reused records are carried over to the next save
+    EXPECT_EQ(index.getRecordedSize(), 1);
+}
+
+TEST_F(ScanIndexTest, ModifiedDirectoryIsListedAgain) {
+    {
+        ScanIndex index(indexFile, 42);
+        index.beginDirectory(".", metadataOf(testDir / "tree"));
+        index.completeDirectory(".", {"sub"});
+        index.save();
+    }
+    
+    std::ofstream(testDir / "tree/new.txt") << "new";
+    
+    ScanIndex index(indexFile, 42);
+    ASSERT_TRUE(index.load());
+    EXPECT_FALSE(index.beginDirectory(".", metadataOf(testDir / "tree")).has_value());
+}
+
+TEST_F(ScanIndexTest, DifferentFingerprintIsIgnored) {
+    {
+        ScanIndex index(indexFile, 42);
+        index.beginDirectory(".", metadataOf(testDir / "tree"));
+        index.completeDirectory(".", {});
+        index.save();
+    }
+    
+    ScanIndex index(indexFile, 43);
+    EXPECT_FALSE(index.load());
+    EXPECT_FALSE(index.beginDirectory(".", metadataOf(testDir / "tree")).has_value());
+}
+
+TEST_F(ScanIndexTest, InvalidatedAndIncompleteDirectoriesAreNotSaved) {
+    ScanIndex index(indexFile, 42);
+    index.beginDirectory(".", metadataOf(testDir / "tree"));
+    index.completeDirectory(".", {"sub"});
+    index.invalidate(".");
+    index.beginDirectory("sub", metadataOf(testDir / "tree/sub"));  // listing never completed
+    EXPECT_EQ(index.getRecordedSize(), 0);
+    EXPECT_TRUE(index.save());
+    
+    ScanIndex reloaded(indexFile, 42);
+    EXPECT_TRUE(reloaded.load());
+    EXPECT_EQ(reloaded.getPreviousSize(), 0);
+}
+
+TEST_F(ScanIndexTest, CorruptIndexIsIgnored) {
+    std::ofstream(indexFile, std::ios::binary) << "FOSI garbage";
+    ScanIndex index(indexFile, 42);
+    EXPECT_FALSE(index.load());
+    EXPECT_EQ(index.getPreviousSize(), 0);
+}
+
+TEST(ScanIndexHashTest, HashIsStableAndChained) {
+    EXPECT_EQ(ScanIndex::hash(""), 14695981039346656037ull);
+    EXPECT_EQ(ScanIndex::hash("abc"), ScanIndex::hash("abc"));
+    EXPECT_NE(ScanIndex::hash("abc"), ScanIndex::hash("abd"));
+    EXPECT_EQ(ScanIndex::hash("c", ScanIndex::hash("ab")), ScanIndex::hash("abc"));
+}
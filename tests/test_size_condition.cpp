@@ -40,6 +40,7 @@ protected:
     std::filesystem::path testDir;
     std::filesystem::path smallFile;
     std::filesystem::path largeFile;
+    EvaluationContext context;
 };
 
 TEST_F(SizeConditionTest, ConstructorAndGetters) {
@@ -56,10 +57,10 @@ TEST_F(SizeConditionTest, GreaterThanCondition) {
     ItemRepresentation largeItem(largeFile);
     
     // small file (100 bytes) should not match
-    EXPECT_FALSE(condition.evaluate(smallItem));
+    EXPECT_FALSE(condition.evaluate(smallItem, context));
     
     // large file (2KB) should match
-    EXPECT_TRUE(condition.evaluate(largeItem));
+    EXPECT_TRUE(condition.evaluate(largeItem, context));
 }
 
 TEST_F(SizeConditionTest, LessThanCondition) {
@@ -69,10 +70,10 @@ TEST_F(SizeConditionTest, LessThanCondition) {
     ItemRepresentation largeItem(largeFile);
     
     // small file (100 bytes) should match
-    EXPECT_TRUE(condition.evaluate(smallItem));
+    EXPECT_TRUE(condition.evaluate(smallItem, context));
     
     // large file (2KB) should not match
-    EXPECT_FALSE(condition.evaluate(largeItem));
+    EXPECT_FALSE(condition.evaluate(largeItem, context));
 }
 
 TEST_F(SizeConditionTest, DirectoryHandling) {
@@ -81,7 +82,7 @@ TEST_F(SizeConditionTest, DirectoryHandling) {
     ItemRepresentation dirItem(testDir);
     
     // directories should never match size conditions
-    EXPECT_FALSE(condition.evaluate(dirItem));
+    EXPECT_FALSE(condition.evaluate(dirItem, context));
 }
 
 TEST_F(SizeConditionTest, TemplateSetThreshold) {
@@ -117,9 +118,9 @@ TEST_F(SizeConditionTest, EdgeCases) {
     // test with zero threshold
     SizeCondition zeroCondition(SizeComparison::GreaterThan, 0);
     ItemRepresentation smallItem(smallFile);
-    EXPECT_TRUE(zeroCondition.evaluate(smallItem)); // any file > 0 bytes
+    EXPECT_TRUE(zeroCondition.evaluate(smallItem, context)); // any file > 0 bytes
     
     // test with very large threshold
     SizeCondition largeCondition(SizeComparison::LessThan, std::numeric_limits<std::uintmax_t>::max());
-    EXPECT_TRUE(largeCondition.evaluate(smallItem)); // any file < max size
+    EXPECT_TRUE(largeCondition.evaluate(smallItem, context)); // any file < max size
 } 
\ No newline at end of file
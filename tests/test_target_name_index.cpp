@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <chrono>
+#include <set>
+#include <thread>
+#include <vector>
+#include "core/TargetNameIndex.h"
+#include "core/Logger.h"
+
+class TargetNameIndexTest : public testing::Test {
+protected:
+    void SetUp() override {
+        testId = std::to_string(std::chrono::high_resolution_clock::now().time_since_epoch().count());
+        testDir = std::filesystem::temp_directory_path() / ("target_name_index_test_" + testId);
+        std::filesystem::create_directories(testDir);
+        Logger::instance().init(LogLevel::ERROR);
+    }
+    
+    void TearDown() override {
+        std::filesystem::remove_all(testDir);
+        Logger::instance().reset();
+    }
+    
+    void touch(const std::string& name) {
+        std::ofstream(testDir / name) << "x";
+    }
+    
+    std::string testId;
+    std::filesystem::path testDir;
+};
+
+TEST_F(TargetNameIndexTest, HandsOutSuffixesInOrder) {
+    touch("report.pdf");
+    TargetNameIndex index;
+    
+    EXPECT_EQ(index.reserveUniqueTarget(testDir / "report.pdf"), testDir / "report_001.pdf");
+    EXPECT_EQ(index.reserveUniqueTarget(testDir / "report.pdf"), testDir / "report_002.pdf");
+    EXPECT_EQ(index.reserveUniqueTarget(testDir / "notes.txt"), testDir / "notes_001.txt");
+    EXPECT_EQ(index.getIndexedDirectoryCount(), 1);
+}
+
+TEST_F(TargetNameIndexTest, SkipsNamesAlreadyInTheDirectory) {
+    touch("photo.jpg");
+    touch("photo_001.jpg");
+    touch("photo_002.jpg");
+    TargetNameIndex index;
+    
+    EXPECT_EQ(index.reserveUniqueTarget(testDir / "photo.jpg"), testDir / "photo_003.jpg");
+}
+
+TEST_F(TargetNameIndexTest, SkipsNamesCreatedAfterListing) {
+    touch("a.txt");
+    TargetNameIndex index;
+    EXPECT_EQ(index.reserveUniqueTarget(testDir / "a.txt"), testDir / "a_001.txt");
+    
+    // another process took the next name behind the index's back
+    touch("a_002.txt");
+    EXPECT_EQ(index.reserveUniqueTarget(testDir / "a.txt"), testDir / "a_003.txt");
+}
+
+TEST_F(TargetNameIndexTest, RecordedNamesAreAvoided) {
+    touch("b.txt");
+    TargetNameIndex index;
+    EXPECT_EQ(index.reserveUniqueTarget(testDir / "b.txt"), testDir / "b_001.txt");
+    
+    index.recordName(testDir, "b_002.txt");
+    EXPECT_EQ(index.reserveUniqueTarget(testDir / "b.txt"), testDir / "b_003.txt");
+}
+
+TEST_F(TargetNameIndexTest, NoAttemptLimit) {
+    TargetNameIndex index;
+    std::filesystem::path last;
+    for (int i = 0; i < 1500; ++i) {
+        last = index.reserveUniqueTarget(testDir / "IMG_0001.jpg");
+    }
+    EXPECT_EQ(last, testDir / "IMG_0001_1500.jpg");
+}
+
+TEST_F(TargetNameIndexTest, ConcurrentReservationsAreUnique) {
+    // several directories, each listed by whichever thread gets there first
+    std::vector<std::filesystem::path> directories;
+    for (int i = 0; i < 4; ++i) {
+        directories.push_back(testDir / ("dir" + std::to_string(i)));
+        std::filesystem::create_directories(directories.back());
+        std::ofstream(directories.back() / "a.txt") << "x";
+        std::ofstream(directories.back() / "a_002.txt") << "x";
+    }
+    TargetNameIndex index;
+    std::vector<std::vector<std::filesystem::path>> reserved(8);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < reserved.size(); ++t) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < 50; ++i) {
+                reserved[t].push_back(index.reserveUniqueTarget(directories[(t + i) % directories.size()] / "a.txt"));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    
+    std::set<std::filesystem::path> unique;
+    for (const auto& paths : reserved) {
+        for (const auto& path : paths) {
+            EXPECT_NE(path.filename(), "a_002.txt");
+            unique.insert(path);
+        }
+    }
+    EXPECT_EQ(unique.size(), 8 * 50);
+    EXPECT_EQ(index.getIndexedDirectoryCount(), directories.size());
+}